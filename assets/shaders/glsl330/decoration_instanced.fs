@@ -0,0 +1,27 @@
+#version 330
+
+in vec3 fragNormal;
+flat in float fragFade;
+
+uniform vec4 colDiffuse;
+
+out vec4 finalColor;
+
+// Stesso retino 4x4 di impostor.fs: i pixel scartati qui li disegna l'impostor
+float Dither(vec2 p)
+{
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                      3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 i = ivec2(mod(p, 4.0));
+    return (bayer[i.x + i.y * 4] + 0.5) / 16.0;
+}
+
+void main()
+{
+    if (Dither(gl_FragCoord.xy) < fragFade) discard;
+
+    // Colore pieno come il disegno non instanziato; solo le facce in ombra
+    // leggermente più scure per leggere la forma
+    float shade = 0.85 + 0.15 * max(normalize(fragNormal).y, 0.0);
+    finalColor = vec4(colDiffuse.rgb * shade, colDiffuse.a);
+}
@@ -0,0 +1,21 @@
+#version 330
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in mat4 instanceTransform;
+
+uniform mat4 mvp;
+uniform vec3 viewPos;
+uniform vec2 fadeRange;    // inizio e fine della dissolvenza verso l'impostor
+
+out vec3 fragNormal;
+flat out float fragFade;
+
+void main()
+{
+    // Matrice per istanza calcolata quando la decorazione viene piazzata
+    fragNormal = normalize(mat3(instanceTransform) * vertexNormal);
+    // Dissolvenza sulla distanza in XZ dall'origine dell'istanza, come negli impostor
+    fragFade = smoothstep(fadeRange.x, fadeRange.y, distance(viewPos.xz, instanceTransform[3].xz));
+    gl_Position = mvp * instanceTransform * vec4(vertexPosition, 1.0);
+}
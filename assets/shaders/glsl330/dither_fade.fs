@@ -0,0 +1,25 @@
+#version 330
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform float fade;        // 0 = geometria piena, 1 = tutta all'impostor
+
+out vec4 finalColor;
+
+// Stesso retino 4x4 di impostor.fs: i pixel scartati qui li disegna l'impostor
+float Dither(vec2 p)
+{
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                      3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 i = ivec2(mod(p, 4.0));
+    return (bayer[i.x + i.y * 4] + 0.5) / 16.0;
+}
+
+void main()
+{
+    if (Dither(gl_FragCoord.xy) < fade) discard;
+    finalColor = texture(texture0, fragTexCoord) * colDiffuse * fragColor;
+}
@@ -0,0 +1,26 @@
+#version 330
+
+in vec2 fragCorner;
+in vec4 fragColor;
+in float fragThickness;
+flat in int fragShape;
+
+out vec4 finalColor;
+
+void main()
+{
+    float r = length(fragCorner);
+    float coverage = 1.0;
+
+    if (fragShape == 0) {
+        // Disco pieno con bordo morbido
+        coverage = 1.0 - smoothstep(0.85, 1.0, r);
+    } else if (fragShape == 1) {
+        // Corona sottile sul bordo del quad
+        float inner = 1.0 - fragThickness;
+        coverage = step(inner, r) * (1.0 - step(1.0, r));
+    }
+
+    if (coverage <= 0.0) discard;
+    finalColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
@@ -0,0 +1,182 @@
+#version 330
+
+// Un quad per particella: xy angolo del quad, z indice della particella
+in vec3 vertexPosition;
+// Parametri dell'emettitore: [0] posizione + size, [1] colore, [2] parametri del tipo
+in mat4 instanceTransform;
+
+uniform mat4 mvp;
+uniform float time;
+uniform int effectType;     // 0 monumento, 1 portale, 2 occhi del watcher
+uniform vec3 camRight;
+uniform vec3 camUp;
+
+out vec2 fragCorner;        // -1..1 sul quad
+out vec4 fragColor;
+out float fragThickness;    // anelli: spessore relativo al raggio
+flat out int fragShape;     // 0 punto, 1 anello orizzontale, 2 segmento
+
+const float DEG2RAD = 0.01745329;
+const float PI = 3.14159265;
+const float RING_WIDTH = 0.04;
+const float LINE_WIDTH = 0.04;
+
+vec2 corner;
+vec3 worldPos;
+
+void Hide()
+{
+    fragShape = 0;
+    fragColor = vec4(0.0);
+    worldPos = vec3(0.0);
+}
+
+// Sfera vista da lontano: disco rivolto alla camera
+void Dot(vec3 center, float radius, vec4 color)
+{
+    fragShape = 0;
+    fragColor = color;
+    worldPos = center + (camRight * corner.x + camUp * corner.y) * 2.0 * radius;
+}
+
+// Cerchio nel piano XZ (DrawCircle3D ruotato di 90° attorno a X)
+void Ring(vec3 center, float radius, vec4 color)
+{
+    float outer = radius + RING_WIDTH;
+    fragShape = 1;
+    fragColor = color;
+    fragThickness = RING_WIDTH / outer;
+    worldPos = center + vec3(corner.x, 0.0, corner.y) * 2.0 * outer;
+}
+
+// Linea come striscia larga LINE_WIDTH, di taglio verso la camera
+void Segment(vec3 a, vec3 b, vec4 color)
+{
+    vec3 dir = b - a;
+    vec3 side = cross(dir, cross(camRight, camUp));
+    side = (dot(side, side) > 1e-8) ? normalize(side) : camRight;
+    fragShape = 2;
+    fragColor = color;
+    worldPos = mix(a, b, corner.y + 0.5) + side * corner.x * LINE_WIDTH;
+}
+
+vec4 Rgba(float r, float g, float b, float a)
+{
+    return vec4(r, g, b, a) / 255.0;
+}
+
+// Come MonumentSystem::DrawMonumentEffects
+void Monument(int i, vec3 pos, float height, vec4 glow, float pulse, bool activated)
+{
+    if (i < 20) {
+        float count = activated ? 20.0 : 10.0;
+        if (float(i) >= count) { Hide(); return; }
+        float fi = float(i);
+        float angle = (time * 50.0 + fi * 360.0 / count) * DEG2RAD;
+        float radius = 2.0 + sin(time * 2.0 + fi) * 0.5;
+        vec3 p = pos + vec3(cos(angle) * radius, height * 0.5 + sin(time * 3.0 + fi) * 2.0, sin(angle) * radius);
+        Dot(p, 0.1, vec4(glow.rgb, glow.a * pulse * 0.6));
+    } else if (i < 26) {
+        if (!activated) { Hide(); return; }
+        float k = float(i - 20);
+        Ring(pos + vec3(0.0, k / 6.0 * height, 0.0), 0.6, vec4(glow.rgb, glow.a * pulse * 0.8));
+    } else if (i < 34) {
+        if (!activated) { Hide(); return; }
+        float k = float(i - 26);
+        float angle = (time * 30.0 + k * 45.0) * DEG2RAD;
+        float beamLength = 3.0 + sin(time * 2.0 + k) * 1.0;
+        vec3 start = pos + vec3(0.0, height, 0.0);
+        vec3 end = start + vec3(cos(angle) * beamLength, 2.0, sin(angle) * beamLength);
+        Segment(start, end, vec4(glow.rgb, glow.a * pulse * 0.4));
+    } else {
+        Dot(pos + vec3(0.0, height + 0.5, 0.0), 0.3, vec4(glow.rgb, glow.a * pulse));
+    }
+}
+
+// Come il vecchio DrawPortals, sezione per sezione
+void Portal(int i, vec3 pos, float radius, vec4 color)
+{
+    if (i < 8) {
+        // Bagliore esterno
+        float ring = float(i);
+        Ring(pos, radius * (1.0 + ring * 0.15), vec4(color.rgb, 100.0 / 255.0 * (1.0 - ring / 8.0)));
+    } else if (i < 9) {
+        // Disco principale
+        Ring(pos, radius, Rgba(50.0, 255.0, 100.0, 255.0));
+    } else if (i < 14) {
+        // Onde interne
+        float k = float(i - 9);
+        float waveOffset = time * 2.0 + k * 1.2;
+        float waveRadius = radius * (0.3 + sin(waveOffset) * 0.15 + k * 0.15);
+        Ring(pos, waveRadius, Rgba(100.0, 255.0, 150.0, 150.0 + sin(waveOffset * 2.0) * 100.0));
+    } else if (i < 64) {
+        // Spirale rotante
+        float t = float(i - 14) / 50.0;
+        float angle = t * PI * 4.0 + time * 2.0;
+        float spiralRadius = radius * (0.2 + t * 0.7);
+        vec3 p = pos + vec3(cos(angle) * spiralRadius, sin(time * 3.0 + t * 10.0) * 0.3, sin(angle) * spiralRadius);
+        Dot(p, 0.05, Rgba(150.0, 255.0, 200.0, 200.0 * (1.0 - t)));
+    } else if (i < 94) {
+        // Particelle sul bordo
+        float k = float(i - 64);
+        float angle = (time * 3.0 + k * 12.0) * DEG2RAD;
+        float edgeRadius = radius * (1.0 + sin(time * 5.0 + k) * 0.1);
+        vec3 p = pos + vec3(cos(angle) * edgeRadius, sin(time * 4.0 + k * 0.5) * 0.4, sin(angle) * edgeRadius);
+        Dot(p, 0.08, Rgba(100.0, 255.0, 100.0, 150.0 + sin(time * 10.0 + k) * 100.0));
+    } else if (i < 96) {
+        // Nucleo
+        float coreSize = 0.3 + sin(time * 5.0) * 0.1;
+        if (i == 94) Dot(pos, coreSize, Rgba(200.0, 255.0, 200.0, 255.0));
+        else Dot(pos, coreSize * 0.6, vec4(1.0));
+    } else if (i < 104) {
+        // Archi elettrici
+        float k = float(i - 96);
+        float arcAngle = (time * 4.0 + k * 45.0) * DEG2RAD;
+        float arcRadius = radius * 0.7;
+        vec3 start = pos + vec3(cos(arcAngle) * arcRadius, 0.0, sin(arcAngle) * arcRadius);
+        vec3 end = pos + vec3(cos(arcAngle + PI) * arcRadius * 0.5, sin(time * 8.0 + k) * 0.3,
+                              sin(arcAngle + PI) * arcRadius * 0.5);
+        Segment(start, end, Rgba(100.0, 255.0, 150.0, 180.0));
+    } else {
+        // Distorsione: cerchi che si espandono e svaniscono
+        float w = float(i - 104);
+        float waveTime = time * 1.5 + w * 2.0;
+        float wavePhase = mod(waveTime, 3.0) / 3.0;
+        float waveAlpha = 200.0 * (1.0 - wavePhase);
+        if (waveAlpha <= 10.0) { Hide(); return; }
+        Ring(pos + vec3(0.0, sin(waveTime) * 0.2, 0.0), radius * (0.5 + wavePhase * 0.8),
+             Rgba(80.0, 255.0, 120.0, waveAlpha));
+    }
+}
+
+// Come il vecchio disegno degli occhi in WatcherSystem::Draw
+void WatcherEyes(int i, vec3 pos, float size, float opacity, float eyeGlow, bool stare)
+{
+    if (opacity <= 0.2 || (i >= 2 && !stare)) { Hide(); return; }
+
+    float side = (i % 2 == 0) ? -1.0 : 1.0;
+    vec3 eye = pos + vec3(side * 0.3 * size, 0.2 * size, 0.0);
+    float eyeSize = 0.15 * size;
+    if (i < 2) Dot(eye, eyeSize, vec4(1.0, 1.0, 1.0, opacity * eyeGlow));
+    else Dot(eye, eyeSize * 1.3, vec4(230.0 / 255.0, 41.0 / 255.0, 55.0 / 255.0, opacity * 0.3));
+}
+
+void main()
+{
+    corner = vertexPosition.xy;
+    fragCorner = corner * 2.0;
+    fragThickness = 0.0;
+
+    int particle = int(vertexPosition.z + 0.5);
+    vec3 pos = instanceTransform[0].xyz;
+    float size = instanceTransform[0].w;
+    vec4 color = instanceTransform[1];
+    vec4 params = instanceTransform[2];
+
+    if (effectType == 0) Monument(particle, pos, size, color, params.x, params.y > 0.5);
+    else if (effectType == 1) Portal(particle, pos, size, color);
+    else WatcherEyes(particle, pos, size, params.x, params.y, params.z > 0.5);
+
+    // Particelle nascoste: quad degenere
+    gl_Position = (fragColor.a > 0.0) ? mvp * vec4(worldPos, 1.0) : vec4(0.0, 0.0, 0.0, 0.0);
+}
@@ -0,0 +1,27 @@
+#version 330
+
+in vec2 fragTexCoord;
+flat in float fragFade;
+
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+out vec4 finalColor;
+
+// Soglia a retino 4x4: la geometria scarta i pixel sotto la dissolvenza, l'impostor gli altri
+float Dither(vec2 p)
+{
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                      3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 i = ivec2(mod(p, 4.0));
+    return (bayer[i.x + i.y * 4] + 0.5) / 16.0;
+}
+
+void main()
+{
+    if (Dither(gl_FragCoord.xy) >= fragFade) discard;
+
+    vec4 texel = texture(texture0, fragTexCoord);
+    if (texel.a < 0.5) discard;
+    finalColor = vec4(texel.rgb, 1.0) * colDiffuse;
+}
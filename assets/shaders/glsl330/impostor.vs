@@ -0,0 +1,41 @@
+#version 330
+
+in vec3 vertexPosition;
+in mat4 instanceTransform;
+
+uniform mat4 mvp;
+uniform vec3 viewPos;
+uniform vec2 fadeRange;    // inizio e fine della dissolvenza geometria -> impostor
+uniform vec3 tile;         // riga della variante, righe totali, viste per riga
+uniform vec2 bounds;       // centro verticale e mezzo lato del quad (scala 1)
+
+out vec2 fragTexCoord;
+flat out float fragFade;
+
+void main()
+{
+    vec3 origin = instanceTransform[3].xyz;
+    float scale = length(instanceTransform[0].xyz);
+
+    vec3 toCamera = viewPos - origin;
+    toCamera.y = 0.0;
+    toCamera = (dot(toCamera, toCamera) > 1e-6) ? normalize(toCamera) : vec3(0.0, 0.0, 1.0);
+
+    // Direzione della camera nello spazio dell'oggetto (rotazione solo attorno a Y)
+    vec3 axisX = instanceTransform[0].xyz / scale;
+    vec3 axisZ = instanceTransform[2].xyz / scale;
+    float angle = atan(dot(toCamera, axisX), dot(toCamera, axisZ));
+    float view = mod(floor(angle / 6.28318531 * tile.z + 0.5), tile.z);
+
+    // Quad verticale rivolto alla camera: x a destra, z del piano verso l'alto
+    vec2 corner = vec2(vertexPosition.x + 0.5, 0.5 - vertexPosition.z);
+    vec3 right = vec3(toCamera.z, 0.0, -toCamera.x);
+    float size = 2.0 * bounds.y * scale;
+    vec3 position = origin + vec3(0.0, bounds.x * scale, 0.0)
+                  + right * (corner.x - 0.5) * size
+                  + vec3(0.0, (corner.y - 0.5) * size, 0.0);
+
+    fragTexCoord = vec2((view + corner.x) / tile.z, (tile.x + corner.y) / tile.y);
+    fragFade = smoothstep(fadeRange.x, fadeRange.y, distance(viewPos.xz, origin.xz));
+    gl_Position = mvp * vec4(position, 1.0);
+}
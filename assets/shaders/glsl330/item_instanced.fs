@@ -0,0 +1,15 @@
+#version 330
+
+in vec2 fragTexCoord;
+
+uniform vec4 colDiffuse;
+
+out vec4 finalColor;
+
+void main()
+{
+    // Bordi scuri al posto di DrawCubeWires: le UV vanno da 0 a 1 su ogni faccia
+    vec2 edge = min(fragTexCoord, 1.0 - fragTexCoord);
+    float wire = step(min(edge.x, edge.y), 0.06);
+    finalColor = vec4(mix(colDiffuse.rgb, vec3(0.0), wire), colDiffuse.a);
+}
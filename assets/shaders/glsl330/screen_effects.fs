@@ -0,0 +1,38 @@
+#version 330
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+uniform sampler2D texture0;
+uniform float aberration;   // spostamento radiale di rosso e blu (uv al bordo)
+uniform float vignette;     // 0 = nessun oscuramento ai bordi
+uniform vec2 shake;         // offset della scena in uv
+uniform vec2 uvScale;       // parte del target occupata dalla scena (risoluzione dinamica)
+
+out vec4 finalColor;
+
+// Campiona la scena in coordinate schermo 0..1, senza uscire dalla parte renderizzata
+vec4 SampleScene(vec2 screenUv)
+{
+    vec2 halfTexel = 0.5 / vec2(textureSize(texture0, 0));
+    vec2 uv = clamp(screenUv * uvScale, halfTexel, uvScale - halfTexel);
+    return texture(texture0, uv);
+}
+
+// Aberrazione cromatica, vignetta, shake e upscale in un solo passaggio
+void main()
+{
+    vec2 uv = fragTexCoord / uvScale + shake;
+
+    vec2 centerOffset = uv - vec2(0.5);
+    float dist = length(centerOffset);
+    vec2 direction = centerOffset / (dist + 0.001);
+    vec2 fringe = direction * aberration * dist;
+
+    float r = SampleScene(uv + fringe).r;
+    float g = SampleScene(uv).g;
+    float b = SampleScene(uv - fringe).b;
+
+    float shade = 1.0 - vignette * smoothstep(0.25, 0.75, dist);
+    finalColor = vec4(vec3(r, g, b) * shade, 1.0);
+}
@@ -0,0 +1,68 @@
+#version 330
+
+// Varianti: vedi terrain.vs
+
+in vec3 fragNormal;
+in vec4 fragColor;
+#ifdef TERRAIN_TEXTURED
+in vec2 fragTexCoord;
+#endif
+#if defined(TERRAIN_FOG) || defined(TERRAIN_WATER)
+in vec3 fragPosition;
+#endif
+
+uniform vec4 colDiffuse;
+// Luce della dimensione (lightDir normalizzata sulla CPU)
+uniform vec3 lightDir;
+uniform vec3 lightColor;
+uniform vec3 ambientColor;
+#ifdef TERRAIN_TEXTURED
+uniform sampler2D texture0;
+#endif
+#if defined(TERRAIN_FOG) || defined(TERRAIN_WATER)
+uniform vec3 viewPos;
+#endif
+#ifdef TERRAIN_FOG
+uniform vec4 fogColor;
+
+// Nebbia lineare: limpida fino a fogStart, piena da fogEnd in poi
+const float fogStart = 10.0;
+const float fogEnd = 50.0;
+#endif
+
+out vec4 finalColor;
+
+void main()
+{
+    vec3 baseColor = fragColor.rgb * colDiffuse.rgb;
+    // Alpha dal vertice: l'acqua resta trasparente in ogni variante
+    float alpha = fragColor.a;
+#ifdef TERRAIN_TEXTURED
+    vec4 texelColor = texture(texture0, fragTexCoord);
+    baseColor *= texelColor.rgb;
+    alpha *= texelColor.a;
+#endif
+
+    vec3 normal = normalize(fragNormal);
+    float diff = max(dot(normal, -lightDir), 0.0);
+    vec3 color = baseColor * (ambientColor + lightColor * diff);
+
+#ifdef TERRAIN_WATER
+    // Riflesso del cielo ad angolo radente e punto di luce del sole
+    if (fragColor.a < 0.99)
+    {
+        vec3 viewDir = normalize(viewPos - fragPosition);
+        float fresnel = pow(1.0 - max(dot(normal, viewDir), 0.0), 3.0);
+        float spec = pow(max(dot(normal, normalize(viewDir - lightDir)), 0.0), 48.0);
+        color = mix(color, lightColor, fresnel * 0.35) + lightColor * spec * 0.5;
+    }
+#endif
+
+#ifdef TERRAIN_FOG
+    float distance = length(viewPos - fragPosition);
+    float fogFactor = clamp((fogEnd - distance) / (fogEnd - fogStart), 0.0, 1.0);
+    color = mix(fogColor.rgb, color, fogFactor);
+#endif
+
+    finalColor = vec4(color, alpha);
+}
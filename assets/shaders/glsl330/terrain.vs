@@ -0,0 +1,39 @@
+#version 330
+
+// Varianti, definite dal registro prima della compilazione:
+//   TERRAIN_FOG       nebbia lineare (10–50 m)
+//   TERRAIN_TEXTURED  texture moltiplicata per il colore dei vertici
+//   TERRAIN_WATER     riflessi sulle facce d'acqua (alpha dei vertici < 1)
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec4 vertexColor;
+#ifdef TERRAIN_TEXTURED
+in vec2 vertexTexCoord;
+#endif
+
+uniform mat4 mvp;
+uniform mat4 matModel;
+uniform mat4 matNormal;   // transpose(inverse(matModel)), calcolata sulla CPU da DrawMesh
+
+out vec3 fragNormal;
+out vec4 fragColor;
+#ifdef TERRAIN_TEXTURED
+out vec2 fragTexCoord;
+#endif
+#if defined(TERRAIN_FOG) || defined(TERRAIN_WATER)
+out vec3 fragPosition;
+#endif
+
+void main()
+{
+    fragNormal = mat3(matNormal) * vertexNormal;
+    fragColor = vertexColor;
+#ifdef TERRAIN_TEXTURED
+    fragTexCoord = vertexTexCoord;
+#endif
+#if defined(TERRAIN_FOG) || defined(TERRAIN_WATER)
+    fragPosition = vec3(matModel * vec4(vertexPosition, 1.0));
+#endif
+    gl_Position = mvp * vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,151 @@
+#include "assetCache.h"
+
+AssetCache& AssetCache::Get() {
+    static AssetCache instance;
+    return instance;
+}
+
+// Slot libero (o nuovo) con la generazione successiva: mai 0
+template <typename T>
+static uint32_t AllocSlot(std::vector<T>& slots, std::vector<uint32_t>& freeList) {
+    uint32_t index;
+    if (!freeList.empty()) {
+        index = freeList.back();
+        freeList.pop_back();
+    } else {
+        index = (uint32_t)slots.size();
+        slots.push_back(T());
+        slots[index].generation = 0;
+    }
+    slots[index].generation++;
+    if (slots[index].generation == 0) slots[index].generation = 1;
+    return index;
+}
+
+// ---------- TEXTURE ----------
+
+TextureHandle AssetCache::AcquireTexture(const char* path) {
+    auto it = m_textureIndex.find(path);
+    if (it != m_textureIndex.end()) {
+        Slot<Texture2D>& slot = m_textures[it->second];
+        slot.refs++;
+        return {it->second, slot.generation};
+    }
+
+    Texture2D texture = LoadTexture(path);
+    if (texture.id == 0) {
+        TraceLog(LOG_WARNING, "⚠️ AssetCache: texture not loaded: %s", path);
+        return NULL_TEXTURE;
+    }
+
+    uint32_t index = AllocSlot(m_textures, m_freeTextures);
+    Slot<Texture2D>& slot = m_textures[index];
+    slot.path = path;
+    slot.asset = texture;
+    slot.refs = 1;
+    m_textureIndex[slot.path] = index;
+    return {index, slot.generation};
+}
+
+TextureHandle AssetCache::Retain(TextureHandle handle) {
+    if (!handle.IsValid() || handle.index >= m_textures.size()) return NULL_TEXTURE;
+    Slot<Texture2D>& slot = m_textures[handle.index];
+    if (slot.generation != handle.generation || slot.refs <= 0) return NULL_TEXTURE;
+    slot.refs++;
+    return handle;
+}
+
+void AssetCache::Release(TextureHandle handle) {
+    if (!handle.IsValid() || handle.index >= m_textures.size()) return;
+    Slot<Texture2D>& slot = m_textures[handle.index];
+    if (slot.generation != handle.generation || slot.refs <= 0) return;
+
+    if (--slot.refs > 0) return;
+    UnloadTexture(slot.asset);
+    m_textureIndex.erase(slot.path);
+    slot.path.clear();
+    slot.asset = {};
+    // Gli handle rimasti in giro non risolvono più
+    slot.generation++;
+    if (slot.generation == 0) slot.generation = 1;
+    m_freeTextures.push_back(handle.index);
+}
+
+Texture2D AssetCache::GetTexture(TextureHandle handle) const {
+    if (!handle.IsValid() || handle.index >= m_textures.size()) return {};
+    const Slot<Texture2D>& slot = m_textures[handle.index];
+    if (slot.generation != handle.generation || slot.refs <= 0) return {};
+    return slot.asset;
+}
+
+// ---------- MODELLI ----------
+
+ModelHandle AssetCache::AcquireModel(const char* path) {
+    auto it = m_modelIndex.find(path);
+    if (it != m_modelIndex.end()) {
+        Slot<Model>& slot = m_models[it->second];
+        slot.refs++;
+        return {it->second, slot.generation};
+    }
+
+    Model model = LoadModel(path);
+    if (model.meshCount == 0) {
+        UnloadModel(model);
+        TraceLog(LOG_WARNING, "⚠️ AssetCache: model not loaded: %s", path);
+        return NULL_MODEL;
+    }
+
+    uint32_t index = AllocSlot(m_models, m_freeModels);
+    Slot<Model>& slot = m_models[index];
+    slot.path = path;
+    slot.asset = model;
+    slot.refs = 1;
+    m_modelIndex[slot.path] = index;
+    return {index, slot.generation};
+}
+
+void AssetCache::Release(ModelHandle handle) {
+    if (!handle.IsValid() || handle.index >= m_models.size()) return;
+    Slot<Model>& slot = m_models[handle.index];
+    if (slot.generation != handle.generation || slot.refs <= 0) return;
+
+    if (--slot.refs > 0) return;
+    UnloadModel(slot.asset);
+    m_modelIndex.erase(slot.path);
+    slot.path.clear();
+    slot.asset = {};
+    slot.generation++;
+    if (slot.generation == 0) slot.generation = 1;
+    m_freeModels.push_back(handle.index);
+}
+
+Model* AssetCache::GetModel(ModelHandle handle) {
+    if (!handle.IsValid() || handle.index >= m_models.size()) return nullptr;
+    Slot<Model>& slot = m_models[handle.index];
+    if (slot.generation != handle.generation || slot.refs <= 0) return nullptr;
+    return &slot.asset;
+}
+
+void AssetCache::Cleanup() {
+    int leaked = 0;
+    for (Slot<Texture2D>& slot : m_textures) {
+        if (slot.refs <= 0) continue;
+        TraceLog(LOG_WARNING, "⚠️ AssetCache: %s still held (%d refs)", slot.path.c_str(), slot.refs);
+        UnloadTexture(slot.asset);
+        leaked++;
+    }
+    for (Slot<Model>& slot : m_models) {
+        if (slot.refs <= 0) continue;
+        TraceLog(LOG_WARNING, "⚠️ AssetCache: %s still held (%d refs)", slot.path.c_str(), slot.refs);
+        UnloadModel(slot.asset);
+        leaked++;
+    }
+
+    m_textures.clear();
+    m_models.clear();
+    m_freeTextures.clear();
+    m_freeModels.clear();
+    m_textureIndex.clear();
+    m_modelIndex.clear();
+    TraceLog(LOG_INFO, "✓ AssetCache cleaned up (%d assets still referenced)", leaked);
+}
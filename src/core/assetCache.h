@@ -0,0 +1,75 @@
+#pragma once
+
+#include "raylib.h"
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Handle di un asset della cache: dopo l'ultimo Release la generazione dello
+// slot cambia e il vecchio handle non risolve più. Generazione 0 = nessun asset,
+// così un handle inizializzato a {} è già nullo.
+struct TextureHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    bool IsValid() const { return generation != 0; }
+};
+
+struct ModelHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    bool IsValid() const { return generation != 0; }
+};
+
+static const TextureHandle NULL_TEXTURE = {0, 0};
+static const ModelHandle NULL_MODEL = {0, 0};
+
+// Cache centrale di texture e modelli indicizzata per path, con conteggio dei
+// riferimenti: ogni file viene decodificato e caricato sulla GPU una sola volta
+// finché qualcuno lo usa, e scaricato al rilascio dell'ultimo riferimento.
+class AssetCache {
+public:
+    static AssetCache& Get();
+
+    // Primo Acquire: carica il file; i successivi sullo stesso path
+    // condividono l'asset. Handle nullo se il caricamento fallisce.
+    TextureHandle AcquireTexture(const char* path);
+    // Riferimento in più a un asset già tenuto (es. materiali che lo usano)
+    TextureHandle Retain(TextureHandle handle);
+    void Release(TextureHandle handle);
+    // Texture vuota (id 0) se l'handle non risolve
+    Texture2D GetTexture(TextureHandle handle) const;
+
+    ModelHandle AcquireModel(const char* path);
+    void Release(ModelHandle handle);
+    // nullptr se l'handle non risolve; il modello resta della cache
+    Model* GetModel(ModelHandle handle);
+
+    // A fine programma: scarica quello che è rimasto e segnala i riferimenti persi
+    void Cleanup();
+
+    int GetTextureCount() const { return (int)m_textureIndex.size(); }
+    int GetModelCount() const { return (int)m_modelIndex.size(); }
+
+private:
+    AssetCache() = default;
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    template <typename T>
+    struct Slot {
+        std::string path;
+        T asset;
+        int refs;
+        uint32_t generation;
+    };
+
+    std::vector<Slot<Texture2D>> m_textures;
+    std::vector<Slot<Model>> m_models;
+    std::vector<uint32_t> m_freeTextures;
+    std::vector<uint32_t> m_freeModels;
+    std::unordered_map<std::string, uint32_t> m_textureIndex;
+    std::unordered_map<std::string, uint32_t> m_modelIndex;
+};
@@ -0,0 +1,127 @@
+#include "entityStore.h"
+#include "spatialIndex.h"
+#include <string.h>
+
+static size_t s_componentSizes[MAX_COMPONENT_TYPES];
+static int s_componentCount = 0;
+
+int ComponentTypes::Register(size_t size) {
+    if (s_componentCount >= MAX_COMPONENT_TYPES) {
+        TraceLog(LOG_FATAL, "EntityStore: more than %d component types", MAX_COMPONENT_TYPES);
+        return MAX_COMPONENT_TYPES - 1;
+    }
+    s_componentSizes[s_componentCount] = size;
+    return s_componentCount++;
+}
+
+size_t ComponentTypes::Size(int id) {
+    return s_componentSizes[id];
+}
+
+EntityStore::EntityStore() {}
+
+EntityStore& EntityStore::Get() {
+    static EntityStore instance;
+    return instance;
+}
+
+bool EntityStore::IsAlive(EntityHandle h) const {
+    return h.index < m_slots.size() && m_slots[h.index].generation == h.generation &&
+           m_slots[h.index].archetype >= 0;
+}
+
+int EntityStore::FindOrCreateArchetype(const int* types, int count) {
+    ComponentMask mask = 0;
+    for (int i = 0; i < count; i++) mask |= ComponentMask{1} << types[i];
+
+    for (size_t i = 0; i < m_archetypes.size(); i++) {
+        if (m_archetypes[i].mask == mask) return (int)i;
+    }
+
+    Archetype a;
+    a.mask = mask;
+    for (int t = 0; t < MAX_COMPONENT_TYPES; t++) a.m_column[t] = -1;
+    for (int t = 0; t < MAX_COMPONENT_TYPES; t++) {
+        if (!(mask & (ComponentMask{1} << t))) continue;
+        a.m_column[t] = (int)a.m_types.size();
+        a.m_types.push_back(t);
+    }
+    a.m_data.resize(a.m_types.size());
+
+    m_archetypes.push_back(a);
+    return (int)m_archetypes.size() - 1;
+}
+
+EntityHandle EntityStore::CreateRaw(const int* types, const void* const* data, int count) {
+    int archetypeIndex = FindOrCreateArchetype(types, count);
+    Archetype& a = m_archetypes[archetypeIndex];
+
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = (uint32_t)m_slots.size();
+        m_slots.push_back({0, -1, -1});
+    }
+
+    Slot& slot = m_slots[index];
+    slot.archetype = archetypeIndex;
+    slot.row = a.Count();
+
+    EntityHandle h = {index, slot.generation};
+    a.entities.push_back(h);
+
+    for (int i = 0; i < count; i++) {
+        std::vector<unsigned char>& column = a.m_data[a.m_column[types[i]]];
+        size_t size = ComponentTypes::Size(types[i]);
+        const unsigned char* bytes = (const unsigned char*)data[i];
+        column.insert(column.end(), bytes, bytes + size);
+    }
+    return h;
+}
+
+void EntityStore::Destroy(EntityHandle h) {
+    if (!IsAlive(h)) return;
+    SpatialIndex::Get().Remove(h);
+
+    Slot& slot = m_slots[h.index];
+    Archetype& a = m_archetypes[slot.archetype];
+    int row = slot.row;
+    int last = a.Count() - 1;
+
+    // L'ultima riga prende il posto di quella rimossa
+    for (size_t c = 0; c < a.m_types.size(); c++) {
+        size_t size = ComponentTypes::Size(a.m_types[c]);
+        std::vector<unsigned char>& column = a.m_data[c];
+        if (row != last) memcpy(&column[row * size], &column[last * size], size);
+        column.resize(last * size);
+    }
+    if (row != last) {
+        a.entities[row] = a.entities[last];
+        m_slots[a.entities[row].index].row = row;
+    }
+    a.entities.pop_back();
+
+    slot.generation++;
+    slot.archetype = -1;
+    slot.row = -1;
+    m_freeSlots.push_back(h.index);
+}
+
+void EntityStore::DestroyMatching(ComponentMask mask) {
+    for (Archetype& a : m_archetypes) {
+        if ((a.mask & mask) != mask) continue;
+
+        for (const EntityHandle& h : a.entities) {
+            SpatialIndex::Get().Remove(h);
+            Slot& slot = m_slots[h.index];
+            slot.generation++;
+            slot.archetype = -1;
+            slot.row = -1;
+            m_freeSlots.push_back(h.index);
+        }
+        a.entities.clear();
+        for (std::vector<unsigned char>& column : a.m_data) column.clear();
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "raylib.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+// Handle stabile di un'entità: resta valido anche quando la sua riga nel pool
+// si sposta; dopo Destroy la generazione dello slot cambia e il vecchio
+// handle non risolve più
+struct EntityHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(const EntityHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const EntityHandle& o) const { return !(*this == o); }
+};
+
+static const EntityHandle NULL_ENTITY = {0xFFFFFFFFu, 0};
+
+// ---------- COMPONENTI CONDIVISI ----------
+
+// Posizione e scala: letti da fisica, visibilità e render
+struct EntityTransform {
+    Vector3 position;
+    float scale;
+};
+
+// Entità che si muovono nel tick: prevPosition serve all'interpolazione del render
+struct EntityMotion {
+    Vector3 velocity;
+    Vector3 prevPosition;
+};
+
+// ---------- STORE ----------
+
+#define MAX_COMPONENT_TYPES 64
+typedef uint64_t ComponentMask;
+
+// Id dei tipi di componente, assegnati al primo uso. I componenti sono POD:
+// le colonne vengono copiate e compattate byte per byte.
+class ComponentTypes {
+public:
+    template <typename T>
+    static int Id() {
+        static_assert(std::is_trivially_copyable<T>::value, "components must be trivially copyable");
+        static const int id = Register(sizeof(T));
+        return id;
+    }
+    static size_t Size(int id);
+
+private:
+    static int Register(size_t size);
+};
+
+// Pool SoA di tutte le entità con la stessa combinazione di componenti:
+// una colonna contigua per componente, righe sempre compatte (swap-remove)
+class Archetype {
+public:
+    ComponentMask mask;
+    std::vector<EntityHandle> entities;
+
+    int Count() const { return (int)entities.size(); }
+
+    template <typename T>
+    T* Column() {
+        int c = m_column[ComponentTypes::Id<T>()];
+        return (c < 0) ? nullptr : reinterpret_cast<T*>(m_data[c].data());
+    }
+
+private:
+    friend class EntityStore;
+    int m_column[MAX_COMPONENT_TYPES];
+    std::vector<int> m_types;                      // tipo di ogni colonna
+    std::vector<std::vector<unsigned char>> m_data;
+};
+
+// Store condiviso da watcher, monumenti, portali, oggetti a terra e decorazioni.
+// I passaggi (fisica, visibilità, render) iterano gli archetipi che hanno i
+// componenti richiesti e ricevono direttamente le colonne dense.
+// Create e Destroy possono spostare le righe: niente Create/Destroy dentro
+// ForEach e nessun puntatore ai componenti conservato oltre la chiamata.
+class EntityStore {
+public:
+    static EntityStore& Get();
+
+    template <typename... C>
+    EntityHandle Create(const C&... components) {
+        const int types[] = {ComponentTypes::Id<C>()...};
+        const void* data[] = {&components...};
+        return CreateRaw(types, data, (int)sizeof...(C));
+    }
+
+    void Destroy(EntityHandle h);
+    bool IsAlive(EntityHandle h) const;
+
+    // nullptr se l'entità non esiste più o non ha il componente
+    template <typename T>
+    T* Find(EntityHandle h) {
+        if (!IsAlive(h)) return nullptr;
+        const Slot& slot = m_slots[h.index];
+        T* column = m_archetypes[slot.archetype].Column<T>();
+        return column ? column + slot.row : nullptr;
+    }
+
+    // fn(int count, const EntityHandle* handles, C*... columns) per ogni pool con tutti i C
+    template <typename... C, typename F>
+    void ForEach(F fn) {
+        ComponentMask need = MaskOf<C...>();
+        for (Archetype& a : m_archetypes) {
+            if ((a.mask & need) != need || a.entities.empty()) continue;
+            fn(a.Count(), a.entities.data(), a.Column<C>()...);
+        }
+    }
+
+    template <typename... C>
+    int Count() const {
+        ComponentMask need = MaskOf<C...>();
+        int count = 0;
+        for (const Archetype& a : m_archetypes) {
+            if ((a.mask & need) == need) count += a.Count();
+        }
+        return count;
+    }
+
+    // Distrugge tutte le entità che hanno i componenti C (cleanup di un sistema)
+    template <typename... C>
+    void DestroyAll() {
+        DestroyMatching(MaskOf<C...>());
+    }
+
+private:
+    EntityStore();
+    EntityStore(const EntityStore&) = delete;
+    EntityStore& operator=(const EntityStore&) = delete;
+
+    struct Slot {
+        uint32_t generation;
+        int archetype;
+        int row;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<Archetype> m_archetypes;
+
+    template <typename... C>
+    static ComponentMask MaskOf() {
+        return (ComponentMask{0} | ... | (ComponentMask{1} << ComponentTypes::Id<C>()));
+    }
+
+    EntityHandle CreateRaw(const int* types, const void* const* data, int count);
+    int FindOrCreateArchetype(const int* types, int count);
+    void DestroyMatching(ComponentMask mask);
+};
@@ -0,0 +1,212 @@
+#include "flowField.h"
+#include "../world/firstWorld.h"
+#include <raymath.h>
+#include <algorithm>
+#include <float.h>
+#include <functional>
+#include <math.h>
+
+// Lavoro per tick del ricalcolo (celle espanse; una riga di altezze conta
+// FLOW_FIELD_SIZE): circa 9 tick per un campo completo
+#define FLOW_EXPANSIONS_PER_TICK 2048
+// Dislivello massimo (blocchi) tra celle vicine: oltre si gira attorno
+#define FLOW_MAX_STEP 3.0f
+// Costo aggiuntivo per blocco di salita
+#define FLOW_CLIMB_COST 2.0f
+
+// 4 vicini ortogonali, poi i 4 diagonali
+static const int DX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+static const int DZ[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+static const int OPPOSITE[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+
+FlowField::FlowField()
+    : m_current(0), m_building(false), m_heightRow(0), m_goalX(0), m_goalZ(0),
+      m_terrainVersion(0), m_hasGoal(false), m_dirty(false) {
+    for (Grid& g : m_grids) {
+        g.originX = 0;
+        g.originZ = 0;
+        g.height.resize(FLOW_FIELD_SIZE * FLOW_FIELD_SIZE);
+        g.cost.resize(FLOW_FIELD_SIZE * FLOW_FIELD_SIZE);
+        g.next.resize(FLOW_FIELD_SIZE * FLOW_FIELD_SIZE);
+        g.valid = false;
+    }
+}
+
+FlowField& FlowField::Get() {
+    static FlowField instance;
+    return instance;
+}
+
+void FlowField::Clear() {
+    m_grids[0].valid = false;
+    m_grids[1].valid = false;
+    m_building = false;
+    m_hasGoal = false;
+    m_dirty = false;
+    m_open.clear();
+}
+
+// Altezza della faccia superiore della colonna; -FLT_MAX se il chunk non esiste
+static float GetColumnTop(World* world, int x, int z, Chunk** cache) {
+    int cx = (int)floorf((float)x / CHUNK_SIZE);
+    int cz = (int)floorf((float)z / CHUNK_SIZE);
+
+    Chunk* chunk = *cache;
+    if (!chunk || chunk->chunkX != cx || chunk->chunkZ != cz) {
+        chunk = WorldFindChunk(world, cx, cz);
+        *cache = chunk;
+    }
+    if (!chunk || !chunk->generated) return -FLT_MAX;
+
+    return chunk->heightMap[x - cx * CHUNK_SIZE][z - cz * CHUNK_SIZE] + 1.0f;
+}
+
+// Colonna più alta della cella; una colonna mancante la rende inutilizzabile
+static float GetCellTop(World* world, int x, int z, int size, Chunk** cache) {
+    float top = -FLT_MAX;
+    for (int bx = 0; bx < size; bx++) {
+        for (int bz = 0; bz < size; bz++) {
+            float h = GetColumnTop(world, x + bx, z + bz, cache);
+            if (h == -FLT_MAX) return -FLT_MAX;
+            top = fmaxf(top, h);
+        }
+    }
+    return top;
+}
+
+// Cella di passaggio raggiungibile da entrambe le altezze
+static bool IsStepAllowed(float h, float fromHeight, float toHeight) {
+    return h != -FLT_MAX && fabsf(h - fromHeight) <= FLOW_MAX_STEP && fabsf(h - toHeight) <= FLOW_MAX_STEP;
+}
+
+void FlowField::Update(World* world, Vector3 playerPos) {
+    int goalX = (int)floorf(playerPos.x / FLOW_CELL_SIZE);
+    int goalZ = (int)floorf(playerPos.z / FLOW_CELL_SIZE);
+
+    if (!m_hasGoal || goalX != m_goalX || goalZ != m_goalZ || world->terrainVersion != m_terrainVersion) {
+        m_goalX = goalX;
+        m_goalZ = goalZ;
+        m_terrainVersion = world->terrainVersion;
+        m_hasGoal = true;
+        m_dirty = true;
+    }
+
+    // Un ricalcolo avviato arriva sempre in fondo: con il terreno che si
+    // genera a ogni passo, ripartire da capo non finirebbe mai
+    if (!m_building && m_dirty) {
+        StartBuild(m_goalX, m_goalZ);
+        m_dirty = false;
+    }
+    if (m_building) StepBuild(world, FLOW_EXPANSIONS_PER_TICK);
+}
+
+void FlowField::StartBuild(int goalX, int goalZ) {
+    Grid& g = m_grids[1 - m_current];
+    g.originX = goalX - FLOW_FIELD_SIZE / 2;
+    g.originZ = goalZ - FLOW_FIELD_SIZE / 2;
+    std::fill(g.cost.begin(), g.cost.end(), FLT_MAX);
+    std::fill(g.next.begin(), g.next.end(), (int8_t)-1);
+    g.valid = false;
+
+    m_open.clear();
+    m_heightRow = 0;
+    m_building = true;
+}
+
+void FlowField::StepBuild(World* world, int budget) {
+    Grid& g = m_grids[1 - m_current];
+    const int cellBlocks = (int)FLOW_CELL_SIZE;
+
+    // Fase 1: altezze, una riga alla volta
+    Chunk* cache = NULL;
+    while (m_heightRow < FLOW_FIELD_SIZE && budget > 0) {
+        int z = m_heightRow;
+        for (int x = 0; x < FLOW_FIELD_SIZE; x++) {
+            g.height[z * FLOW_FIELD_SIZE + x] =
+                GetCellTop(world, (g.originX + x) * cellBlocks, (g.originZ + z) * cellBlocks, cellBlocks, &cache);
+        }
+        m_heightRow++;
+        budget -= FLOW_FIELD_SIZE;
+
+        if (m_heightRow == FLOW_FIELD_SIZE) {
+            int goal = (FLOW_FIELD_SIZE / 2) * FLOW_FIELD_SIZE + FLOW_FIELD_SIZE / 2;
+            if (g.height[goal] != -FLT_MAX) {
+                g.cost[goal] = 0.0f;
+                m_open.push_back({0.0f, goal});
+            }
+        }
+    }
+
+    // Fase 2: Dijkstra dalla cella del player verso l'esterno
+    while (m_heightRow == FLOW_FIELD_SIZE && budget > 0) {
+        if (m_open.empty()) {
+            g.valid = true;
+            m_current = 1 - m_current;
+            m_building = false;
+            return;
+        }
+
+        std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+        OpenNode node = m_open.back();
+        m_open.pop_back();
+        budget--;
+        if (node.cost > g.cost[node.index]) continue;  // voce superata
+
+        int x = node.index % FLOW_FIELD_SIZE;
+        int z = node.index / FLOW_FIELD_SIZE;
+        float h = g.height[node.index];
+
+        for (int k = 0; k < 8; k++) {
+            int nx = x + DX[k];
+            int nz = z + DZ[k];
+            if (nx < 0 || nz < 0 || nx >= FLOW_FIELD_SIZE || nz >= FLOW_FIELD_SIZE) continue;
+
+            int n = nz * FLOW_FIELD_SIZE + nx;
+            float nh = g.height[n];
+            if (nh == -FLT_MAX) continue;
+
+            // Il watcher andrà da n verso questa cella: conta la salita in quel verso
+            float climb = h - nh;
+            if (fabsf(climb) > FLOW_MAX_STEP) continue;
+
+            // In diagonale si passa rasente alle due celle ortogonali: devono essere percorribili
+            if (k >= 4 && !(IsStepAllowed(g.height[z * FLOW_FIELD_SIZE + nx], h, nh) &&
+                            IsStepAllowed(g.height[nz * FLOW_FIELD_SIZE + x], h, nh))) continue;
+
+            float step = ((k < 4) ? 1.0f : 1.41421356f) * FLOW_CELL_SIZE;
+            float cost = node.cost + step + fmaxf(climb, 0.0f) * FLOW_CLIMB_COST;
+            if (cost >= g.cost[n]) continue;
+
+            g.cost[n] = cost;
+            g.next[n] = (int8_t)OPPOSITE[k];
+            m_open.push_back({cost, n});
+            std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+        }
+    }
+}
+
+FlowSample FlowField::Sample(Vector3 position) const {
+    FlowSample sample = {false, {0.0f, 0.0f, 0.0f}, 0.0f};
+
+    const Grid& g = m_grids[m_current];
+    if (!g.valid) return sample;
+
+    int x = (int)floorf(position.x / FLOW_CELL_SIZE) - g.originX;
+    int z = (int)floorf(position.z / FLOW_CELL_SIZE) - g.originZ;
+    if (x < 0 || z < 0 || x >= FLOW_FIELD_SIZE || z >= FLOW_FIELD_SIZE) return sample;
+
+    int i = z * FLOW_FIELD_SIZE + x;
+    if (g.cost[i] == FLT_MAX) return sample;
+
+    sample.valid = true;
+    sample.groundHeight = g.height[i];
+
+    // Verso il centro della cella successiva: il percorso non resta a scatti di 45°
+    int k = g.next[i];
+    if (k >= 0) {
+        float targetX = (g.originX + x + DX[k] + 0.5f) * FLOW_CELL_SIZE;
+        float targetZ = (g.originZ + z + DZ[k] + 0.5f) * FLOW_CELL_SIZE;
+        sample.direction = Vector3Normalize((Vector3){targetX - position.x, 0.0f, targetZ - position.z});
+    }
+    return sample;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "raylib.h"
+#include <stdint.h>
+#include <vector>
+
+struct World;
+
+// Celle per lato e lato (m) di una cella: il campo copre ±96 m attorno al player
+#define FLOW_FIELD_SIZE 96
+#define FLOW_CELL_SIZE 2.0f
+
+struct FlowSample {
+    bool valid;            // false fuori dal campo o in celle irraggiungibili
+    Vector3 direction;     // direzione XZ normalizzata verso il player
+    float groundHeight;    // cima del terreno nella cella
+};
+
+// Campo di flusso verso il player sulla heightfield locale, condiviso da tutti
+// i watcher: un solo Dijkstra per player invece di una ricerca per watcher.
+// Il campo si ricalcola quando il player cambia cella o il terreno cambia; il
+// ricalcolo avanza di FLOW_EXPANSIONS_PER_TICK celle per tick su un secondo
+// buffer, e nel frattempo i watcher seguono il campo precedente.
+class FlowField {
+public:
+    static FlowField& Get();
+
+    // Da chiamare una volta per tick, prima degli Update dei watcher
+    void Update(World* world, Vector3 playerPos);
+    FlowSample Sample(Vector3 position) const;
+    // Cambio dimensione: il campo non vale più
+    void Clear();
+
+private:
+    FlowField();
+    FlowField(const FlowField&) = delete;
+    FlowField& operator=(const FlowField&) = delete;
+
+    struct Grid {
+        int originX, originZ;        // cella mondo dell'angolo (0, 0)
+        std::vector<float> height;   // -FLT_MAX = chunk non generato
+        std::vector<float> cost;     // costo fino al player, FLT_MAX = irraggiungibile
+        std::vector<int8_t> next;    // vicino verso il player, -1 = cella del player
+        bool valid;
+    };
+
+    struct OpenNode {
+        float cost;
+        int index;
+        bool operator>(const OpenNode& o) const { return cost > o.cost; }
+    };
+
+    Grid m_grids[2];
+    int m_current;                   // griglia pubblicata
+
+    // Ricalcolo in corso sulla griglia 1 - m_current
+    bool m_building;
+    int m_heightRow;                 // righe di altezze già campionate
+    std::vector<OpenNode> m_open;    // heap (min) del Dijkstra
+
+    int m_goalX, m_goalZ;
+    unsigned int m_terrainVersion;
+    bool m_hasGoal;
+    bool m_dirty;                    // cella o terreno cambiati: serve un nuovo campo
+
+    void StartBuild(int goalX, int goalZ);
+    void StepBuild(World* world, int budget);
+};
@@ -0,0 +1,126 @@
+#include "framePacing.h"
+#include <string.h>
+
+void FramePacerInit(FramePacer *pacer, int targetFps)
+{
+    memset(pacer, 0, sizeof(*pacer));
+    pacer->targetFrameTime = (targetFps > 0) ? 1.0 / targetFps : 0.0;
+
+    double now = GetTime();
+    pacer->deadline = now;
+    pacer->earlyInputTime = now;
+    pacer->lateInputTime = now;
+    pacer->lastPresentTime = now;
+    pacer->windowStart = now;
+    pacer->sessionStart = now;
+}
+
+void FramePacerWait(FramePacer *pacer)
+{
+    if (pacer->targetFrameTime <= 0.0)
+        return;
+
+    pacer->deadline += pacer->targetFrameTime;
+    double now = GetTime();
+
+    // Frame in ritardo di più di un periodo: si riparte da adesso invece di
+    // recuperare con una raffica di frame senza attesa
+    if (now > pacer->deadline + pacer->targetFrameTime)
+    {
+        pacer->deadline = now;
+        return;
+    }
+
+    double remaining = pacer->deadline - now;
+    if (remaining > FRAME_PACING_SPIN_MARGIN)
+        WaitTime(remaining - FRAME_PACING_SPIN_MARGIN);
+
+    while (GetTime() < pacer->deadline)
+    {
+    }
+}
+
+void FramePacerMarkInput(FramePacer *pacer)
+{
+    pacer->earlyInputTime = GetTime();
+    pacer->lateInputTime = pacer->earlyInputTime;
+}
+
+void FramePacerMarkLateInput(FramePacer *pacer)
+{
+    pacer->lateInputTime = GetTime();
+}
+
+void FramePacerPresented(FramePacer *pacer)
+{
+    double now = GetTime();
+    double early = now - pacer->earlyInputTime;
+    double late = now - pacer->lateInputTime;
+    double frameTime = now - pacer->lastPresentTime;
+    pacer->lastPresentTime = now;
+
+    pacer->windowFrames++;
+    pacer->earlySum += early;
+    pacer->lateSum += late;
+    if (late > pacer->lateMax)
+        pacer->lateMax = late;
+
+    pacer->frames++;
+    pacer->lateTotal += late;
+    if (frameTime > pacer->worstFrameTime)
+        pacer->worstFrameTime = frameTime;
+    int bucket = (int)(frameTime / FRAME_HISTOGRAM_STEP);
+    if (bucket >= FRAME_HISTOGRAM_BUCKETS)
+        bucket = FRAME_HISTOGRAM_BUCKETS - 1;
+    pacer->histogram[bucket]++;
+
+    if (now - pacer->windowStart < FRAME_LATENCY_REPORT_INTERVAL)
+        return;
+
+    pacer->earlyLatencyMs = (float)(pacer->earlySum / pacer->windowFrames * 1000.0);
+    pacer->lateLatencyMs = (float)(pacer->lateSum / pacer->windowFrames * 1000.0);
+    TraceLog(LOG_INFO, "Latency input->present: late %.2f ms (max %.2f) | early %.2f ms | %.0f FPS",
+             pacer->lateLatencyMs, pacer->lateMax * 1000.0, pacer->earlyLatencyMs,
+             pacer->windowFrames / (now - pacer->windowStart));
+
+    pacer->windowStart = now;
+    pacer->windowFrames = 0;
+    pacer->earlySum = 0.0;
+    pacer->lateSum = 0.0;
+    pacer->lateMax = 0.0;
+}
+
+double FramePacerElapsed(const FramePacer *pacer)
+{
+    return GetTime() - pacer->sessionStart;
+}
+
+// Tempo di frame sotto cui cade la frazione richiesta dei frame
+static double FramePercentile(const FramePacer *pacer, double fraction)
+{
+    long long threshold = (long long)(pacer->frames * fraction);
+    long long seen = 0;
+    for (int i = 0; i < FRAME_HISTOGRAM_BUCKETS; i++)
+    {
+        seen += pacer->histogram[i];
+        if (seen > threshold)
+            return (i + 1) * FRAME_HISTOGRAM_STEP;
+    }
+    return FRAME_HISTOGRAM_BUCKETS * FRAME_HISTOGRAM_STEP;
+}
+
+void FramePacerLogSummary(const FramePacer *pacer)
+{
+    if (pacer->frames == 0)
+        return;
+
+    double elapsed = pacer->lastPresentTime - pacer->sessionStart;
+    TraceLog(LOG_INFO, "Frames: %lld in %.2fs (%.1f FPS avg) | frame time avg %.2f ms, p50 %.1f ms, p99 %.1f ms, worst %.2f ms",
+             pacer->frames, elapsed, pacer->frames / elapsed,
+             elapsed / pacer->frames * 1000.0,
+             FramePercentile(pacer, 0.50) * 1000.0,
+             FramePercentile(pacer, 0.99) * 1000.0,
+             pacer->worstFrameTime * 1000.0);
+    TraceLog(LOG_INFO, "Latency input->present (late latch): avg %.2f ms",
+             pacer->lateTotal / pacer->frames * 1000.0);
+}
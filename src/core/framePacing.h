@@ -0,0 +1,54 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#include "raylib.h"
+
+// Gli ultimi millisecondi dell'attesa in spin: lo sleep del sistema non è
+// abbastanza preciso per rispettare la scadenza del frame
+#define FRAME_PACING_SPIN_MARGIN 0.002
+// Ogni quanti secondi la latenza misurata finisce nel log
+#define FRAME_LATENCY_REPORT_INTERVAL 5.0
+// Istogramma dei tempi di frame: bucket da 0.1 ms fino a 100 ms
+#define FRAME_HISTOGRAM_BUCKETS 1000
+#define FRAME_HISTOGRAM_STEP 0.0001
+
+// Ritmo dei frame al posto di SetTargetFPS: l'attesa (sleep + spin) avviene
+// prima di campionare l'input, non dopo, così l'input usato dal frame è il più
+// recente possibile. Misura anche la latenza input -> present: "early" è
+// l'input campionato prima della simulazione, "late" il mouse look
+// ricampionato subito prima del render.
+typedef struct FramePacer {
+    double targetFrameTime;   // 0: nessun limite (benchmark)
+    double deadline;
+    double earlyInputTime;
+    double lateInputTime;
+    double lastPresentTime;
+
+    // Finestra del report periodico
+    double windowStart;
+    int windowFrames;
+    double earlySum;
+    double lateSum;
+    double lateMax;
+    float earlyLatencyMs;     // medie dell'ultima finestra, per l'HUD
+    float lateLatencyMs;
+
+    // Totali della sessione (benchmark)
+    double sessionStart;
+    long long frames;
+    double lateTotal;
+    double worstFrameTime;
+    unsigned int histogram[FRAME_HISTOGRAM_BUCKETS];
+} FramePacer;
+
+void FramePacerInit(FramePacer *pacer, int targetFps);  // 0 = senza limite
+// Attende la scadenza del frame; subito dopo va campionato l'input
+void FramePacerWait(FramePacer *pacer);
+void FramePacerMarkInput(FramePacer *pacer);      // input per la simulazione
+void FramePacerMarkLateInput(FramePacer *pacer);  // mouse look prima del render
+// Dopo EndDrawing: registra latenza e tempo del frame
+void FramePacerPresented(FramePacer *pacer);
+double FramePacerElapsed(const FramePacer *pacer);
+void FramePacerLogSummary(const FramePacer *pacer);
+
+#endif
@@ -0,0 +1,179 @@
+#include "lineOfSight.h"
+#include "../world/firstWorld.h"
+#include <raymath.h>
+#include <float.h>
+#include <math.h>
+
+// Query valutate per frame: costo CPU fisso indipendente dal numero di sistemi
+#define LOS_QUERIES_PER_FRAME 16
+// Spostamento (m) di un estremo oltre il quale il risultato va ricalcolato
+#define LOS_MOVE_THRESHOLD 0.5f
+// Query non più inviate da questo numero di frame vengono scartate
+#define LOS_EXPIRE_FRAMES 120
+
+LineOfSight::LineOfSight() : m_frame(0) {}
+
+LineOfSight& LineOfSight::Get() {
+    static LineOfSight instance;
+    return instance;
+}
+
+uint64_t LineOfSight::MakeKey(LosOwner owner, int id) {
+    return ((uint64_t)owner << 32) | (uint32_t)id;
+}
+
+void LineOfSight::Submit(LosOwner owner, int id, Vector3 from, Vector3 to) {
+    uint64_t key = MakeKey(owner, id);
+    auto found = m_index.find(key);
+
+    if (found == m_index.end()) {
+        Entry e = {};
+        e.key = key;
+        e.from = from;
+        e.to = to;
+        e.lastSubmitFrame = m_frame;
+        e.evaluated = false;
+        e.stale = true;
+        e.visible = false;
+        m_index[key] = m_entries.size();
+        m_entries.push_back(e);
+        return;
+    }
+
+    Entry& e = m_entries[found->second];
+    e.from = from;
+    e.to = to;
+    e.lastSubmitFrame = m_frame;
+
+    if (Vector3Distance(from, e.evaluatedFrom) > LOS_MOVE_THRESHOLD ||
+        Vector3Distance(to, e.evaluatedTo) > LOS_MOVE_THRESHOLD) {
+        e.stale = true;
+    }
+}
+
+void LineOfSight::SubmitBatch(LosOwner owner, const LosRequest* requests, int count) {
+    for (int i = 0; i < count; i++) {
+        Submit(owner, requests[i].id, requests[i].from, requests[i].to);
+    }
+}
+
+bool LineOfSight::IsVisible(LosOwner owner, int id, bool fallback) const {
+    auto found = m_index.find(MakeKey(owner, id));
+    if (found == m_index.end()) return fallback;
+
+    const Entry& e = m_entries[found->second];
+    return e.evaluated ? e.visible : fallback;
+}
+
+int LineOfSight::GetPendingCount() const {
+    int count = 0;
+    for (const Entry& e : m_entries) {
+        if (e.stale) count++;
+    }
+    return count;
+}
+
+void LineOfSight::Clear() {
+    m_entries.clear();
+    m_index.clear();
+}
+
+void LineOfSight::RemoveAt(size_t index) {
+    m_index.erase(m_entries[index].key);
+    if (index != m_entries.size() - 1) {
+        m_entries[index] = m_entries.back();
+        m_index[m_entries[index].key] = index;
+    }
+    m_entries.pop_back();
+}
+
+// Altezza della faccia superiore della colonna; -FLT_MAX se il chunk non esiste
+static float GetColumnTop(World* world, int x, int z, Chunk** cache) {
+    int cx = (int)floorf((float)x / CHUNK_SIZE);
+    int cz = (int)floorf((float)z / CHUNK_SIZE);
+
+    Chunk* chunk = *cache;
+    if (!chunk || chunk->chunkX != cx || chunk->chunkZ != cz) {
+        chunk = WorldFindChunk(world, cx, cz);
+        *cache = chunk;
+    }
+    if (!chunk || !chunk->generated) return -FLT_MAX;
+
+    return chunk->heightMap[x - cx * CHUNK_SIZE][z - cz * CHUNK_SIZE] + 1.0f;
+}
+
+// Cammina le colonne attraversate dal segmento (DDA 2D) e confronta la quota
+// minima del segmento in ogni colonna con la cima del terreno
+static bool IsSegmentClear(World* world, Vector3 from, Vector3 to) {
+    Vector3 d = Vector3Subtract(to, from);
+
+    int x = (int)floorf(from.x);
+    int z = (int)floorf(from.z);
+    int endX = (int)floorf(to.x);
+    int endZ = (int)floorf(to.z);
+
+    int stepX = (d.x > 0.0f) ? 1 : ((d.x < 0.0f) ? -1 : 0);
+    int stepZ = (d.z > 0.0f) ? 1 : ((d.z < 0.0f) ? -1 : 0);
+    float tDeltaX = stepX ? fabsf(1.0f / d.x) : FLT_MAX;
+    float tDeltaZ = stepZ ? fabsf(1.0f / d.z) : FLT_MAX;
+    float tMaxX = stepX ? (((stepX > 0) ? (x + 1 - from.x) : (from.x - x)) * tDeltaX) : FLT_MAX;
+    float tMaxZ = stepZ ? (((stepZ > 0) ? (z + 1 - from.z) : (from.z - z)) * tDeltaZ) : FLT_MAX;
+
+    Chunk* cache = NULL;
+    float tEnter = 0.0f;
+
+    while (true) {
+        float tExit = fminf(fminf(tMaxX, tMaxZ), 1.0f);
+        float yMin = from.y + d.y * ((d.y < 0.0f) ? tExit : tEnter);
+
+        if (yMin < GetColumnTop(world, x, z, &cache)) return false;
+        if ((x == endX && z == endZ) || tExit >= 1.0f) return true;
+
+        if (tMaxX < tMaxZ) {
+            x += stepX;
+            tEnter = tMaxX;
+            tMaxX += tDeltaX;
+        } else {
+            z += stepZ;
+            tEnter = tMaxZ;
+            tMaxZ += tDeltaZ;
+        }
+    }
+}
+
+void LineOfSight::Process(World* world) {
+    m_frame++;
+
+    // Scarta le query abbandonate (watcher rimossi, monumenti lontani)
+    for (size_t i = 0; i < m_entries.size(); ) {
+        if (m_frame - m_entries[i].lastSubmitFrame > LOS_EXPIRE_FRAMES) {
+            RemoveAt(i);
+        } else {
+            if (m_entries[i].evaluated && m_entries[i].evaluatedVersion != world->terrainVersion) {
+                m_entries[i].stale = true;
+            }
+            i++;
+        }
+    }
+
+    // Le query in attesa da più tempo vengono valutate per prime
+    for (int n = 0; n < LOS_QUERIES_PER_FRAME; n++) {
+        Entry* oldest = NULL;
+        for (Entry& e : m_entries) {
+            if (!e.stale) continue;
+            if (!oldest || !e.evaluated || (oldest->evaluated && e.lastEvalFrame < oldest->lastEvalFrame)) {
+                oldest = &e;
+                if (!e.evaluated) break;
+            }
+        }
+        if (!oldest) break;
+
+        oldest->visible = IsSegmentClear(world, oldest->from, oldest->to);
+        oldest->evaluatedFrom = oldest->from;
+        oldest->evaluatedTo = oldest->to;
+        oldest->evaluatedVersion = world->terrainVersion;
+        oldest->lastEvalFrame = m_frame;
+        oldest->evaluated = true;
+        oldest->stale = false;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "raylib.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+struct World;
+
+// Sistemi che inviano query di visibilità (la chiave è owner + id)
+enum class LosOwner : uint32_t {
+    WATCHER = 1,
+    MONUMENT,
+    DECORATION
+};
+
+struct LosRequest {
+    int id;
+    Vector3 from;
+    Vector3 to;
+};
+
+// Servizio di linea di vista contro la heightfield del terreno.
+// I sistemi inviano le query ogni frame; Process ne valuta al massimo
+// LOS_QUERIES_PER_FRAME (le più vecchie prima) e i risultati restano validi
+// finché gli estremi non si spostano o il terreno non cambia.
+class LineOfSight {
+public:
+    static LineOfSight& Get();
+
+    void SubmitBatch(LosOwner owner, const LosRequest* requests, int count);
+    void Submit(LosOwner owner, int id, Vector3 from, Vector3 to);
+
+    // Ultimo risultato noto; fallback se la query non è ancora stata valutata
+    bool IsVisible(LosOwner owner, int id, bool fallback) const;
+
+    // Da chiamare una volta per frame, dopo gli Update dei sistemi
+    void Process(World* world);
+    // Cambio dimensione: tutte le query decadono
+    void Clear();
+
+    int GetPendingCount() const;
+
+private:
+    LineOfSight();
+    LineOfSight(const LineOfSight&) = delete;
+    LineOfSight& operator=(const LineOfSight&) = delete;
+
+    struct Entry {
+        uint64_t key;
+        Vector3 from;
+        Vector3 to;
+        Vector3 evaluatedFrom;
+        Vector3 evaluatedTo;
+        unsigned int evaluatedVersion;
+        unsigned int lastSubmitFrame;
+        unsigned int lastEvalFrame;
+        bool evaluated;
+        bool stale;
+        bool visible;
+    };
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<uint64_t, size_t> m_index;
+    unsigned int m_frame;
+
+    static uint64_t MakeKey(LosOwner owner, int id);
+    void RemoveAt(size_t index);
+};
@@ -1,6 +1,11 @@
 #include "player.h"
+#include "../world/decorations.h"
+#include "simulation.h"
 #include <raylib.h>
 #include <raymath.h>
+#include <float.h>
+#include <math.h>
+#include <vector>
 
 // Funzione helper per ottenere l’altezza dell’acqua + terreno
 static float GetWaterHeight(World* world, Vector3 pos)
@@ -19,51 +24,226 @@ static float GetWaterHeight(World* world, Vector3 pos)
         }
     }
 
-    if (!c || !c->generated) return terrainH; // nessuna acqua
+    if (!c || !c->generated) return -FLT_MAX; // nessuna acqua
 
     int lx = (int)(pos.x - chunkX * CHUNK_SIZE);
     int lz = (int)(pos.z - chunkZ * CHUNK_SIZE);
 
-    if (lx < 0 || lx >= CHUNK_SIZE || lz < 0 || lz >= CHUNK_SIZE) return terrainH;
+    if (lx < 0 || lx >= CHUNK_SIZE || lz < 0 || lz >= CHUNK_SIZE) return -FLT_MAX;
+
+    // Colonna senza liquido: nessuna superficie d'acqua
+    if (c->liquidMap[lx][lz] <= 0.0f) return -FLT_MAX;
 
     float waterHeight = terrainH + c->liquidMap[lx][lz];
     return waterHeight;
 }
 
 
-void UpdatePlayerPhysics(PlayerSystem* ps, World* world, float deltaTime)
+// ================= SWEPT AABB =================
+
+static float GetAxis(Vector3 v, int axis)
+{
+    return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+static void AddAxis(Vector3* v, int axis, float amount)
+{
+    if (axis == 0) v->x += amount;
+    else if (axis == 1) v->y += amount;
+    else v->z += amount;
+}
+
+static BoundingBox GetPlayerBox(Vector3 eye)
+{
+    BoundingBox box;
+    box.min = (Vector3){eye.x - PLAYER_HALF_WIDTH, eye.y - PLAYER_EYE_HEIGHT, eye.z - PLAYER_HALF_WIDTH};
+    box.max = (Vector3){eye.x + PLAYER_HALF_WIDTH, eye.y + PLAYER_HEAD_CLEARANCE, eye.z + PLAYER_HALF_WIDTH};
+    return box;
+}
+
+// Raccoglie i collider nel volume spazzato dal movimento: solo le celle voxel
+// attraversate e le decorazioni delle celle vicine
+static void GatherColliders(World* world, DecorationSystem* decorations, BoundingBox area,
+                            std::vector<BoundingBox>& out)
+{
+    out.clear();
+
+    int minX = (int)floorf(area.min.x), maxX = (int)floorf(area.max.x);
+    int minY = (int)floorf(area.min.y), maxY = (int)floorf(area.max.y);
+    int minZ = (int)floorf(area.min.z), maxZ = (int)floorf(area.max.z);
+
+    Chunk* chunk = NULL;
+    for (int x = minX; x <= maxX; x++)
+    {
+        for (int z = minZ; z <= maxZ; z++)
+        {
+            int cx = (int)floorf((float)x / CHUNK_SIZE);
+            int cz = (int)floorf((float)z / CHUNK_SIZE);
+            if (!chunk || chunk->chunkX != cx || chunk->chunkZ != cz)
+                chunk = WorldFindChunk(world, cx, cz);
+
+            int lx = x - cx * CHUNK_SIZE;
+            int lz = z - cz * CHUNK_SIZE;
+
+            for (int y = minY; y <= maxY; y++)
+            {
+                // Sotto il mondo è tutto solido, sopra e nei chunk mancanti è aria
+                bool solid = (y < 0);
+                if (!solid && y < MAX_HEIGHT && chunk && chunk->generated)
+                    solid = chunk->voxels[VOXEL_INDEX(lx, y, lz)] != BLOCK_AIR;
+
+                if (solid)
+                {
+                    BoundingBox cell = {{(float)x, (float)y, (float)z}, {x + 1.0f, y + 1.0f, z + 1.0f}};
+                    out.push_back(cell);
+                }
+            }
+        }
+    }
+
+    if (decorations)
+        QueryDecorationColliders(decorations, area, out);
+}
+
+// Limita il movimento lungo un asse al primo collider incontrato
+static float ClipAxis(BoundingBox player, const std::vector<BoundingBox>& colliders, int axis, float motion)
+{
+    const float eps = 1e-4f;
+
+    for (const BoundingBox& b : colliders)
+    {
+        // Il collider deve sovrapporsi al giocatore sugli altri due assi
+        bool overlap = true;
+        for (int other = 0; other < 3; other++)
+        {
+            if (other == axis) continue;
+            if (GetAxis(b.max, other) <= GetAxis(player.min, other) + eps ||
+                GetAxis(b.min, other) >= GetAxis(player.max, other) - eps)
+            {
+                overlap = false;
+                break;
+            }
+        }
+        if (!overlap) continue;
+
+        if (motion > 0.0f && GetAxis(b.min, axis) >= GetAxis(player.max, axis) - eps)
+            motion = fminf(motion, GetAxis(b.min, axis) - GetAxis(player.max, axis));
+        else if (motion < 0.0f && GetAxis(b.max, axis) <= GetAxis(player.min, axis) + eps)
+            motion = fmaxf(motion, GetAxis(b.max, axis) - GetAxis(player.min, axis));
+    }
+
+    return motion;
+}
+
+// Sweep per assi separati (Y, X, Z): lo scivolamento lungo i muri viene
+// dal fatto che l'asse bloccato non cancella gli altri
+static Vector3 SweepBox(BoundingBox* box, Vector3 motion, const std::vector<BoundingBox>& colliders,
+                        bool clipped[3])
+{
+    const int order[3] = {1, 0, 2};
+    Vector3 applied = {0.0f, 0.0f, 0.0f};
+
+    for (int i = 0; i < 3; i++)
+    {
+        int axis = order[i];
+        float wanted = GetAxis(motion, axis);
+        float allowed = ClipAxis(*box, colliders, axis, wanted);
+
+        clipped[axis] = fabsf(allowed - wanted) > 1e-5f;
+        AddAxis(&box->min, axis, allowed);
+        AddAxis(&box->max, axis, allowed);
+        AddAxis(&applied, axis, allowed);
+    }
+
+    return applied;
+}
+
+void UpdatePlayerPhysics(PlayerSystem* ps, World* world, DecorationSystem* decorations,
+                         Vector3 previousPosition, float deltaTime)
 {
+    static std::vector<BoundingBox> colliders;
+
+    // Annulla lo spostamento di UpdatePlayerMovement: verrà rifatto con le collisioni
+    Vector3 inputMove = Vector3Subtract(ps->camera.position, previousPosition);
+    inputMove.y = 0.0f;
+    ps->camera.position = Vector3Subtract(ps->camera.position, inputMove);
+    ps->camera.target = Vector3Subtract(ps->camera.target, inputMove);
+
     // Gravità
     ps->velocity.y += ps->gravity * deltaTime;
 
-    Vector3 newPos = ps->camera.position;
-    newPos.y += ps->velocity.y * deltaTime;
+    Vector3 motion = {inputMove.x, ps->velocity.y * deltaTime, inputMove.z};
+    BoundingBox start = GetPlayerBox(ps->camera.position);
 
-    float terrainHeight = GetTerrainHeightAt(world, newPos.x, newPos.z);
-    float waterHeight = GetWaterHeight(world, newPos);
+    // Volume che copre il movimento e l'eventuale gradino
+    BoundingBox area = start;
+    area.min.x += fminf(motion.x, 0.0f) - 1.0f;
+    area.min.y += fminf(motion.y, 0.0f) - 1.0f;
+    area.min.z += fminf(motion.z, 0.0f) - 1.0f;
+    area.max.x += fmaxf(motion.x, 0.0f) + 1.0f;
+    area.max.y += fmaxf(motion.y, 0.0f) + PLAYER_STEP_HEIGHT + 1.0f;
+    area.max.z += fmaxf(motion.z, 0.0f) + 1.0f;
+    GatherColliders(world, decorations, area, colliders);
 
-    // Collisione con il terreno
-    if (newPos.y <= terrainHeight + 1.8f)
+    bool clipped[3];
+    BoundingBox box = start;
+    Vector3 moved = SweepBox(&box, motion, colliders, clipped);
+    bool landed = clipped[1] && motion.y < 0.0f;
+    bool hitCeiling = clipped[1] && motion.y > 0.0f;
+
+    // Step-up: bloccati in orizzontale mentre si è a terra, riprova un blocco più in alto
+    bool blockedHorizontally = clipped[0] || clipped[2];
+    if (blockedHorizontally && (ps->isGrounded || landed))
     {
-        newPos.y = terrainHeight + 1.8f;
-        ps->velocity.y = 0.0f;
-        ps->isGrounded = true;
+        bool stepClipped[3];
+        BoundingBox stepBox = start;
+        Vector3 up = SweepBox(&stepBox, (Vector3){0.0f, PLAYER_STEP_HEIGHT, 0.0f}, colliders, stepClipped);
+        Vector3 across = SweepBox(&stepBox, (Vector3){motion.x, 0.0f, motion.z}, colliders, stepClipped);
+        Vector3 down = SweepBox(&stepBox, (Vector3){0.0f, -up.y + fminf(motion.y, 0.0f), 0.0f}, colliders, stepClipped);
+
+        float plainDist = moved.x * moved.x + moved.z * moved.z;
+        float stepDist = across.x * across.x + across.z * across.z;
+        if (stepDist > plainDist + 1e-6f && stepClipped[1])
+        {
+            box = stepBox;
+            moved = Vector3Add(Vector3Add(up, across), down);
+            landed = true;
+            hitCeiling = false;
+        }
     }
-    else if (newPos.y <= waterHeight) // Se siamo nell’acqua
+
+    Vector3 newPos = Vector3Add(ps->camera.position, moved);
+
+    if (landed)
     {
-        newPos.y = waterHeight;
         ps->velocity.y = 0.0f;
-        ps->isGrounded = false;
-        ps->inWater = true;
+        ps->isGrounded = true;
+        ps->inWater = false;
     }
     else
     {
+        if (hitCeiling)
+            ps->velocity.y = 0.0f;
         ps->isGrounded = false;
-        ps->inWater = false;
+
+        // Se siamo nell'acqua si galleggia con gli occhi al pelo dell'acqua
+        float waterHeight = GetWaterHeight(world, newPos);
+        if (newPos.y <= waterHeight)
+        {
+            // Risale verso il pelo dell'acqua senza attraversare i blocchi
+            bool floatClipped[3];
+            newPos.y += SweepBox(&box, (Vector3){0.0f, waterHeight - newPos.y, 0.0f}, colliders, floatClipped).y;
+            ps->velocity.y = 0.0f;
+            ps->inWater = true;
+        }
+        else
+        {
+            ps->inWater = false;
+        }
     }
 
     // Salto
-    if (ps->isGrounded && IsKeyPressed(KEY_SPACE))
+    if (ps->isGrounded && SimIsKeyPressed(KEY_SPACE))
     {
         ps->velocity.y = 10.0f;
     }
@@ -71,11 +251,34 @@ void UpdatePlayerPhysics(PlayerSystem* ps, World* world, float deltaTime)
     // Nuoto se siamo in acqua
     if (ps->inWater && IsKeyDown(KEY_SPACE))
     {
-        ps->velocity.y = 5.0f; // spinta verso l’alto
+        ps->velocity.y = 5.0f; // spinta verso l'alto
     }
 
-    // Applica la nuova posizione
-    float deltaY = newPos.y - ps->camera.position.y;
-    ps->camera.position.y = newPos.y;
-    ps->camera.target.y += deltaY;
+    // Applica la nuova posizione (la direzione dello sguardo non cambia)
+    Vector3 delta = Vector3Subtract(newPos, ps->camera.position);
+    ps->camera.position = newPos;
+    ps->camera.target = Vector3Add(ps->camera.target, delta);
+}
+
+void UpdatePlayerLook(PlayerSystem* ps, Vector2 mouseDelta)
+{
+    Vector3 rotation = {
+        mouseDelta.x * PLAYER_MOUSE_SENSITIVITY * RAD2DEG,
+        mouseDelta.y * PLAYER_MOUSE_SENSITIVITY * RAD2DEG,
+        0.0f};
+    UpdateCameraPro(&ps->camera, (Vector3){0.0f, 0.0f, 0.0f}, rotation, 0.0f);
+}
+
+void UpdatePlayerMovement(PlayerSystem* ps, float deltaTime)
+{
+    // x = avanti, y = destra (nel piano del mondo, come la camera first person)
+    Vector3 movement = {0.0f, 0.0f, 0.0f};
+    float step = PLAYER_MOVE_SPEED * deltaTime;
+
+    if (IsKeyDown(KEY_W)) movement.x += step;
+    if (IsKeyDown(KEY_S)) movement.x -= step;
+    if (IsKeyDown(KEY_D)) movement.y += step;
+    if (IsKeyDown(KEY_A)) movement.y -= step;
+
+    UpdateCameraPro(&ps->camera, movement, (Vector3){0.0f, 0.0f, 0.0f}, 0.0f);
 }
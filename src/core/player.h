@@ -5,6 +5,18 @@
 #include "../world/firstWorld.h"      // ← CAMBIA QUI
 #include "../gameplay/mining.h"   // ← AGGIUNGI QUESTO
 
+// Box di collisione del giocatore rispetto agli occhi (camera.position)
+#define PLAYER_EYE_HEIGHT 1.8f
+#define PLAYER_HEAD_CLEARANCE 0.1f
+#define PLAYER_HALF_WIDTH 0.3f
+// Gradino superabile senza saltare (un blocco)
+#define PLAYER_STEP_HEIGHT 1.05f
+// Stessi valori della camera first person di raylib
+#define PLAYER_MOVE_SPEED 5.4f
+#define PLAYER_MOUSE_SENSITIVITY 0.003f
+
+struct DecorationSystem;
+
 typedef struct PlayerSystem {
     Camera3D camera;
     int cameraMode;
@@ -15,6 +27,14 @@ typedef struct PlayerSystem {
     MiningState mining;  // ← AGGIUNGI QUESTO CAMPO
 } PlayerSystem;
 
-void UpdatePlayerPhysics(PlayerSystem *ps, World *world, float deltaTime);
+// Rotazione della visuale dal mouse: una volta per frame, non per tick
+void UpdatePlayerLook(PlayerSystem *ps, Vector2 mouseDelta);
+// Movimento WASD nel piano orizzontale: una volta per tick di simulazione
+void UpdatePlayerMovement(PlayerSystem *ps, float deltaTime);
+
+// previousPosition: posizione prima di UpdatePlayerMovement. Lo spostamento orizzontale
+// dell'input viene rifatto come sweep dell'AABB contro voxel e decorazioni.
+void UpdatePlayerPhysics(PlayerSystem *ps, World *world, struct DecorationSystem *decorations,
+                         Vector3 previousPosition, float deltaTime);
 
 #endif
\ No newline at end of file
@@ -5,10 +5,11 @@
 #include "../world/blockTypes.h"    // Base types
 #include "../world/firstWorld.h"    // World struct
 #include "../world/dimensions.h"    // DimensionConfig & DimensionManager
+#include "entityStore.h"
 #include <vector>
 
+// Componente dei portali (posizione in EntityTransform)
 typedef struct Portal {
-    Vector3 position;
     float animationTime;
     float maxRadius;
     bool active;
@@ -24,7 +25,7 @@ typedef struct PortalGun {
 } PortalGun;
 
 typedef struct PortalSystem {
-    std::vector<Portal> portals;
+    std::vector<EntityHandle> portals;   // dal più vecchio al più recente
     PortalGun gun;
     int currentDimensionID;
     float portalCheckRadius;
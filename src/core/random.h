@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+
+// Identificatori dei sistemi che consumano numeri casuali: ogni sistema
+// ha il proprio stream, così l'ordine di generazione non cambia i risultati
+enum class RandomSystem : uint32_t {
+    DECORATIONS = 1,
+    ROCK_MESH,
+    CRYSTAL_MESH,
+    MONUMENTS,
+    WATCHERS
+};
+
+// PCG32 (O'Neill): 64 bit di stato, output 32 bit, stream indipendenti
+// selezionati dall'incremento. Nessuno stato globale: thread-safe per istanza.
+class RandomStream {
+public:
+    RandomStream() : m_state(0), m_inc(1) { Seed(0, 0); }
+    RandomStream(uint64_t seed, uint64_t stream) : m_state(0), m_inc(1) { Seed(seed, stream); }
+
+    // Stream derivato da (seed dimensione, coordinate chunk, sistema)
+    static RandomStream For(int worldSeed, RandomSystem system, int chunkX = 0, int chunkZ = 0) {
+        uint64_t key = Mix((uint64_t)(uint32_t)worldSeed);
+        key = Mix(key ^ (uint64_t)(uint32_t)chunkX);
+        key = Mix(key ^ ((uint64_t)(uint32_t)chunkZ << 32));
+        return RandomStream(key, Mix(key ^ (uint64_t)system));
+    }
+
+    void Seed(uint64_t seed, uint64_t stream) {
+        m_state = 0;
+        m_inc = (stream << 1) | 1u;
+        NextU32();
+        m_state += seed;
+        NextU32();
+    }
+
+    uint32_t NextU32() {
+        uint64_t old = m_state;
+        m_state = old * 6364136223846793005ULL + m_inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Intero in [0, n) senza bias (metodo di Lemire)
+    int NextInt(int n) {
+        if (n <= 0) return 0;
+        uint64_t m = (uint64_t)NextU32() * (uint32_t)n;
+        uint32_t low = (uint32_t)m;
+        if (low < (uint32_t)n) {
+            uint32_t threshold = (uint32_t)(-(uint32_t)n) % (uint32_t)n;
+            while (low < threshold) {
+                m = (uint64_t)NextU32() * (uint32_t)n;
+                low = (uint32_t)m;
+            }
+        }
+        return (int)(m >> 32);
+    }
+
+    // Float in [0, 1)
+    float NextFloat() {
+        return (NextU32() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float NextRange(float min, float max) {
+        return min + (max - min) * NextFloat();
+    }
+
+private:
+    uint64_t m_state;
+    uint64_t m_inc;
+
+    // splitmix64: disperde chiavi vicine (chunk adiacenti) su stati lontani
+    static uint64_t Mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+};
@@ -0,0 +1,75 @@
+#include "simulation.h"
+#include <string.h>
+
+#define SIM_MAX_KEYS 512
+#define SIM_MAX_MOUSE_BUTTONS (MOUSE_BUTTON_BACK + 1)
+
+static bool s_keyPressed[SIM_MAX_KEYS];
+static bool s_mousePressed[SIM_MAX_MOUSE_BUTTONS];
+static float s_wheelMove = 0.0f;
+
+void SimClockInit(SimClock *clock)
+{
+    clock->accumulator = 0.0;
+    clock->tick = 0;
+}
+
+int SimClockAdvance(SimClock *clock, float frameTime)
+{
+    if (frameTime > SIM_MAX_FRAME_TIME)
+        frameTime = SIM_MAX_FRAME_TIME;
+    if (frameTime < 0.0f)
+        frameTime = 0.0f;
+
+    clock->accumulator += frameTime;
+    int steps = (int)(clock->accumulator / SIM_DT);
+    clock->accumulator -= steps * (double)SIM_DT;
+    clock->tick += steps;
+    return steps;
+}
+
+float SimClockAlpha(const SimClock *clock)
+{
+    float alpha = (float)(clock->accumulator / SIM_DT);
+    return (alpha > 1.0f) ? 1.0f : alpha;
+}
+
+void SimInputLatch(void)
+{
+    // La coda dei tasti premuti contiene solo gli eventi del frame corrente
+    for (int key = GetKeyPressed(); key > 0; key = GetKeyPressed())
+    {
+        if (key < SIM_MAX_KEYS)
+            s_keyPressed[key] = true;
+    }
+
+    for (int button = 0; button < SIM_MAX_MOUSE_BUTTONS; button++)
+    {
+        if (IsMouseButtonPressed(button))
+            s_mousePressed[button] = true;
+    }
+
+    s_wheelMove += GetMouseWheelMove();
+}
+
+void SimInputConsume(void)
+{
+    memset(s_keyPressed, 0, sizeof(s_keyPressed));
+    memset(s_mousePressed, 0, sizeof(s_mousePressed));
+    s_wheelMove = 0.0f;
+}
+
+bool SimIsKeyPressed(int key)
+{
+    return key > 0 && key < SIM_MAX_KEYS && s_keyPressed[key];
+}
+
+bool SimIsMouseButtonPressed(int button)
+{
+    return button >= 0 && button < SIM_MAX_MOUSE_BUTTONS && s_mousePressed[button];
+}
+
+float SimGetMouseWheelMove(void)
+{
+    return s_wheelMove;
+}
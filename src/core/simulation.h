@@ -0,0 +1,34 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "raylib.h"
+
+// Passo fisso della simulazione: fisica, mining, oggetti, watcher e tensione
+// avanzano sempre di SIM_DT, indipendentemente dal frame rate del render
+#define SIM_TICK_RATE 60
+#define SIM_DT (1.0f / SIM_TICK_RATE)
+// Frame più lunghi vengono troncati: la simulazione rallenta invece di
+// inseguire il tempo reale con sempre più tick (spirale della morte)
+#define SIM_MAX_FRAME_TIME 0.25f
+
+typedef struct SimClock {
+    double accumulator;
+    unsigned long long tick;
+} SimClock;
+
+void SimClockInit(SimClock *clock);
+// Accumula il tempo del frame; ritorna quanti tick eseguire in questo frame
+int SimClockAdvance(SimClock *clock, float frameTime);
+// Frazione del tick successivo già trascorsa (0..1): peso dell'interpolazione
+float SimClockAlpha(const SimClock *clock);
+
+// Eventi "pressed" del frame trattenuti fino al primo tick che li consuma:
+// con più tick per frame non si ripetono, con zero tick non vanno persi.
+// Lo stato "down" (IsKeyDown, IsMouseButtonDown) si legge direttamente.
+void SimInputLatch(void);    // una volta per frame, prima dei tick
+void SimInputConsume(void);  // dopo ogni tick
+bool SimIsKeyPressed(int key);
+bool SimIsMouseButtonPressed(int button);
+float SimGetMouseWheelMove(void);
+
+#endif
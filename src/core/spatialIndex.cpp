@@ -0,0 +1,185 @@
+#include "spatialIndex.h"
+#include <raymath.h>
+#include <algorithm>
+#include <math.h>
+
+// Lato (m) delle celle: mezzo chunk, così una query di interazione tocca poche celle
+#define SPATIAL_CELL_SIZE 8.0f
+
+SpatialIndex::SpatialIndex() : m_maxRadius(0.0f), m_count(0) {}
+
+SpatialIndex& SpatialIndex::Get() {
+    static SpatialIndex instance;
+    return instance;
+}
+
+long long SpatialIndex::MakeKey(int cx, int cz) {
+    return ((long long)cx << 32) ^ (long long)(unsigned int)cz;
+}
+
+static int CellCoord(float v) {
+    return (int)floorf(v / SPATIAL_CELL_SIZE);
+}
+
+const SpatialIndex::Location* SpatialIndex::FindLocation(EntityHandle h) const {
+    if (h.index >= m_locations.size()) return nullptr;
+    const Location& loc = m_locations[h.index];
+    if (loc.cell < 0 || loc.generation != h.generation) return nullptr;
+    return &loc;
+}
+
+int SpatialIndex::FindCell(int cx, int cz) const {
+    auto found = m_cellIndex.find(MakeKey(cx, cz));
+    return (found == m_cellIndex.end()) ? -1 : found->second;
+}
+
+// Le celle non vengono mai liberate: restano pronte per le entità successive
+int SpatialIndex::GetCell(int cx, int cz) {
+    int cell = FindCell(cx, cz);
+    if (cell >= 0) return cell;
+
+    Cell c;
+    c.cx = cx;
+    c.cz = cz;
+    c.maxRadius = 0.0f;
+    m_cells.push_back(c);
+    cell = (int)m_cells.size() - 1;
+    m_cellIndex[MakeKey(cx, cz)] = cell;
+    return cell;
+}
+
+void SpatialIndex::AddToCell(int cell, const Entry& e) {
+    Cell& c = m_cells[cell];
+    if (e.handle.index >= m_locations.size()) m_locations.resize(e.handle.index + 1, {0, -1, -1});
+
+    m_locations[e.handle.index] = {e.handle.generation, cell, (int)c.entries.size()};
+    c.entries.push_back(e);
+    if (e.radius > c.maxRadius) c.maxRadius = e.radius;
+}
+
+void SpatialIndex::RemoveFromCell(int cell, int slot) {
+    Cell& c = m_cells[cell];
+    int last = (int)c.entries.size() - 1;
+
+    m_locations[c.entries[slot].handle.index].cell = -1;
+    if (slot != last) {
+        c.entries[slot] = c.entries[last];
+        m_locations[c.entries[slot].handle.index].slot = slot;
+    }
+    c.entries.pop_back();
+    if (c.entries.empty()) c.maxRadius = 0.0f;
+}
+
+void SpatialIndex::Insert(EntityHandle h, uint32_t category, Vector3 center, float radius) {
+    Remove(h);
+
+    Entry e = {h, category, center, radius};
+    AddToCell(GetCell(CellCoord(center.x), CellCoord(center.z)), e);
+    if (radius > m_maxRadius) m_maxRadius = radius;
+    m_count++;
+}
+
+void SpatialIndex::Move(EntityHandle h, Vector3 center) {
+    const Location* loc = FindLocation(h);
+    if (!loc) return;
+
+    int cell = loc->cell;
+    int slot = loc->slot;
+    int cx = CellCoord(center.x);
+    int cz = CellCoord(center.z);
+
+    // Caso comune: l'entità resta nella stessa cella
+    if (m_cells[cell].cx == cx && m_cells[cell].cz == cz) {
+        m_cells[cell].entries[slot].center = center;
+        return;
+    }
+
+    Entry e = m_cells[cell].entries[slot];
+    e.center = center;
+    RemoveFromCell(cell, slot);
+    AddToCell(GetCell(cx, cz), e);
+}
+
+void SpatialIndex::Remove(EntityHandle h) {
+    const Location* loc = FindLocation(h);
+    if (!loc) return;
+
+    RemoveFromCell(loc->cell, loc->slot);
+    m_count--;
+    if (m_count == 0) m_maxRadius = 0.0f;
+}
+
+template <typename F>
+void SpatialIndex::VisitCells(float minX, float maxX, float minZ, float maxZ, uint32_t categories, F fn) const {
+    if (m_count == 0) return;
+
+    // Un'entità sporge dalla sua cella al massimo di m_maxRadius
+    int minCX = CellCoord(minX - m_maxRadius);
+    int maxCX = CellCoord(maxX + m_maxRadius);
+    int minCZ = CellCoord(minZ - m_maxRadius);
+    int maxCZ = CellCoord(maxZ + m_maxRadius);
+
+    for (int cx = minCX; cx <= maxCX; cx++) {
+        for (int cz = minCZ; cz <= maxCZ; cz++) {
+            int cell = FindCell(cx, cz);
+            if (cell < 0) continue;
+
+            // Bordo "loose" della cella: scarta le celle che non raggiungono il rettangolo
+            const Cell& c = m_cells[cell];
+            float cellMinX = cx * SPATIAL_CELL_SIZE - c.maxRadius;
+            float cellMinZ = cz * SPATIAL_CELL_SIZE - c.maxRadius;
+            float cellMaxX = (cx + 1) * SPATIAL_CELL_SIZE + c.maxRadius;
+            float cellMaxZ = (cz + 1) * SPATIAL_CELL_SIZE + c.maxRadius;
+            if (cellMaxX < minX || cellMinX > maxX || cellMaxZ < minZ || cellMinZ > maxZ) continue;
+
+            for (const Entry& e : c.entries) {
+                if (e.category & categories) fn(e);
+            }
+        }
+    }
+}
+
+void SpatialIndex::QueryRadius(Vector3 center, float radius, uint32_t categories,
+                               std::vector<SpatialHit>& out) const {
+    VisitCells(center.x - radius, center.x + radius, center.z - radius, center.z + radius, categories,
+               [&](const Entry& e) {
+        float dist = Vector3Distance(center, e.center);
+        if (dist <= radius + e.radius) out.push_back({e.handle, e.category, dist});
+    });
+}
+
+void SpatialIndex::QueryBox(BoundingBox box, uint32_t categories, std::vector<SpatialHit>& out) const {
+    VisitCells(box.min.x, box.max.x, box.min.z, box.max.z, categories, [&](const Entry& e) {
+        // Distanza sfera-box: punto del box più vicino al centro
+        Vector3 closest = Vector3Clamp(e.center, box.min, box.max);
+        float dist = Vector3Distance(closest, e.center);
+        if (dist <= e.radius) out.push_back({e.handle, e.category, dist});
+    });
+}
+
+void SpatialIndex::QueryRay(Vector3 origin, Vector3 direction, float maxDistance, uint32_t categories,
+                            std::vector<SpatialHit>& out) const {
+    size_t first = out.size();
+    Vector3 end = Vector3Add(origin, Vector3Scale(direction, maxDistance));
+
+    VisitCells(fminf(origin.x, end.x), fmaxf(origin.x, end.x), fminf(origin.z, end.z), fmaxf(origin.z, end.z),
+               categories, [&](const Entry& e) {
+        // Raggio-sfera: t del punto più vicino al centro, poi ingresso
+        Vector3 toCenter = Vector3Subtract(e.center, origin);
+        float along = Vector3DotProduct(toCenter, direction);
+        float distSq = Vector3DotProduct(toCenter, toCenter) - along * along;
+        float radiusSq = e.radius * e.radius;
+        if (distSq > radiusSq) return;
+
+        float t = along - sqrtf(radiusSq - distSq);
+        if (t < 0.0f) {
+            // Origine dentro la sfera o sfera alle spalle
+            if (along + sqrtf(radiusSq - distSq) < 0.0f) return;
+            t = 0.0f;
+        }
+        if (t <= maxDistance) out.push_back({e.handle, e.category, t});
+    });
+
+    std::sort(out.begin() + first, out.end(),
+              [](const SpatialHit& a, const SpatialHit& b) { return a.distance < b.distance; });
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "raylib.h"
+#include "entityStore.h"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+// Tipi di entità registrabili: le query filtrano con una maschera di bit
+enum SpatialCategory : uint32_t {
+    SPATIAL_TREE     = 1u << 0,
+    SPATIAL_ROCK     = 1u << 1,
+    SPATIAL_CRYSTAL  = 1u << 2,
+    SPATIAL_MONUMENT = 1u << 3,
+    SPATIAL_PORTAL   = 1u << 4,
+    SPATIAL_ITEM     = 1u << 5,
+    SPATIAL_WATCHER  = 1u << 6,
+
+    SPATIAL_DECORATIONS = SPATIAL_TREE | SPATIAL_ROCK | SPATIAL_CRYSTAL
+};
+
+struct SpatialHit {
+    EntityHandle handle;
+    uint32_t category;
+    // QueryRadius: distanza dal centro; QueryRay: ingresso nella sfera
+    float distance;
+};
+
+// Griglia "loose" in XZ condivisa da tutte le entità del mondo. Ogni entità è
+// una sfera (centro + raggio) registrata solo nella cella del suo centro; le
+// query allargano la ricerca del raggio massimo presente, quindi il costo
+// dipende dalla densità locale e non dal numero totale di entità.
+// Le query restituiscono candidati a livello di sfera: il test preciso
+// (box, coni, distanze dalla base) resta al chiamante.
+// EntityStore::Destroy rimuove da sé le entità registrate.
+class SpatialIndex {
+public:
+    static SpatialIndex& Get();
+
+    // Registra (o aggiorna) un'entità
+    void Insert(EntityHandle h, uint32_t category, Vector3 center, float radius);
+    // Spostamento incrementale: cambia cella solo se il centro la lascia
+    void Move(EntityHandle h, Vector3 center);
+    void Remove(EntityHandle h);
+
+    void QueryRadius(Vector3 center, float radius, uint32_t categories, std::vector<SpatialHit>& out) const;
+    void QueryBox(BoundingBox box, uint32_t categories, std::vector<SpatialHit>& out) const;
+    // direction normalizzata; risultati ordinati per distanza crescente
+    void QueryRay(Vector3 origin, Vector3 direction, float maxDistance, uint32_t categories,
+                  std::vector<SpatialHit>& out) const;
+
+    int GetCount() const { return m_count; }
+
+private:
+    SpatialIndex();
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    struct Entry {
+        EntityHandle handle;
+        uint32_t category;
+        Vector3 center;
+        float radius;
+    };
+
+    struct Cell {
+        int cx, cz;
+        float maxRadius;  // raggio massimo delle entità della cella (bordo "loose")
+        std::vector<Entry> entries;
+    };
+
+    // Posizione di un'entità nell'indice, per indice dello slot dell'handle
+    struct Location {
+        uint32_t generation;
+        int cell;   // -1 = non registrata
+        int slot;
+    };
+
+    std::vector<Cell> m_cells;
+    std::unordered_map<long long, int> m_cellIndex;
+    std::vector<Location> m_locations;
+    float m_maxRadius;
+    int m_count;
+
+    static long long MakeKey(int cx, int cz);
+    const Location* FindLocation(EntityHandle h) const;
+    int GetCell(int cx, int cz);
+    int FindCell(int cx, int cz) const;
+    void AddToCell(int cell, const Entry& e);
+    void RemoveFromCell(int cell, int slot);
+
+    // fn(const Entry&) per ogni entità delle celle che possono toccare il rettangolo XZ
+    template <typename F>
+    void VisitCells(float minX, float maxX, float minZ, float maxZ, uint32_t categories, F fn) const;
+};
@@ -0,0 +1,61 @@
+#include "updateScheduler.h"
+#include <raymath.h>
+
+// Entro questa distanza (m) un'entità si aggiorna sempre a ogni tick
+#define UPDATE_NEAR_DISTANCE 32.0f
+// Oltre questa distanza scende alla fascia lontana; se è visibile, a ogni tick
+#define UPDATE_MID_DISTANCE 96.0f
+// Coseno del mezzo angolo del cono considerato visibile
+#define UPDATE_VIEW_COS 0.5f
+
+static const unsigned int TIER_PERIOD[UPDATE_TIER_COUNT] = {1, 4, 16};
+
+UpdateScheduler::UpdateScheduler()
+    : m_tick(0), m_nextPhase(0), m_eye({0, 0, 0}), m_forward({0, 0, 1}), m_updated{0, 0, 0} {}
+
+UpdateScheduler& UpdateScheduler::Get() {
+    static UpdateScheduler instance;
+    return instance;
+}
+
+void UpdateScheduler::BeginTick(Camera3D camera) {
+    m_tick++;
+    m_eye = camera.position;
+    m_forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    for (int& count : m_updated) count = 0;
+}
+
+UpdateSchedule UpdateScheduler::NewSchedule() {
+    UpdateSchedule schedule;
+    schedule.pendingDt = 0.0f;
+    schedule.phase = m_nextPhase++;
+    schedule.tier = UPDATE_TIER_NEAR;
+    return schedule;
+}
+
+UpdateTier UpdateScheduler::GetTier(Vector3 position) const {
+    Vector3 toEntity = Vector3Subtract(position, m_eye);
+    float distSq = Vector3DotProduct(toEntity, toEntity);
+    if (distSq < UPDATE_NEAR_DISTANCE * UPDATE_NEAR_DISTANCE) return UPDATE_TIER_NEAR;
+
+    // Confronto sul coseno senza normalizzare: dot > cos * |v|
+    bool inView = Vector3DotProduct(toEntity, m_forward) > UPDATE_VIEW_COS * sqrtf(distSq);
+    if (distSq < UPDATE_MID_DISTANCE * UPDATE_MID_DISTANCE) {
+        return inView ? UPDATE_TIER_NEAR : UPDATE_TIER_MID;
+    }
+    return inView ? UPDATE_TIER_MID : UPDATE_TIER_FAR;
+}
+
+float UpdateScheduler::Step(UpdateSchedule& schedule, Vector3 position, float dt) {
+    schedule.pendingDt += dt;
+    schedule.tier = GetTier(position);
+
+    // Un'entità che si avvicina recupera subito il dt accumulato
+    unsigned int period = TIER_PERIOD[schedule.tier];
+    if ((m_tick + schedule.phase) % period != 0) return 0.0f;
+
+    float stepDt = schedule.pendingDt;
+    schedule.pendingDt = 0.0f;
+    m_updated[schedule.tier]++;
+    return stepDt;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "raylib.h"
+#include <stdint.h>
+
+// Fasce di aggiornamento: ogni tick, ogni 4 tick, ogni 16 tick
+enum UpdateTier : uint8_t {
+    UPDATE_TIER_NEAR = 0,
+    UPDATE_TIER_MID,
+    UPDATE_TIER_FAR,
+    UPDATE_TIER_COUNT
+};
+
+// Componente delle entità aggiornate a frequenza variabile: il dt dei tick
+// saltati si accumula e viene consegnato tutto al tick successivo eseguito
+struct UpdateSchedule {
+    float pendingDt;
+    uint16_t phase;   // sfasamento: le entità della stessa fascia non scattano tutte insieme
+    uint8_t tier;
+};
+
+// Sceglie la fascia di ogni entità per distanza dal player e visibilità
+// (nel cono della camera resta vicina più a lungo), così il costo della
+// simulazione segue quello che c'è attorno al player.
+class UpdateScheduler {
+public:
+    static UpdateScheduler& Get();
+
+    // Da chiamare all'inizio di ogni tick di simulazione
+    void BeginTick(Camera3D camera);
+
+    // Nuovo componente, con fase assegnata a rotazione
+    UpdateSchedule NewSchedule();
+
+    // Accumula dt; restituisce il dt da simulare ora, 0 se l'entità salta questo tick
+    float Step(UpdateSchedule& schedule, Vector3 position, float dt);
+
+    // Entità eseguite nell'ultimo tick per fascia (debug)
+    int GetUpdatedCount(UpdateTier tier) const { return m_updated[tier]; }
+
+private:
+    UpdateScheduler();
+    UpdateScheduler(const UpdateScheduler&) = delete;
+    UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+
+    unsigned int m_tick;
+    uint16_t m_nextPhase;
+    Vector3 m_eye;
+    Vector3 m_forward;
+    int m_updated[UPDATE_TIER_COUNT];
+
+    UpdateTier GetTier(Vector3 position) const;
+};
@@ -2,10 +2,11 @@
 #include "item.h"
 #include "inventory.h"
 #include "../world/firstWorld.h"
+#include "../core/spatialIndex.h"
+#include "../core/updateScheduler.h"
+#include "../rendering/shaders.h"
 #include <cmath>
-
-// Sistema globale
-std::vector<DroppedItem> g_droppedItems;
+#include <vector>
 
 static Vector3 Vec3Add(Vector3 a, Vector3 b) {
     return { a.x + b.x, a.y + b.y, a.z + b.z };
@@ -32,75 +33,296 @@ static Vector3 Vec3Norm(Vector3 v) {
     return { v.x / len, v.y / len, v.z / len };
 }
 
+// Lato del cubo di un oggetto singolo; le pile crescono fino a 1.5x
+#define DROPPED_ITEM_SIZE 0.3f
+#define DROPPED_ITEM_LIFETIME 300.0f
+#define DROPPED_ITEM_MAGNET_RADIUS 2.0f
+#define DROPPED_ITEM_PICKUP_RADIUS 0.5f
+// Oggetti uguali che si addormentano entro questa distanza si uniscono
+#define DROPPED_ITEM_MERGE_RADIUS 1.0f
+// Velocità orizzontale sotto cui un oggetto a terra si addormenta
+#define DROPPED_ITEM_SLEEP_SPEED 0.05f
+
+#define ITEM_TYPE_COUNT ((int)ItemType::DIAMOND + 1)
+
+// Render instanziato: un cubo, un materiale, un batch di matrici per tipo
+static Mesh s_cubeMesh;
+static Material s_cubeMaterial;
+static bool s_rendererLoaded = false;
+static bool s_instanced = false;
+static std::vector<Matrix> s_batches[ITEM_TYPE_COUNT];
+
+static float GetStackSize(int count) {
+    return DROPPED_ITEM_SIZE * (1.0f + 0.5f * (count - 1) / (float)(MAX_STACK - 1));
+}
+
+void InitDroppedItems() {
+    s_cubeMesh = GenMeshCube(1.0f, 1.0f, 1.0f);
+    s_cubeMaterial = LoadMaterialDefault();
+
+    Shader shader = LoadCachedShader("assets/shaders/glsl330/item_instanced.vs",
+                                     "assets/shaders/glsl330/item_instanced.fs");
+    int instanceLoc = GetShaderLocationAttrib(shader, "instanceTransform");
+
+    if (shader.id > 0 && instanceLoc >= 0) {
+        shader.locs[SHADER_LOC_MATRIX_MVP] = GetCachedShaderLocation(shader, "mvp");
+        shader.locs[SHADER_LOC_MATRIX_MODEL] = instanceLoc;
+        s_cubeMaterial.shader = shader;
+        s_instanced = true;
+        TraceLog(LOG_INFO, "✓ Dropped items: instanced shader loaded (ID: %d)", shader.id);
+    } else {
+        s_instanced = false;
+        TraceLog(LOG_WARNING, "⚠️ Dropped items: instanced shader unavailable, drawing one cube per item");
+    }
+    s_rendererLoaded = true;
+}
+
 void SpawnDroppedItem(ItemType type, Vector3 position) {
+    EntityTransform transform;
+    transform.position = position;
+    transform.position.y += 0.5f;
+    transform.scale = GetStackSize(1);
+
+    EntityMotion motion;
+    motion.velocity = {0, 2.0f, 0};
+    motion.prevPosition = transform.position;
+
     DroppedItem item;
     item.type = type;
-    item.position = position;
-    item.position.y += 0.5f;
-    item.velocity = {0, 2.0f, 0};
+    item.count = 1;
     item.lifetime = 0;
-    item.rotation = 0;
-    g_droppedItems.push_back(item);
+    item.sleeping = false;
+
+    EntityHandle h = EntityStore::Get().Create(transform, motion, item, UpdateScheduler::Get().NewSchedule());
+    SpatialIndex::Get().Insert(h, SPATIAL_ITEM, transform.position, transform.scale);
+}
+
+// Un oggetto fuori dai chunk generati cade fino alla quota di ripiego:
+// non deve addormentarsi lì
+static bool IsOverGeneratedChunk(World* world, Vector3 position) {
+    Chunk* chunk = WorldFindChunk(world, (int)floorf(position.x / CHUNK_SIZE), (int)floorf(position.z / CHUNK_SIZE));
+    return chunk && chunk->generated;
+}
+
+// Unisce l'oggetto appena addormentato a una pila vicina dello stesso tipo;
+// true se l'oggetto va distrutto
+static bool MergeIntoStack(EntityHandle self, const DroppedItem& item, Vector3 position) {
+    static std::vector<SpatialHit> nearby;
+    nearby.clear();
+    SpatialIndex::Get().QueryRadius(position, DROPPED_ITEM_MERGE_RADIUS, SPATIAL_ITEM, nearby);
+
+    EntityStore& store = EntityStore::Get();
+    for (const SpatialHit& hit : nearby) {
+        if (hit.handle == self || hit.distance > DROPPED_ITEM_MERGE_RADIUS) continue;
+
+        DroppedItem* stack = store.Find<DroppedItem>(hit.handle);
+        if (!stack || !stack->sleeping || stack->type != item.type) continue;
+        if (stack->count + item.count > MAX_STACK || stack->lifetime > DROPPED_ITEM_LIFETIME) continue;
+
+        // La pila vive quanto il suo oggetto più recente
+        stack->count += item.count;
+        stack->lifetime = fminf(stack->lifetime, item.lifetime);
+
+        EntityTransform* transform = store.Find<EntityTransform>(hit.handle);
+        transform->scale = GetStackSize(stack->count);
+        SpatialIndex::Get().Insert(hit.handle, SPATIAL_ITEM, transform->position, transform->scale);
+        return true;
+    }
+    return false;
 }
 
 void UpdateDroppedItems(World* world, Inventory* inventory, Vector3 playerPos, float dt) {
-    for (size_t i = 0; i < g_droppedItems.size(); ) {
-        DroppedItem& item = g_droppedItems[i];
-        
-        item.lifetime += dt;
-        item.rotation += dt * 90.0f;
-        
-        // Gravità
-        item.velocity.y -= 9.8f * dt;
-        
-        // Movimento
-        item.position = Vec3Add(item.position, Vec3Scale(item.velocity, dt));
-        
-        // Collisione con terreno
-        float terrainHeight = GetTerrainHeightAt(world, item.position.x, item.position.z);
-        
-        if (item.position.y < terrainHeight) {
-            item.position.y = terrainHeight;
-            item.velocity.y = 0;
-            item.velocity.x *= 0.95f;
-            item.velocity.z *= 0.95f;
-        }
-        
-        // Magnete verso player
-        float dist = Vec3Dist(item.position, playerPos);
-        if (dist < 2.0f) {
-            Vector3 dir = Vec3Norm(Vec3Sub(playerPos, item.position));
-            item.position = Vec3Add(item.position, Vec3Scale(dir, dt * 5.0f));
+    // Le entità raccolte, unite o scadute vengono distrutte dopo il passaggio sui pool
+    static std::vector<EntityHandle> removed;
+    removed.clear();
+
+    // Oggetti lontani: fisica e scadenza ogni 4 o 16 tick, con il dt accumulato
+    UpdateScheduler& scheduler = UpdateScheduler::Get();
+    EntityStore::Get().ForEach<EntityTransform, EntityMotion, DroppedItem, UpdateSchedule>(
+        [&](int count, const EntityHandle* handles, EntityTransform* transforms, EntityMotion* motions, DroppedItem* items,
+            UpdateSchedule* schedules) {
+        for (int i = 0; i < count; i++) {
+            Vector3& position = transforms[i].position;
+            EntityMotion& motion = motions[i];
+            DroppedItem& item = items[i];
             
-            // RACCOLTA NELL'INVENTARIO
-            if (dist < 0.5f) {
-                if (inventory->AddItem(item.type, 1)) {
-                    TraceLog(LOG_INFO, "Picked up: %s", GetItemName(item.type));
-                    g_droppedItems.erase(g_droppedItems.begin() + i);
+            // Chi dorme conta solo la scadenza: niente scheduler né fisica
+            if (item.sleeping) {
+                item.lifetime += dt;
+                if (item.lifetime > DROPPED_ITEM_LIFETIME) removed.push_back(handles[i]);
+                continue;
+            }
+            
+            // Nei tick saltati resta fermo anche per l'interpolazione del render
+            motion.prevPosition = position;
+            float stepDt = scheduler.Step(schedules[i], position, dt);
+            if (stepDt <= 0.0f) continue;
+            
+            item.lifetime += stepDt;
+            
+            // Rimuovi dopo 5 minuti
+            if (item.lifetime > DROPPED_ITEM_LIFETIME) {
+                removed.push_back(handles[i]);
+                continue;
+            }
+            
+            // Gravità
+            motion.velocity.y -= 9.8f * stepDt;
+            
+            // Movimento
+            position = Vec3Add(position, Vec3Scale(motion.velocity, stepDt));
+            
+            // Collisione con terreno
+            float terrainHeight = GetTerrainHeightAt(world, position.x, position.z);
+            bool grounded = false;
+            
+            if (position.y < terrainHeight) {
+                position.y = terrainHeight;
+                motion.velocity.y = 0;
+                motion.velocity.x *= 0.95f;
+                motion.velocity.z *= 0.95f;
+                grounded = true;
+            }
+            
+            // Fermo a terra: si addormenta (ed eventualmente entra in una pila)
+            if (grounded && fabsf(motion.velocity.x) < DROPPED_ITEM_SLEEP_SPEED &&
+                fabsf(motion.velocity.z) < DROPPED_ITEM_SLEEP_SPEED && IsOverGeneratedChunk(world, position)) {
+                if (MergeIntoStack(handles[i], item, position)) {
+                    // Resta nell'indice fino alla distruzione: vuoto, il magnete non lo raccoglie
+                    item.count = 0;
+                    removed.push_back(handles[i]);
                     continue;
-                } else {
-                    TraceLog(LOG_WARNING, "Inventory full!");
                 }
+                motion.velocity = {0, 0, 0};
+                motion.prevPosition = position;
+                item.sleeping = true;
             }
+            SpatialIndex::Get().Move(handles[i], position);
         }
+    });
+
+    // Magnete verso player: solo gli oggetti vicini, dall'indice spaziale
+    static std::vector<SpatialHit> nearby;
+    nearby.clear();
+    SpatialIndex::Get().QueryRadius(playerPos, DROPPED_ITEM_MAGNET_RADIUS, SPATIAL_ITEM, nearby);
+
+    EntityStore& store = EntityStore::Get();
+    for (const SpatialHit& hit : nearby) {
+        EntityTransform* transform = store.Find<EntityTransform>(hit.handle);
+        DroppedItem* item = store.Find<DroppedItem>(hit.handle);
+        // Scaduti o già uniti a una pila in questo tick: vengono distrutti sotto
+        if (!transform || !item || item->count <= 0 || item->lifetime > DROPPED_ITEM_LIFETIME) continue;
+
+        Vector3& position = transform->position;
+        float dist = Vec3Dist(position, playerPos);
+        if (dist >= DROPPED_ITEM_MAGNET_RADIUS) continue;
+
+        // Attirato dal player: torna nella simulazione
+        item->sleeping = false;
+        Vector3 dir = Vec3Norm(Vec3Sub(playerPos, position));
+        position = Vec3Add(position, Vec3Scale(dir, dt * 5.0f));
+        SpatialIndex::Get().Move(hit.handle, position);
         
-        // Rimuovi dopo 5 minuti
-        if (item.lifetime > 300.0f) {
-            g_droppedItems.erase(g_droppedItems.begin() + i);
-            continue;
+        // RACCOLTA NELL'INVENTARIO (una pila può entrare solo in parte)
+        if (dist < DROPPED_ITEM_PICKUP_RADIUS) {
+            int picked = 0;
+            while (item->count > 0 && inventory->AddItem(item->type, 1)) {
+                item->count--;
+                picked++;
+            }
+            if (picked > 0) {
+                TraceLog(LOG_INFO, "Picked up: %s x%d", GetItemName(item->type), picked);
+            }
+            
+            if (item->count == 0) {
+                removed.push_back(hit.handle);
+            } else {
+                TraceLog(LOG_WARNING, "Inventory full!");
+                transform->scale = GetStackSize(item->count);
+            }
         }
-        
-        i++;
+    }
+
+    for (EntityHandle h : removed) {
+        EntityStore::Get().Destroy(h);
     }
 }
 
-void DrawDroppedItems() {
-    for (const DroppedItem& item : g_droppedItems) {
-        DrawCube(item.position, 0.3f, 0.3f, 0.3f, GetItemColor(item.type));
-        DrawCubeWires(item.position, 0.3f, 0.3f, 0.3f, BLACK);
+void WakeDroppedItems(Vector3 center, float radius) {
+    static std::vector<SpatialHit> nearby;
+    nearby.clear();
+    SpatialIndex::Get().QueryRadius(center, radius, SPATIAL_ITEM, nearby);
+
+    for (const SpatialHit& hit : nearby) {
+        DroppedItem* item = EntityStore::Get().Find<DroppedItem>(hit.handle);
+        if (item) item->sleeping = false;
     }
 }
 
+void WakeAllDroppedItems() {
+    EntityStore::Get().ForEach<DroppedItem>([](int count, const EntityHandle*, DroppedItem* items) {
+        for (int i = 0; i < count; i++) items[i].sleeping = false;
+    });
+}
+
+void DrawDroppedItems(float alpha) {
+    // Senza shader instanziato: un cubo (e i suoi bordi) per oggetto
+    if (!s_instanced) {
+        EntityStore::Get().ForEach<EntityTransform, EntityMotion, DroppedItem>(
+            [&](int count, const EntityHandle*, EntityTransform* transforms, EntityMotion* motions, DroppedItem* items) {
+            for (int i = 0; i < count; i++) {
+                Vector3 prev = motions[i].prevPosition;
+                Vector3 position = Vec3Add(prev, Vec3Scale(Vec3Sub(transforms[i].position, prev), alpha));
+                float size = transforms[i].scale;
+                DrawCube(position, size, size, size, GetItemColor(items[i].type));
+                DrawCubeWires(position, size, size, size, BLACK);
+            }
+        });
+        return;
+    }
+
+    for (std::vector<Matrix>& batch : s_batches) batch.clear();
+
+    EntityStore::Get().ForEach<EntityTransform, EntityMotion, DroppedItem>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, EntityMotion* motions, DroppedItem* items) {
+        for (int i = 0; i < count; i++) {
+            Vector3 prev = motions[i].prevPosition;
+            Vector3 position = Vec3Add(prev, Vec3Scale(Vec3Sub(transforms[i].position, prev), alpha));
+            float size = transforms[i].scale;
+
+            // Scala e traslazione scritte direttamente nella matrice (colonne di raylib)
+            Matrix m = {};
+            m.m0 = size;
+            m.m5 = size;
+            m.m10 = size;
+            m.m12 = position.x;
+            m.m13 = position.y;
+            m.m14 = position.z;
+            m.m15 = 1.0f;
+            s_batches[(int)items[i].type].push_back(m);
+        }
+    });
+
+    // Una draw call per tipo: il colore è quello del materiale
+    for (int t = 0; t < ITEM_TYPE_COUNT; t++) {
+        if (s_batches[t].empty()) continue;
+        s_cubeMaterial.maps[MATERIAL_MAP_DIFFUSE].color = GetItemColor((ItemType)t);
+        DrawMeshInstanced(s_cubeMesh, s_cubeMaterial, s_batches[t].data(), (int)s_batches[t].size());
+    }
+}
+
+int GetDroppedItemCount() {
+    return EntityStore::Get().Count<DroppedItem>();
+}
+
 void CleanupDroppedItems() {
-    g_droppedItems.clear();
-}
\ No newline at end of file
+    EntityStore::Get().DestroyAll<DroppedItem>();
+
+    if (s_rendererLoaded) {
+        UnloadMesh(s_cubeMesh);
+        DetachMaterialShader(&s_cubeMaterial);
+        UnloadMaterial(s_cubeMaterial);
+        s_rendererLoaded = false;
+        s_instanced = false;
+    }
+}
@@ -3,27 +3,33 @@
 
 #include "raylib.h"
 #include "item.h"
-#include <vector>
+#include "../core/entityStore.h"
 
 // Forward declarations
 struct World;
 struct Inventory;
 
+// Componente degli oggetti a terra (posizione in EntityTransform,
+// velocità e posizione precedente in EntityMotion). Un oggetto fermo a terra
+// dorme: niente fisica finché il terreno sotto non cambia o il player non
+// si avvicina. Oggetti uguali che si addormentano vicini diventano una pila.
 struct DroppedItem {
     ItemType type;
-    Vector3 position;
-    Vector3 velocity;
+    int count;
     float lifetime;
-    float rotation;
+    bool sleeping;
 };
 
-// Sistema globale
-extern std::vector<DroppedItem> g_droppedItems;
-
 // Funzioni
+// Mesh e shader instanziato: richiede il contesto GL
+void InitDroppedItems();
 void SpawnDroppedItem(ItemType type, Vector3 position);
 void UpdateDroppedItems(World* world, Inventory* inventory, Vector3 playerPos, float dt);
-void DrawDroppedItems();
+// Da chiamare quando il terreno cambia sotto oggetti che dormono
+void WakeDroppedItems(Vector3 center, float radius);
+void WakeAllDroppedItems();
+void DrawDroppedItems(float alpha = 1.0f);
+int GetDroppedItemCount();
 void CleanupDroppedItems();
 
-#endif
\ No newline at end of file
+#endif
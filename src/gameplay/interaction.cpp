@@ -0,0 +1,61 @@
+#include "interaction.h"
+#include "raymath.h"
+#include "../world/decorations.h"
+#include "../core/spatialIndex.h"
+#include <vector>
+
+// Entità che il mirino può indicare (le decorazioni hanno il test preciso a parte)
+#define INTERACTION_ENTITIES (SPATIAL_MONUMENT | SPATIAL_PORTAL | SPATIAL_ITEM | SPATIAL_WATCHER)
+
+// Voxel d'aria davanti alla faccia colpita, se ci sta un blocco
+static bool ResolvePlacePos(const VoxelHit& hit, Camera3D cam, Vector3& placePos) {
+    if (!hit.hit || hit.distance > PLACE_REACH) return false;
+    if (hit.normalX == 0 && hit.normalY == 0 && hit.normalZ == 0) return false;
+
+    placePos.x = (float)(hit.x + hit.normalX);
+    placePos.y = (float)(hit.y + hit.normalY);
+    placePos.z = (float)(hit.z + hit.normalZ);
+
+    if (placePos.y < 1.0f || placePos.y >= MAX_HEIGHT) {
+        return false;
+    }
+
+    // Non piazzare dentro il giocatore (occhi a 1.8 sopra i piedi)
+    BoundingBox playerBox = {
+        {cam.position.x - 0.3f, cam.position.y - 1.8f, cam.position.z - 0.3f},
+        {cam.position.x + 0.3f, cam.position.y + 0.1f, cam.position.z + 0.3f}
+    };
+    BoundingBox blockBox = {
+        placePos,
+        {placePos.x + 1.0f, placePos.y + 1.0f, placePos.z + 1.0f}
+    };
+    return !CheckCollisionBoxes(playerBox, blockBox);
+}
+
+void UpdateInteractionQuery(InteractionQuery* query, Camera3D cam, World* world) {
+    Vector3 dir = Vector3Normalize(Vector3Subtract(cam.target, cam.position));
+    query->ray = (Ray){ cam.position, dir };
+
+    // Terreno: un solo attraversamento fino alla portata massima
+    query->voxel = RaycastVoxels(world, cam.position, dir, MINE_REACH);
+    query->canPlace = ResolvePlacePos(query->voxel, cam, query->placePos);
+
+    // Decorazioni ed entità contano solo se il terreno non le copre
+    float reach = query->voxel.hit ? query->voxel.distance : MINE_REACH;
+
+    query->decoration = RaycastDecorations(query->ray, reach, &query->decorationCategory,
+                                           &query->decorationDistance);
+
+    static std::vector<SpatialHit> candidates;
+    candidates.clear();
+    SpatialIndex::Get().QueryRay(cam.position, dir, reach, INTERACTION_ENTITIES, candidates);
+
+    query->entity = NULL_ENTITY;
+    query->entityCategory = 0;
+    query->entityDistance = reach;
+    if (!candidates.empty()) {
+        query->entity = candidates[0].handle;
+        query->entityCategory = candidates[0].category;
+        query->entityDistance = candidates[0].distance;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef INTERACTION_H
+#define INTERACTION_H
+
+#include "raylib.h"
+#include "../world/voxelRaycast.h"
+#include "../core/entityStore.h"
+#include <stdint.h>
+
+// Portata del giocatore
+#define PLACE_REACH 5.0f
+#define MINE_REACH 10.0f
+
+// Cosa c'è sotto il mirino: calcolato una volta per tick e letto da mining,
+// piazzamento, evidenziazione delle decorazioni e HUD, così tutti vedono
+// lo stesso bersaglio
+typedef struct InteractionQuery {
+    Ray ray;
+
+    VoxelHit voxel;                 // blocco di terreno entro MINE_REACH
+
+    bool canPlace;                  // voxel d'aria davanti alla faccia, entro PLACE_REACH
+    Vector3 placePos;
+
+    // Albero o roccia più vicino, solo se davanti al terreno
+    EntityHandle decoration;
+    uint32_t decorationCategory;
+    float decorationDistance;
+
+    // Entità più vicina (sfera dell'indice spaziale), solo se davanti al terreno
+    EntityHandle entity;
+    uint32_t entityCategory;
+    float entityDistance;
+} InteractionQuery;
+
+void UpdateInteractionQuery(InteractionQuery* query, Camera3D cam, World* world);
+
+#endif
@@ -11,6 +11,7 @@ bool Inventory::AddItem(ItemType type, int amount) {
             int add = (amount > space) ? space : amount;
             slots[i].quantity += add;
             amount -= add;
+            version++;
             if (amount <= 0) return true;
         }
     }
@@ -20,6 +21,7 @@ bool Inventory::AddItem(ItemType type, int amount) {
         if (slots[i].type == ItemType::NONE) {
             slots[i].type = type;
             slots[i].quantity = amount;
+            version++;
             return true;
         }
     }
@@ -32,6 +34,7 @@ void Inventory::RemoveSelected(int amount) {
     if (slot.quantity <= 0) return;
     
     slot.quantity -= amount;
+    version++;
     if (slot.quantity <= 0) {
         slot.type = ItemType::NONE;
         slot.quantity = 0;
@@ -43,13 +46,15 @@ Item Inventory::GetSelected() {
 }
 
 void Inventory::SelectSlot(int index) {
-    if (index >= 0 && index < HOTBAR_SIZE)
+    if (index >= 0 && index < HOTBAR_SIZE && index != selectedSlot) {
         selectedSlot = index;
+        version++;
+    }
 }
 
 // ========== UI RENDERING ==========
 
-void Inventory::DrawHotbar() {
+void Inventory::DrawHotbar() const {
     int screenW = GetScreenWidth();
     int screenH = GetScreenHeight();
     
@@ -86,7 +91,7 @@ void Inventory::DrawHotbar() {
     }
 }
 
-void Inventory::DrawFullInventory() {
+void Inventory::DrawFullInventory() const {
     int screenW = GetScreenWidth();
     int screenH = GetScreenHeight();
     
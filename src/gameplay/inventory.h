@@ -10,6 +10,8 @@
 struct Inventory {
     Item slots[INVENTORY_SIZE];
     int selectedSlot = 0;
+    // Incrementato a ogni modifica di slot o selezione (l'HUD ridisegna solo allora)
+    unsigned int version = 0;
     
     // Gestione item
     bool AddItem(ItemType type, int amount);
@@ -18,8 +20,8 @@ struct Inventory {
     void SelectSlot(int index);
     
     // UI Rendering
-    void DrawHotbar();
-    void DrawFullInventory();
+    void DrawHotbar() const;
+    void DrawFullInventory() const;
 };
 
 #endif
\ No newline at end of file
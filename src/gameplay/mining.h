@@ -2,9 +2,7 @@
 #define MINING_H
 
 #include "raylib.h"
-
-// Forward declaration
-struct World;
+#include "interaction.h"
 
 struct MiningState {
     bool mining = false;
@@ -12,12 +10,6 @@ struct MiningState {
     Vector3 targetBlock = {0,0,0};
 };
 
-// Ritorna true se colpisce blocco
-bool RaycastBlock(Camera3D cam, World* world, Vector3& hitPos);
-
-// Aggiorna mining
-void UpdateMining(MiningState& mining, Camera3D cam, World* world, float dt);
-// Add this after RaycastBlock declaration in mining.h:
-
-bool RaycastPlaceBlock(Camera3D cam, World* world, Vector3& placePos);
-#endif
\ No newline at end of file
+// Aggiorna mining sul blocco indicato dalla query del mirino
+void UpdateMining(MiningState& mining, const InteractionQuery* query, float dt);
+#endif
@@ -1,13 +1,37 @@
 #include "screenEffects.h"
+#include "../rendering/shaders.h"
+#include "rlgl.h"
 #include <cmath>
 #include <stdlib.h>
 
-ScreenEffects::ScreenEffects() : 
-    m_shakeIntensity(0), 
+// Sotto queste soglie l'effetto non si vede: il passaggio viene saltato
+#define CHROMATIC_EPSILON 0.0005f
+#define VIGNETTE_EPSILON 0.01f
+#define SHAKE_EPSILON 0.05f
+
+ScreenEffects::ScreenEffects() :
+    m_targetBound(false),
+    m_sceneWidth(0),
+    m_sceneHeight(0),
+    m_aberrationLoc(-1),
+    m_vignetteLoc(-1),
+    m_shakeLoc(-1),
+    m_uvScaleLoc(-1),
+    m_chromaticAmount(0),
+    m_vignetteStrength(0),
+    m_shakeOffset({0, 0}),
+    m_sentAberration(-1),
+    m_sentVignette(-1),
+    m_sentShake({0, 0}),
+    m_sentUvScale({1, 1}),
+    m_shakeIntensity(0),
     m_shakeTime(0),
-    m_initialized(false),
     m_screenWidth(0),
-    m_screenHeight(0) {
+    m_screenHeight(0),
+    m_renderScale(1.0f),
+    m_halfResolution(false),
+    m_active(false),
+    m_initialized(false) {
 }
 
 ScreenEffects::~ScreenEffects() {
@@ -26,140 +50,154 @@ void ScreenEffects::Init(int screenWidth, int screenHeight) {
         TraceLog(LOG_WARNING, "ScreenEffects already initialized");
         return;
     }
-    
+
     m_screenWidth = screenWidth;
     m_screenHeight = screenHeight;
-    
-    m_screenTarget = LoadRenderTexture(screenWidth, screenHeight);
-    
-    #if defined(PLATFORM_DESKTOP)
-        #define GLSL_VERSION 330
-    #else
-        #define GLSL_VERSION 100
-    #endif
-    
-    if (FileExists(TextFormat("assets/shaders/glsl%i/chromatic.fs", GLSL_VERSION))) {
-        m_chromaticShader = LoadShader(
-            TextFormat("assets/shaders/glsl%i/base.vs", GLSL_VERSION),
-            TextFormat("assets/shaders/glsl%i/chromatic.fs", GLSL_VERSION)
-        );
-        TraceLog(LOG_INFO, "  ✓ Loaded chromatic aberration shader");
-    } else {
-        m_chromaticShader.id = 0;
-        TraceLog(LOG_WARNING, "  ✗ Chromatic shader not found - using default");
+
+    m_shader = LoadCachedShader("assets/shaders/glsl330/chromatic_vertex.vs",
+                                "assets/shaders/glsl330/screen_effects.fs");
+    if (m_shader.id == 0) {
+        TraceLog(LOG_WARNING, "✗ Screen effects shader not loaded: scene drawn without post-processing");
+        return;
     }
-    
+    m_shader.locs[SHADER_LOC_MATRIX_MVP] = GetCachedShaderLocation(m_shader, "mvp");
+    m_aberrationLoc = GetCachedShaderLocation(m_shader, "aberration");
+    m_vignetteLoc = GetCachedShaderLocation(m_shader, "vignette");
+    m_shakeLoc = GetCachedShaderLocation(m_shader, "shake");
+    m_uvScaleLoc = GetCachedShaderLocation(m_shader, "uvScale");
+    m_sentAberration = -1;
+    m_sentVignette = -1;
+    m_sentUvScale = {1, 1};
+    SetShaderValue(m_shader, m_uvScaleLoc, &m_sentUvScale, SHADER_UNIFORM_VEC2);
+
+    // Bilineare per l'upscale; a scala piena campiona i centri dei texel
+    m_sceneTarget = LoadRenderTexture(screenWidth, screenHeight);
+    SetTextureFilter(m_sceneTarget.texture, TEXTURE_FILTER_BILINEAR);
+
     m_initialized = true;
-    TraceLog(LOG_INFO, "✓ Screen Effects initialized (%dx%d)", screenWidth, screenHeight);
+    TraceLog(LOG_INFO, "✓ Screen Effects initialized (%dx%d, shader ID: %d)", screenWidth, screenHeight, m_shader.id);
 }
 
-void ScreenEffects::BeginEffects() {
-    if (!m_initialized) return;
-    BeginTextureMode(m_screenTarget);
-}
+void ScreenEffects::Update(float tension, float deltaTime) {
+    // ---------- ABERRAZIONE CROMATICA ----------
+    // La base entra con i primi 10 punti di tensione: a tensione zero niente effetti
+    m_chromaticAmount = 0.005f * fminf(tension / 10.0f, 1.0f);
 
-void ScreenEffects::EndEffects(float tension) {
-    if (!m_initialized) {
-        return;
-    }
-    
-    EndTextureMode();
-    
-    BeginDrawing();
-    
-    float chromaticAmount = 0.0f;
-    float vignetteStrength = 0.0f;
-    
-    if (tension > 30.0f) {
-        chromaticAmount = (tension - 30.0f) / 70.0f * 0.003f;
+    // Scala con la tensione
+    m_chromaticAmount += (tension / 100.0f) * 0.15f; // Max +0.15 a tension 100
+
+    // Pulsazione cardiaca (aumenta con tensione)
+    float heartbeatSpeed = 2.0f + (tension / 50.0f) * 4.0f; // 2Hz -> 6Hz
+    float heartbeat = sinf(GetTime() * heartbeatSpeed) * 0.5f + 0.5f;
+    m_chromaticAmount += heartbeat * (tension / 100.0f) * 0.08f;
+
+    // Glitch randomico ad alta tensione, con un colpo di shake
+    if (tension > 70.0f && (int)(GetTime() * 10.0f) % 10 == 0) { // 10% del tempo
+        m_chromaticAmount += 0.05f;
+        if (m_shakeIntensity < 2.0f) m_shakeIntensity = 2.0f;
     }
-    
+
+    // Cap massimo
+    if (m_chromaticAmount > 0.25f) m_chromaticAmount = 0.25f;
+
+    // ---------- VIGNETTA ----------
+    m_vignetteStrength = 0.0f;
     if (tension > 40.0f) {
-        vignetteStrength = (tension - 40.0f) / 60.0f * 0.6f;
-    }
-    
-    Vector2 shakeOffset = {0, 0};
-    if (m_shakeIntensity > 0) {
-        m_shakeTime += GetFrameTime() * 50.0f;
-        shakeOffset.x = sinf(m_shakeTime) * m_shakeIntensity;
-        shakeOffset.y = cosf(m_shakeTime * 1.3f) * m_shakeIntensity;
-        m_shakeIntensity *= 0.95f;
+        m_vignetteStrength = (tension - 40.0f) / 60.0f * 0.6f;
     }
-    
-    if (chromaticAmount > 0.001f && m_chromaticShader.id > 0) {
-        BeginShaderMode(m_chromaticShader);
-        int loc = GetShaderLocation(m_chromaticShader, "aberration");
-        SetShaderValue(m_chromaticShader, loc, &chromaticAmount, SHADER_UNIFORM_FLOAT);
+
+    // ---------- SHAKE (pixel, smorzato nel tempo) ----------
+    m_shakeOffset = {0, 0};
+    if (m_shakeIntensity > SHAKE_EPSILON) {
+        m_shakeTime += deltaTime * 50.0f;
+        m_shakeOffset.x = sinf(m_shakeTime) * m_shakeIntensity;
+        m_shakeOffset.y = cosf(m_shakeTime * 1.3f) * m_shakeIntensity;
+        m_shakeIntensity *= powf(0.95f, deltaTime * 60.0f);
+    } else {
+        m_shakeIntensity = 0.0f;
     }
-    
-    Rectangle source = {
-        0, 0,
-        (float)m_screenTarget.texture.width,
-        -(float)m_screenTarget.texture.height
-    };
-    
-    Rectangle dest = {
-        shakeOffset.x,
-        shakeOffset.y,
-        (float)m_screenWidth,
-        (float)m_screenHeight
+
+    m_active = m_initialized &&
+               (m_chromaticAmount > CHROMATIC_EPSILON ||
+                m_vignetteStrength > VIGNETTE_EPSILON ||
+                m_shakeIntensity > SHAKE_EPSILON);
+}
+
+void ScreenEffects::BeginScene() {
+    m_targetBound = false;
+    if (!m_initialized) return;
+
+    float scale = m_renderScale;
+    if (m_halfResolution && m_active) scale = fminf(scale, 0.5f);
+    m_sceneWidth = (int)(m_screenWidth * scale + 0.5f);
+    m_sceneHeight = (int)(m_screenHeight * scale + 0.5f);
+    bool scaled = m_sceneWidth < m_screenWidth || m_sceneHeight < m_screenHeight;
+    if (!m_active && !scaled) return;
+
+    m_targetBound = true;
+    BeginTextureMode(m_sceneTarget);
+    // Il viewport ridotto mantiene proiezioni e coordinate 2D a risoluzione piena
+    if (scaled) rlViewport(0, 0, m_sceneWidth, m_sceneHeight);
+}
+
+void ScreenEffects::EndScene() {
+    if (!m_targetBound) return;
+    EndTextureMode();
+
+    Vector2 uvScale = {
+        (float)m_sceneWidth / m_sceneTarget.texture.width,
+        (float)m_sceneHeight / m_sceneTarget.texture.height
     };
-    
-    DrawTexturePro(
-        m_screenTarget.texture,
-        source,
-        dest,
-        (Vector2){0, 0},
-        0.0f,
-        WHITE
-    );
-    
-    if (chromaticAmount > 0.001f && m_chromaticShader.id > 0) {
-        EndShaderMode();
-    }
-    
-    if (vignetteStrength > 0.05f) {
-        DrawVignette(vignetteStrength);
+    if (uvScale.x != m_sentUvScale.x || uvScale.y != m_sentUvScale.y) {
+        m_sentUvScale = uvScale;
+        SetShaderValue(m_shader, m_uvScaleLoc, &m_sentUvScale, SHADER_UNIFORM_VEC2);
     }
-    
-    EndDrawing();
-}
 
-void ScreenEffects::DrawVignette(float strength) {
-    int steps = 20;
-    for (int i = 0; i < steps; i++) {
-        float t = (float)i / steps;
-        float alpha = strength * (1.0f - t);
-        Color c = Fade(BLACK, alpha);
-        
-        float inset = t * m_screenWidth / 2;
-        
-        DrawRectangleLinesEx(
-            (Rectangle){
-                inset,
-                inset * (m_screenHeight / (float)m_screenWidth),
-                m_screenWidth - 2 * inset,
-                m_screenHeight - 2 * inset * (m_screenHeight / (float)m_screenWidth)
-            },
-            m_screenWidth * 0.05f,
-            c
-        );
+    // Uniform inviati solo quando cambiano
+    if (m_chromaticAmount != m_sentAberration) {
+        m_sentAberration = m_chromaticAmount;
+        SetShaderValue(m_shader, m_aberrationLoc, &m_sentAberration, SHADER_UNIFORM_FLOAT);
+    }
+    if (m_vignetteStrength != m_sentVignette) {
+        m_sentVignette = m_vignetteStrength;
+        SetShaderValue(m_shader, m_vignetteLoc, &m_sentVignette, SHADER_UNIFORM_FLOAT);
+    }
+    Vector2 shake = {m_shakeOffset.x / m_screenWidth, m_shakeOffset.y / m_screenHeight};
+    if (shake.x != m_sentShake.x || shake.y != m_sentShake.y) {
+        m_sentShake = shake;
+        SetShaderValue(m_shader, m_shakeLoc, &m_sentShake, SHADER_UNIFORM_VEC2);
     }
+
+    // Solo la regione renderizzata, che in GL parte dall'angolo in basso
+    Rectangle source = {0, 0, (float)m_sceneWidth, -(float)m_sceneHeight};
+    Rectangle dest = {0, 0, (float)m_screenWidth, (float)m_screenHeight};
+
+    BeginShaderMode(m_shader);
+    DrawTexturePro(m_sceneTarget.texture, source, dest, (Vector2){0, 0}, 0.0f, WHITE);
+    EndShaderMode();
+
+    m_targetBound = false;
 }
 
 void ScreenEffects::SetScreenShake(float intensity) {
     m_shakeIntensity = intensity;
 }
 
+void ScreenEffects::SetRenderScale(float scale) {
+    m_renderScale = fminf(fmaxf(scale, 0.25f), 1.0f);
+}
+
+void ScreenEffects::SetHalfResolution(bool enabled) {
+    m_halfResolution = enabled;
+}
+
 void ScreenEffects::Cleanup() {
     if (!m_initialized) return;
-    
-    UnloadRenderTexture(m_screenTarget);
-    
-    if (m_chromaticShader.id > 0) {
-        UnloadShader(m_chromaticShader);
-    }
-    
+
+    // Lo shader appartiene al registro
+    UnloadRenderTexture(m_sceneTarget);
+
     m_initialized = false;
+    m_active = false;
     TraceLog(LOG_INFO, "✓ Screen Effects cleaned up");
-}
\ No newline at end of file
+}
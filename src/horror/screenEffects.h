@@ -2,35 +2,67 @@
 
 #include "raylib.h"
 
+// Post-processing della scena: aberrazione cromatica, vignetta e shake in un
+// solo passaggio fragment, che riporta anche a schermo la scena renderizzata a
+// scala ridotta. Con gli effetti azzerati e la scala piena la scena viene
+// disegnata direttamente nel backbuffer, senza target offscreen.
 class ScreenEffects {
 public:
     static ScreenEffects& Get();
-    
+
     void Init(int screenWidth, int screenHeight);
-    void BeginEffects();
-    void EndEffects(float tension);
+    // Intensità degli effetti per il frame corrente
+    void Update(float tension, float deltaTime);
+    // Tra BeginDrawing ed EndDrawing, attorno al render della scena
+    void BeginScene();
+    void EndScene();
     void Cleanup();
-    
+
     void SetScreenShake(float intensity);
+    // Scala della risoluzione interna della scena (lato, 0..1]
+    void SetRenderScale(float scale);
+    // Con gli effetti attivi la scala non supera la metà
+    void SetHalfResolution(bool enabled);
+    float GetRenderScale() const { return m_renderScale; }
+    float GetChromaticAmount() const { return m_chromaticAmount; }
+    bool IsActive() const { return m_active; }
     bool IsInitialized() const { return m_initialized; }
 
 private:
     ScreenEffects();
     ~ScreenEffects();
-    
+
     ScreenEffects(const ScreenEffects&) = delete;
     ScreenEffects& operator=(const ScreenEffects&) = delete;
-    
-    RenderTexture2D m_screenTarget;
-    Shader m_chromaticShader;
-    
+
+    // A risoluzione piena; a scala ridotta la scena ne usa l'angolo in basso
+    RenderTexture2D m_sceneTarget;
+    bool m_targetBound;           // false se la scena va a schermo
+    int m_sceneWidth;
+    int m_sceneHeight;
+    Shader m_shader;
+    int m_aberrationLoc;
+    int m_vignetteLoc;
+    int m_shakeLoc;
+    int m_uvScaleLoc;
+
+    // Valori del frame e ultimi inviati allo shader
+    float m_chromaticAmount;
+    float m_vignetteStrength;
+    Vector2 m_shakeOffset;
+    float m_sentAberration;
+    float m_sentVignette;
+    Vector2 m_sentShake;
+    Vector2 m_sentUvScale;
+
     float m_shakeIntensity;
     float m_shakeTime;
-    
+
     int m_screenWidth;
     int m_screenHeight;
-    
+
+    float m_renderScale;
+    bool m_halfResolution;
+    bool m_active;
     bool m_initialized;
-    
-    void DrawVignette(float strength);
-};
\ No newline at end of file
+};
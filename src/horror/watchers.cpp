@@ -1,13 +1,21 @@
 #include "watchers.h"
 #include "../core/cosmicState.h"
+#include "../core/spatialIndex.h"
+#include "../core/flowField.h"
+#include "../core/updateScheduler.h"
+#include "../rendering/effects.h"
 #include <raymath.h>
 #include <cmath>
 #include <stdlib.h>
 
+// Quota (m) sopra il terreno a cui si tiene un watcher che insegue
+#define WATCHER_HOVER_HEIGHT 2.5f
+
 WatcherSystem::WatcherSystem() : 
     m_activeWatchers(0), 
     m_spawnTimer(0),
-    m_initialized(false) {
+    m_initialized(false),
+    m_nextId(0) {
 }
 
 WatcherSystem::~WatcherSystem() {
@@ -17,7 +25,7 @@ WatcherSystem::~WatcherSystem() {
 }
 
 void WatcherSystem::Init() {
-    m_watchers.clear();
+    EntityStore::Get().DestroyAll<Watcher>();
     m_activeWatchers = 0;
     m_spawnTimer = 0;
     
@@ -32,8 +40,9 @@ void WatcherSystem::Init() {
     bool modelLoaded = false;
     for (const char* path : watcherModelPaths) {
         if (FileExists(path)) {
-            m_watcherModel = LoadModel(path);
-            if (m_watcherModel.meshCount > 0) {
+            m_watcherHandle = AssetCache::Get().AcquireModel(path);
+            if (m_watcherHandle.IsValid()) {
+                m_watcherModel = *AssetCache::Get().GetModel(m_watcherHandle);
                 modelLoaded = true;
                 TraceLog(LOG_INFO, "✓ Watcher model loaded: %s", path);
                 break;
@@ -52,36 +61,55 @@ void WatcherSystem::Init() {
     TraceLog(LOG_INFO, "✓ Watcher System initialized");
 }
 
+void WatcherSystem::SetSeed(int seed) {
+    m_rng = RandomStream::For(seed, RandomSystem::WATCHERS);
+}
+
 void WatcherSystem::SpawnWatcher(Vector3 playerPos, float tension) {
+    EntityTransform transform;
+    EntityMotion motion;
     Watcher w;
-    w.id = m_watchers.size();
+    w.id = m_nextId++;
     
-    float angle = (rand() % 360) * DEG2RAD;
+    float angle = m_rng.NextInt(360) * DEG2RAD;
     float baseDistance = 35.0f;
     float variationDistance = 15.0f;
-    float distance = baseDistance + (rand() % (int)variationDistance);
+    float distance = baseDistance + m_rng.NextInt((int)variationDistance);
     
-    w.position = (Vector3){
+    transform.position = (Vector3){
         playerPos.x + cosf(angle) * distance,
         playerPos.y + 2.0f,
         playerPos.z + sinf(angle) * distance
     };
+    transform.scale = 1.5f + (tension / 100.0f) * 1.0f;
+    
+    motion.velocity = (Vector3){0, 0, 0};
+    motion.prevPosition = transform.position;
     
-    w.targetPosition = w.position;
+    w.targetPosition = transform.position;
     w.opacity = 0.0f;
-    w.size = 1.5f + (tension / 100.0f) * 1.0f;
     w.moveTimer = 0.0f;
     w.stareIntensity = 0.0f;
     w.isVisible = false;
     w.playerLooking = false;
     w.distanceToPlayer = distance;
     
-    m_watchers.push_back(w);
+    EntityHandle h = EntityStore::Get().Create(transform, motion, w, UpdateScheduler::Get().NewSchedule());
+    SpatialIndex::Get().Insert(h, SPATIAL_WATCHER, transform.position, transform.scale);
     TraceLog(LOG_WARNING, "👁️ Watcher #%d spawned at distance %.1f (Tension: %.1f)", 
              w.id, distance, tension);
 }
 
 void WatcherSystem::Update(Camera3D camera, float tension, float deltaTime) {
+    EntityStore& store = EntityStore::Get();
+    
+    store.ForEach<EntityTransform, EntityMotion, Watcher>(
+        [](int count, const EntityHandle*, EntityTransform* transforms, EntityMotion* motions, Watcher*) {
+        for (int i = 0; i < count; i++) {
+            motions[i].prevPosition = transforms[i].position;
+        }
+    });
+    
     m_spawnTimer += deltaTime;
     m_activeWatchers = 0;
     
@@ -96,7 +124,7 @@ void WatcherSystem::Update(Camera3D camera, float tension, float deltaTime) {
     if (tension > 80.0f) maxWatchers = 5;
     
     if (m_spawnTimer > spawnInterval && tension > 25.0f) {
-        if ((int)m_watchers.size() < maxWatchers) {
+        if (store.Count<Watcher>() < maxWatchers) {
             SpawnWatcher(camera.position, tension);
             m_spawnTimer = 0.0f;
         } else {
@@ -104,30 +132,56 @@ void WatcherSystem::Update(Camera3D camera, float tension, float deltaTime) {
         }
     }
     
-    for (auto it = m_watchers.begin(); it != m_watchers.end(); ) {
-        UpdateWatcher(*it, camera, deltaTime);
-        
-        if (it->isVisible) {
-            m_activeWatchers++;
+    // Occlusione del terreno: un batch di query per tutti i watcher,
+    // i risultati arrivano dal servizio LOS (valutato a fine frame)
+    m_losRequests.clear();
+    store.ForEach<EntityTransform, Watcher>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, Watcher* watchers) {
+        for (int i = 0; i < count; i++) {
+            m_losRequests.push_back({watchers[i].id, camera.position, transforms[i].position});
         }
-        
-        float dist = Vector3Distance(it->position, camera.position);
-        if (dist > 150.0f || (!it->isVisible && it->moveTimer > 45.0f)) {
-            TraceLog(LOG_INFO, "Removing watcher #%d (dist: %.1f, timer: %.1f)", 
-                     it->id, dist, it->moveTimer);
-            it = m_watchers.erase(it);
-        } else {
-            ++it;
+    });
+    LineOfSight::Get().SubmitBatch(LosOwner::WATCHER, m_losRequests.data(), (int)m_losRequests.size());
+    
+    // Un watcher lontano e fuori vista si aggiorna ogni 4 o 16 tick
+    m_removed.clear();
+    UpdateScheduler& scheduler = UpdateScheduler::Get();
+    store.ForEach<EntityTransform, Watcher, UpdateSchedule>(
+        [&](int count, const EntityHandle* handles, EntityTransform* transforms, Watcher* watchers, UpdateSchedule* schedules) {
+        for (int i = 0; i < count; i++) {
+            Watcher& w = watchers[i];
+            float dt = scheduler.Step(schedules[i], transforms[i].position, deltaTime);
+            
+            if (dt > 0.0f) {
+                UpdateWatcher(transforms[i], w, camera, dt);
+                SpatialIndex::Get().Move(handles[i], transforms[i].position);
+                
+                float dist = Vector3Distance(transforms[i].position, camera.position);
+                if (dist > 150.0f || (!w.isVisible && w.moveTimer > 45.0f)) {
+                    TraceLog(LOG_INFO, "Removing watcher #%d (dist: %.1f, timer: %.1f)", 
+                             w.id, dist, w.moveTimer);
+                    m_removed.push_back(handles[i]);
+                }
+            }
+            
+            if (w.isVisible) {
+                m_activeWatchers++;
+            }
         }
+    });
+    
+    for (EntityHandle h : m_removed) {
+        store.Destroy(h);
     }
 }
 
-void WatcherSystem::UpdateWatcher(Watcher& watcher, Camera3D camera, float deltaTime) {
+void WatcherSystem::UpdateWatcher(EntityTransform& transform, Watcher& watcher, Camera3D camera, float deltaTime) {
+    Vector3& position = transform.position;
     watcher.moveTimer += deltaTime;
     
-    watcher.distanceToPlayer = Vector3Distance(watcher.position, camera.position);
+    watcher.distanceToPlayer = Vector3Distance(position, camera.position);
     
-    watcher.playerLooking = IsInPlayerView(watcher.position, camera);
+    watcher.playerLooking = IsInPlayerView(position, watcher, camera);
     
     if (watcher.playerLooking) {
         watcher.opacity += deltaTime * 2.0f;
@@ -141,15 +195,24 @@ void WatcherSystem::UpdateWatcher(Watcher& watcher, Camera3D camera, float delta
         watcher.opacity -= deltaTime * 0.5f;
         watcher.stareIntensity = 0.0f;
         
-        if (watcher.distanceToPlayer > 15.0f) {
-            Vector3 dirToPlayer = Vector3Subtract(camera.position, watcher.position);
+        FlowSample flow = FlowField::Get().Sample(position);
+        
+        if (watcher.distanceToPlayer > 15.0f && flow.valid) {
+            // Insegue lungo il campo di flusso condiviso, sospeso sul terreno
+            float moveSpeed = 2.0f;
+            position = Vector3Add(position, Vector3Scale(flow.direction, deltaTime * moveSpeed));
+            float hover = flow.groundHeight + WATCHER_HOVER_HEIGHT;
+            position.y += (hover - position.y) * fminf(1.0f, deltaTime * 2.0f);
+        } else if (watcher.distanceToPlayer > 15.0f) {
+            // Fuori dal campo (o cella irraggiungibile): linea retta
+            Vector3 dirToPlayer = Vector3Subtract(camera.position, position);
             float dist = Vector3Length(dirToPlayer);
             
             if (dist > 0.1f) {
                 dirToPlayer = Vector3Normalize(dirToPlayer);
                 float moveSpeed = 2.0f;
-                watcher.position = Vector3Add(
-                    watcher.position, 
+                position = Vector3Add(
+                    position, 
                     Vector3Scale(dirToPlayer, deltaTime * moveSpeed)
                 );
             }
@@ -161,8 +224,8 @@ void WatcherSystem::UpdateWatcher(Watcher& watcher, Camera3D camera, float delta
             right = Vector3Normalize(right);
             
             float circleSpeed = 0.5f;
-            watcher.position = Vector3Add(
-                watcher.position,
+            position = Vector3Add(
+                position,
                 Vector3Scale(right, deltaTime * circleSpeed)
             );
         }
@@ -174,8 +237,8 @@ void WatcherSystem::UpdateWatcher(Watcher& watcher, Camera3D camera, float delta
     watcher.isVisible = watcher.opacity > 0.05f;
 }
 
-bool WatcherSystem::IsInPlayerView(Vector3 pos, Camera3D camera) {
-    Vector3 toWatcher = Vector3Subtract(pos, camera.position);
+bool WatcherSystem::IsInPlayerView(Vector3 position, const Watcher& watcher, Camera3D camera) {
+    Vector3 toWatcher = Vector3Subtract(position, camera.position);
     float dist = Vector3Length(toWatcher);
     
     if (dist < 0.1f) return false;
@@ -186,70 +249,70 @@ bool WatcherSystem::IsInPlayerView(Vector3 pos, Camera3D camera) {
     forward = Vector3Normalize(forward);
     
     float dot = Vector3DotProduct(forward, toWatcher);
+    if (dot <= 0.3f) return false;
     
-    return dot > 0.3f;
+    // Dietro una collina non conta: finché la query non è valutata vale solo il cono
+    return LineOfSight::Get().IsVisible(LosOwner::WATCHER, watcher.id, true);
 }
 
-void WatcherSystem::Draw(Camera3D camera) {
+void WatcherSystem::Draw(Camera3D camera, float alpha) {
     if (!m_initialized) return;
     
-    for (const auto& watcher : m_watchers) {
-        if (!watcher.isVisible || watcher.opacity < 0.05f) continue;
-        
-        // Disegna modello custom se disponibile
-        if (m_watcherModel.meshCount > 0) {
-            // Calcola rotazione verso player
-            Vector3 toPlayer = Vector3Subtract(camera.position, watcher.position);
-            float angle = atan2f(toPlayer.x, toPlayer.z) * RAD2DEG;
-            
-            // Disegna modello con fade
-            Color tint = Fade(BLACK, watcher.opacity);
-            DrawModelEx(
-                m_watcherModel,
-                watcher.position,
-                (Vector3){0, 1, 0},
-                angle,
-                (Vector3){watcher.size, watcher.size, watcher.size},
-                tint
-            );
-        } else {
-            // FALLBACK: sfera nera
-            Color bodyColor = Fade(BLACK, watcher.opacity);
-            DrawSphere(watcher.position, watcher.size, bodyColor);
-        }
+    EntityStore::Get().ForEach<EntityTransform, EntityMotion, Watcher>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, EntityMotion* motions, Watcher* watchers) {
+        for (int i = 0; i < count; i++) {
+            const Watcher& watcher = watchers[i];
+            float size = transforms[i].scale;
+            if (!watcher.isVisible || watcher.opacity < 0.05f) continue;
+    
+            Vector3 position = Vector3Lerp(motions[i].prevPosition, transforms[i].position, alpha);
+    
+            // Disegna modello custom se disponibile
+            if (m_watcherModel.meshCount > 0) {
+                // Calcola rotazione verso player
+                Vector3 toPlayer = Vector3Subtract(camera.position, position);
+                float angle = atan2f(toPlayer.x, toPlayer.z) * RAD2DEG;
         
-        // OCCHI (sempre visibili)
-        if (watcher.opacity > 0.2f) {
-            Vector3 eyeLeft = watcher.position;
-            eyeLeft.x -= 0.3f * watcher.size;
-            eyeLeft.y += 0.2f * watcher.size;
-            
-            Vector3 eyeRight = watcher.position;
-            eyeRight.x += 0.3f * watcher.size;
-            eyeRight.y += 0.2f * watcher.size;
-            
-            float eyeGlow = watcher.playerLooking ? 1.0f : 0.5f;
-            float eyeSize = 0.15f * watcher.size;
-            
-            DrawSphere(eyeLeft, eyeSize, Fade(WHITE, watcher.opacity * eyeGlow));
-            DrawSphere(eyeRight, eyeSize, Fade(WHITE, watcher.opacity * eyeGlow));
-            
-            if (watcher.playerLooking && watcher.stareIntensity > 0.5f) {
-                DrawSphere(eyeLeft, eyeSize * 1.3f, Fade(RED, watcher.opacity * 0.3f));
-                DrawSphere(eyeRight, eyeSize * 1.3f, Fade(RED, watcher.opacity * 0.3f));
+                // Disegna modello con fade
+                Color tint = Fade(BLACK, watcher.opacity);
+                DrawModelEx(
+                    m_watcherModel,
+                    position,
+                    (Vector3){0, 1, 0},
+                    angle,
+                    (Vector3){size, size, size},
+                    tint
+                );
+            } else {
+                // FALLBACK: sfera nera
+                Color bodyColor = Fade(BLACK, watcher.opacity);
+                DrawSphere(position, size, bodyColor);
             }
+    
+            // OCCHI (sempre visibili): li disegna lo shader degli effetti
+            EffectEmitter eyes = {};
+            eyes.position = position;
+            eyes.size = size;
+            eyes.color = WHITE;
+            eyes.params[0] = watcher.opacity;
+            eyes.params[1] = watcher.playerLooking ? 1.0f : 0.5f;
+            eyes.params[2] = (watcher.playerLooking && watcher.stareIntensity > 0.5f) ? 1.0f : 0.0f;
+            PushEffect(EFFECT_WATCHER_EYES, &eyes);
         }
-    }
+    });
 }
 
 void WatcherSystem::Cleanup() {
     if (!m_initialized) return;
     
-    if (m_watcherModel.meshCount > 0) {
+    if (m_watcherHandle.IsValid()) {
+        AssetCache::Get().Release(m_watcherHandle);
+        m_watcherHandle = NULL_MODEL;
+    } else if (m_watcherModel.meshCount > 0) {
         UnloadModel(m_watcherModel);
     }
     
-    m_watchers.clear();
+    EntityStore::Get().DestroyAll<Watcher>();
     m_initialized = false;
     
     TraceLog(LOG_INFO, "✓ Watcher System cleaned up");
@@ -2,12 +2,16 @@
 
 #include "raylib.h"
 #include <vector>
+#include "../core/random.h"
+#include "../core/lineOfSight.h"
+#include "../core/entityStore.h"
+#include "../core/assetCache.h"
 
+// Componente dei watcher: posizione e dimensione in EntityTransform,
+// posizione del tick precedente in EntityMotion
 struct Watcher {
-    Vector3 position;
     Vector3 targetPosition;
     float opacity;
-    float size;
     float moveTimer;
     float stareIntensity;
     bool isVisible;
@@ -23,22 +27,29 @@ public:
     
     void Init();
     void Update(Camera3D camera, float tension, float deltaTime);
-    void Draw(Camera3D camera);
+    // alpha: frazione del tick corrente, interpola tra EntityMotion::prevPosition e la posizione
+    void Draw(Camera3D camera, float alpha = 1.0f);
     void Cleanup();
     
     bool IsPlayerBeingWatched() const { return m_activeWatchers > 0; }
     int GetActiveWatcherCount() const { return m_activeWatchers; }
     
     void SpawnWatcher(Vector3 playerPos, float tension);  // ← AGGIUNGI
+    // Stream degli spawn derivato dal seed della dimensione (replay riproducibili)
+    void SetSeed(int seed);
 
 private:
-    std::vector<Watcher> m_watchers;
     Model m_watcherModel;
+    ModelHandle m_watcherHandle{};   // nullo con la sfera procedurale
     int m_activeWatchers;
     float m_spawnTimer;
     bool m_initialized;
+    RandomStream m_rng;
+    int m_nextId;
+    std::vector<LosRequest> m_losRequests;
+    std::vector<EntityHandle> m_removed;
     
-    void UpdateWatcher(Watcher& watcher, Camera3D camera, float deltaTime);
-    bool IsInPlayerView(Vector3 pos, Camera3D camera);
+    void UpdateWatcher(EntityTransform& transform, Watcher& watcher, Camera3D camera, float deltaTime);
+    bool IsInPlayerView(Vector3 position, const Watcher& watcher, Camera3D camera);
     Vector3 GetBehindPlayerPosition(Camera3D camera, float distance);
 };
\ No newline at end of file
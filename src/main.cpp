@@ -6,18 +6,32 @@
 #include "world/dimensions.h"
 #include "world/blocks.h"
 #include "rendering/skybox.h"
+#include "rendering/effects.h"
+#include "rendering/hud.h"
+#include "rendering/dynamicResolution.h"
 #include "core/portal.h"
 #include "world/decorations.h"
+#include "world/worldCache.h"
 #include "gameplay/dropped_item.h"
 #include "gameplay/inventory.h"
 #include "gameplay/mining.h"
+#include "gameplay/interaction.h"
 #include "world/worldRenderer.h"
 #include "core/cosmicState.h"
+#include "core/lineOfSight.h"
+#include "core/flowField.h"
+#include "core/updateScheduler.h"
+#include "core/simulation.h"
+#include "core/framePacing.h"
+#include "core/assetCache.h"
 #include "horror/watchers.h"
 #include "horror/audioManager.h"
+#include "horror/screenEffects.h"
 #include "world/monuments.h"
 #include <cstdio>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include "rlgl.h"
 
 void DrawMiningProgress(MiningState &mining)
@@ -41,11 +55,35 @@ void DrawMiningProgress(MiningState &mining)
     }
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    // --headless N: esegue N tick di simulazione senza render, alla massima velocità
+    // --half-res-effects: con gli effetti di tensione attivi la scena va a metà risoluzione
+    // --fixed-resolution: disattiva la risoluzione dinamica della scena
+    // --benchmark S: S secondi senza limite di FPS a risoluzione fissa, poi statistiche ed uscita
+    int headlessTicks = 0;
+    bool halfResEffects = false;
+    bool fixedResolution = false;
+    float benchmarkSeconds = 0.0f;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc)
+            headlessTicks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--half-res-effects") == 0)
+            halfResEffects = true;
+        else if (strcmp(argv[i], "--fixed-resolution") == 0)
+            fixedResolution = true;
+        else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+            benchmarkSeconds = (float)atof(argv[++i]);
+    }
+
     const int screenWidth = 1600, screenHeight = 900;
+    // Il contesto GL serve comunque (upload delle mesh dei chunk)
+    if (headlessTicks > 0)
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
     InitWindow(screenWidth, screenHeight, "Dimensional World - Cosmic Horror Edition");
-    SetTargetFPS(60);
+    // Il ritmo dei frame lo tiene FramePacer (attesa prima dell'input, non dopo)
+    SetTargetFPS(0);
     rlEnableDepthTest();
 
     TraceLog(LOG_INFO, "========================================");
@@ -77,34 +115,29 @@ int main()
     dimensionManager.LoadDimensionTextures(currentDim);
 
     // ========== SHADER SYSTEM ==========
-    LoadTerrainShader();
-
-    // ========== LOAD CHROMATIC SHADER ==========
-    Shader chromaticShader = {0};
-    int aberrationLoc = -1;
-
-    chromaticShader = LoadShader("assets/shaders/glsl330/chromatic_vertex.vs",
-                                 "assets/shaders/glsl330/chromatic.fs");
-
-    if (chromaticShader.id > 0)
-    {
-        aberrationLoc = GetShaderLocation(chromaticShader, "aberration");
-        chromaticShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(chromaticShader, "mvp");
-        TraceLog(LOG_INFO, "✓ Chromatic aberration shader loaded (ID: %d)", chromaticShader.id);
-    }
-    else
-    {
-        TraceLog(LOG_WARNING, "✗ Chromatic shader not loaded");
-    }
-
-    // ========== RENDER TEXTURE FOR POST-PROCESSING ==========
-    RenderTexture2D screenTarget = LoadRenderTexture(screenWidth, screenHeight);
-    TraceLog(LOG_INFO, "✓ Render target created");
+    // Ogni programma compilato una volta (o ripreso dalla cache dei binari):
+    // le varianti del terreno di tutte le dimensioni subito, non al primo viaggio
+    InitShaderRegistry();
+    for (const DimensionConfig &dim : dimensionManager.dimensions)
+        LoadTerrainShader(GetTerrainVariant(&dim));
+
+    // ========== POST-PROCESSING ==========
+    ScreenEffects::Get().Init(screenWidth, screenHeight);
+    ScreenEffects::Get().SetHalfResolution(halfResEffects);
+    // Scala della scena dal tempo di frame, rispetto ai 60 FPS obiettivo
+    DynamicResolution dynRes;
+    DynamicResolutionInit(&dynRes, 1.0f / 60.0f, !fixedResolution && benchmarkSeconds <= 0.0f);
+
+    // ========== HUD ==========
+    Hud hud;
+    InitHud(&hud);
 
     // ========== WORLD ==========
     World world;
     WorldInit(&world);
     SetWorldDimension(currentDim->terrainSeed);
+    SetWorldBiomes(currentDim);
+    SetWorldTerrainMode(currentDim->useDensityTerrain);
     SetDimensionColors(currentDim->grassTopColor, currentDim->dirtSideColor, currentDim->dirtColor);
     WorldLoadTextures(&world, currentDim);
     TraceLog(LOG_INFO, "✓ World initialized");
@@ -128,7 +161,8 @@ int main()
     ps.inWater = false;
     ps.mining.mining = false;
     ps.mining.progress = 0.0f;
-    DisableCursor();
+    if (headlessTicks == 0)
+        DisableCursor();
     TraceLog(LOG_INFO, "✓ Player system initialized");
 
     // ========== SKYBOX ==========
@@ -138,11 +172,11 @@ int main()
     // ========== DECORATION SYSTEM ==========
     DecorationSystem decorationSystem;
     InitDecorationSystem(&decorationSystem);
-    GenerateDecorationsForDimension(&decorationSystem, &world, currentDim);
-    TraceLog(LOG_INFO, "✓ Decorations generated (Trees:%d Rocks:%d Crystals:%d)",
-             (int)decorationSystem.trees.size(),
-             (int)decorationSystem.rocks.size(),
-             (int)decorationSystem.crystals.size());
+    // Chunk pre-generati (make pregen), altrimenti generazione a runtime;
+    // le decorazioni arrivano con i chunk
+    WorldCacheLoad(GetWorldCachePath(currentDim).c_str(), currentDim, &world);
+    StreamDecorations(&decorationSystem, &world, currentDim);
+    TraceLog(LOG_INFO, "✓ Decorations streamed with the chunks");
 
     // ========== PORTAL SYSTEM ==========
     PortalSystem portalSystem;
@@ -150,13 +184,19 @@ int main()
     portalSystem.currentDimensionID = currentDim->id;
     TraceLog(LOG_INFO, "✓ Portal system initialized");
 
+    // ========== DROPPED ITEMS ==========
+    InitDroppedItems();
+    InitEffects();
+
     // ========== INVENTORY ==========
     Inventory playerInventory;
     playerInventory.AddItem(ItemType::DIRT, 64);
     playerInventory.AddItem(ItemType::GRASS, 64);
     playerInventory.AddItem(ItemType::STONE, 64);
     TraceLog(LOG_INFO, "✓ Inventory initialized");
-  DecorationMiningState decMining = {false, 0, 0, 0.0f};
+  DecorationMiningState decMining = {false, 0, NULL_ENTITY, 0.0f};
+    // Bersaglio del mirino, risolto una volta per tick
+    InteractionQuery interaction = {};
     // ========== HORROR SYSTEMS ==========
     TraceLog(LOG_INFO, "========================================");
     TraceLog(LOG_INFO, "   INITIALIZING HORROR SYSTEMS");
@@ -167,10 +207,11 @@ int main()
 
     WatcherSystem watcherSystem;
     watcherSystem.Init();
+    watcherSystem.SetSeed(currentDim->terrainSeed);
 
     MonumentSystem monumentSystem;
     monumentSystem.Init();
-    monumentSystem.GenerateMonuments(ps.camera.position, 5);
+    monumentSystem.Stream(&world, currentDim->terrainSeed);
 
     TraceLog(LOG_INFO, "✓ All horror systems initialized");
 
@@ -179,126 +220,41 @@ int main()
     bool isChangingDimension = false;
     float dimensionChangeTimer = 0.0f;
     int targetDimensionID = 0;
+    bool showPortalPrompt = false;
 
-    TraceLog(LOG_INFO, "========================================");
-    TraceLog(LOG_INFO, "   ENTERING MAIN GAME LOOP");
-    TraceLog(LOG_INFO, "========================================");
+    // Posizione degli occhi al tick precedente: il render interpola verso quella corrente
+    Vector3 prevEyePosition = ps.camera.position;
 
-    // ========== MAIN LOOP ==========
-    while (!WindowShouldClose())
+    // ========== SIMULATION TICK ==========
+    // Tutto lo stato di gioco avanza qui, sempre di SIM_DT: il risultato non
+    // dipende dal frame rate e la simulazione può girare senza render
+    auto simulationTick = [&](float dt)
     {
-        float deltaTime = GetFrameTime();
+        prevEyePosition = ps.camera.position;
+        UpdateScheduler::Get().BeginTick(ps.camera);
 
         // ========== UPDATE COSMIC STATE ==========
-        CosmicState::Get().Update(deltaTime);
+        CosmicState::Get().Update(dt);
         float tension = CosmicState::Get().GetTension();
 
         // ========== UPDATE HORROR SYSTEMS ==========
-        AudioManager::Get().Update(tension, deltaTime);
-        watcherSystem.Update(ps.camera, tension, deltaTime);
-        monumentSystem.Update(ps.camera.position, deltaTime);
+        FlowField::Get().Update(&world, ps.camera.position);
+        watcherSystem.Update(ps.camera, tension, dt);
+        monumentSystem.Update(ps.camera.position, dt);
+        LineOfSight::Get().Process(&world);
 
-        // ========== CALCULATE FOG PARAMETERS ==========
-        float fogDensity = 0.01f + (tension * 0.0024f);
-
-        Color fogColor;
-        if (tension < 20.0f)
-        {
-            float intensity = 200.0f - (tension * 2.0f);
-            fogColor = (Color){
-                (unsigned char)intensity,
-                (unsigned char)intensity,
-                (unsigned char)intensity,
-                255};
-        }
-        else if (tension < 50.0f)
-        {
-            float t = (tension - 20.0f) / 30.0f;
-            fogColor.r = (unsigned char)(160 - t * 90);
-            fogColor.g = (unsigned char)(160 - t * 130);
-            fogColor.b = (unsigned char)(160 + t * 75);
-            fogColor.a = 255;
-        }
-        else if (tension < 80.0f)
-        {
-            float t = (tension - 50.0f) / 30.0f;
-            fogColor.r = (unsigned char)(70 - t * 50);
-            fogColor.g = (unsigned char)(30 - t * 20);
-            fogColor.b = (unsigned char)(235 - t * 135);
-            fogColor.a = 255;
-        }
-        else
-        {
-            float t = (tension - 80.0f) / 20.0f;
-            if (t > 1.0f)
-                t = 1.0f;
-            fogColor.r = (unsigned char)(20 - t * 10);
-            fogColor.g = (unsigned char)(10 - t * 5);
-            fogColor.b = (unsigned char)(100 - t * 50);
-            fogColor.a = 255;
-        }
-
-        // ========== CHROMATIC ABERRATION AMOUNT ==========
-        // Per un effetto VERAMENTE nauseante:
-        float chromaticAmount = 0.0f;
-
-        // Base sempre presente
-        chromaticAmount = 0.005f;
-
-        // Scala esponenziale con la tensione
-        chromaticAmount += (tension / 100.0f) * 0.15f; // Max +0.15 a tension 100
-
-        // Pulsazione cardiaca (aumenta con tensione)
-        float heartbeatSpeed = 2.0f + (tension / 50.0f) * 4.0f; // 2Hz -> 6Hz
-        float heartbeat = sinf(GetTime() * heartbeatSpeed) * 0.5f + 0.5f;
-        chromaticAmount += heartbeat * (tension / 100.0f) * 0.08f;
-
-        // Glitch randomico ad alta tensione
-        if (tension > 70.0f)
-        {
-            if ((int)(GetTime() * 10.0f) % 10 == 0)
-            { // 10% del tempo
-                chromaticAmount += 0.05f;
-            }
-        }
-
-        // Cap massimo (opzionale, per evitare crash GPU)
-        if (chromaticAmount > 0.25f)
-            chromaticAmount = 0.25f;
-
-        // ========== INPUT ==========
-        if (IsKeyPressed(KEY_TAB) || IsKeyPressed(KEY_E))
-            inventoryOpen = !inventoryOpen;
-
-        for (int i = 0; i < HOTBAR_SIZE; i++)
-            if (IsKeyPressed(KEY_ONE + i))
-                playerInventory.SelectSlot(i);
-
-        // ========== FOG DEBUG (PRESS F) ==========
-        if (IsKeyPressed(KEY_F))
-        {
-            TraceLog(LOG_INFO, "========== FOG DEBUG ==========");
-            TraceLog(LOG_INFO, "  Fog Density: %.4f", fogDensity);
-            TraceLog(LOG_INFO, "  Fog Color: (%d,%d,%d)", fogColor.r, fogColor.g, fogColor.b);
-            TraceLog(LOG_INFO, "  Shader ID: %d", worldRenderer.fogShader.id);
-            TraceLog(LOG_INFO, "  fogDensityLoc: %d", worldRenderer.fogDensityLoc);
-            TraceLog(LOG_INFO, "  fogColorLoc: %d", worldRenderer.fogColorLoc);
-            TraceLog(LOG_INFO, "  viewPosLoc: %d", worldRenderer.viewPosLoc);
-            TraceLog(LOG_INFO, "  Tension: %.1f", tension);
-            TraceLog(LOG_INFO, "  Camera Pos: (%.1f, %.1f, %.1f)",
-                     ps.camera.position.x, ps.camera.position.y, ps.camera.position.z);
-            TraceLog(LOG_INFO, "===============================");
-        }
+        showPortalPrompt = false;
 
         if (!inventoryOpen && !isChangingDimension)
         {
             // ========== WORLD UPDATE ==========
             WorldUpdate(&world, ps.camera.position);
-            UpdatePlayerPhysics(&ps, &world, deltaTime);
-            CollisionWithDecoration(&decorationSystem, &ps);
 
-            UpdateCamera(&ps.camera, ps.cameraMode);
-            if (IsKeyPressed(KEY_K))
+            // Input WASD, poi lo sweep con le collisioni
+            Vector3 previousPosition = ps.camera.position;
+            UpdatePlayerMovement(&ps, dt);
+            UpdatePlayerPhysics(&ps, &world, &decorationSystem, previousPosition, dt);
+            if (SimIsKeyPressed(KEY_K))
             {
                 Vector3 forward = Vector3Subtract(ps.camera.target, ps.camera.position);
                 forward = Vector3Normalize(forward);
@@ -308,18 +264,20 @@ int main()
                 watcherSystem.SpawnWatcher(spawnPos, 50.0f);
                 TraceLog(LOG_INFO, "👁️ DEBUG: EyeTooth watcher spawned 15m ahead!");
             }
-            // ========== MINING ==========
-            static DecorationMiningState decMining = {false, 0, 0, 0.0f};
 
+            // ========== CROSSHAIR QUERY ==========
+            UpdateInteractionQuery(&interaction, ps.camera, &world);
+
+            // ========== MINING ==========
             if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
             {
                 // PRIMA: Prova a minare decorazioni (alberi/rocce)
-                bool minedDecoration = MineDecoration(&decorationSystem, &decMining, ps.camera, deltaTime);
+                bool minedDecoration = MineDecoration(&decorationSystem, &decMining, &interaction, dt);
 
                 if (!minedDecoration)
                 {
                     // ALTRIMENTI: Mining blocchi terreno normale
-                    UpdateMining(ps.mining, ps.camera, &world, deltaTime);
+                    UpdateMining(ps.mining, &interaction, dt);
 
                     if (ps.mining.mining && ps.mining.progress >= 2.0f)
                     {
@@ -331,6 +289,12 @@ int main()
 
                         if (droppedItem != ItemType::NONE)
                         {
+                            // Il blocco non c'è più: il piazzamento deve vedere il terreno nuovo
+                            UpdateInteractionQuery(&interaction, ps.camera, &world);
+
+                            // Gli oggetti appoggiati sul blocco tornano a cadere
+                            WakeDroppedItems((Vector3){bx + 0.5f, by + 1.0f, bz + 0.5f}, 1.5f);
+
                             Vector3 dropPos = {
                                 ps.mining.targetBlock.x + 0.5f,
                                 ps.mining.targetBlock.y + 1.0f,
@@ -352,21 +316,22 @@ int main()
             }
 
             // ========== BLOCK PLACEMENT ==========
-            if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON))
+            if (SimIsMouseButtonPressed(MOUSE_RIGHT_BUTTON))
             {
                 Item selectedItem = playerInventory.GetSelected();
 
                 if (selectedItem.type != ItemType::NONE && selectedItem.quantity > 0)
                 {
-                    Vector3 placePos;
-                    if (RaycastPlaceBlock(ps.camera, &world, placePos))
+                    if (interaction.canPlace)
                     {
+                        Vector3 placePos = interaction.placePos;
                         int px = (int)placePos.x;
                         int py = (int)placePos.y;
                         int pz = (int)placePos.z;
 
                         if (PlaceBlock(&world, px, py, pz, selectedItem.type))
                         {
+                            WakeDroppedItems((Vector3){px + 0.5f, py + 0.5f, pz + 0.5f}, 1.5f);
                             playerInventory.RemoveSelected(1);
                         }
                     }
@@ -374,19 +339,15 @@ int main()
             }
 
             // ========== PORTALS ==========
-            UpdatePortalSystem(&portalSystem, ps.camera, &world, &dimensionManager, deltaTime);
+            UpdatePortalSystem(&portalSystem, ps.camera, &world, &dimensionManager, dt);
 
             Portal *nearPortal = CheckPlayerNearPortal(&portalSystem, ps.camera.position);
 
             if (nearPortal && !isChangingDimension)
             {
-                DrawText("Premi [E] per attraversare il portale",
-                         screenWidth / 2 - 160,
-                         screenHeight / 2 + 40,
-                         20,
-                         RAYWHITE);
+                showPortalPrompt = true;
 
-                if (IsKeyPressed(KEY_E))
+                if (SimIsKeyPressed(KEY_E))
                 {
                     isChangingDimension = true;
                     targetDimensionID = nearPortal->targetDimensionID;
@@ -401,13 +362,13 @@ int main()
             }
 
             // ========== DROPPED ITEMS ==========
-            UpdateDroppedItems(&world, &playerInventory, ps.camera.position, deltaTime);
+            UpdateDroppedItems(&world, &playerInventory, ps.camera.position, dt);
         }
 
         // ========== DIMENSION CHANGE ==========
         if (isChangingDimension)
         {
-            dimensionChangeTimer += deltaTime;
+            dimensionChangeTimer += dt;
 
             if (dimensionChangeTimer > 0.5f && dimensionChangeTimer < 0.6f)
             {
@@ -419,17 +380,21 @@ int main()
                 UnloadSkybox(skybox);
                 CleanupDecorationSystem(&decorationSystem);
                 WorldCleanup(&world);                // ← PRIMA pulisci i chunk
+                LineOfSight::Get().Clear();
+                FlowField::Get().Clear();
                 UnloadWorldRenderer(&worldRenderer); // ← POI unload shader
-                dimensionManager.UnloadDimensionTextures(currentDim);
 
-                // Load new dimension
+                // Load new dimension: le texture della vecchia si rilasciano solo
+                // dopo aver preso quelle nuove, così i file in comune (acqua, pietra)
+                // restano nell'AssetCache invece di essere scaricati e ricaricati
+                DimensionConfig *previousDim = currentDim;
                 currentDim = dimensionManager.GetDimension(targetDimensionID);
 
                 if (!currentDim)
                 {
                     TraceLog(LOG_ERROR, "✗ Failed to get dimension %d!", targetDimensionID);
                     isChangingDimension = false;
-                    continue;
+                    return;
                 }
 
                 TraceLog(LOG_INFO, "→ Loading dimension: %s", currentDim->name.c_str());
@@ -438,18 +403,26 @@ int main()
                 CosmicState::Get().OnDimensionEntered(currentDim->name);
 
                 dimensionManager.LoadDimensionTextures(currentDim);
+                if (previousDim != currentDim)
+                    dimensionManager.UnloadDimensionTextures(previousDim);
 
                 WorldInit(&world);
                 SetWorldDimension(currentDim->terrainSeed);
+                SetWorldBiomes(currentDim);
+                SetWorldTerrainMode(currentDim->useDensityTerrain);
                 SetDimensionColors(currentDim->grassTopColor, currentDim->dirtSideColor, currentDim->dirtColor);
                 WorldLoadTextures(&world, currentDim);
                 InitWorldRenderer(&worldRenderer, currentDim);
                 skybox = LoadSkyboxFromDimension(currentDim);
                 InitDecorationSystem(&decorationSystem);
-                GenerateDecorationsForDimension(&decorationSystem, &world, currentDim);
+                WorldCacheLoad(GetWorldCachePath(currentDim).c_str(), currentDim, &world);
+                StreamDecorations(&decorationSystem, &world, currentDim);
                 portalSystem.currentDimensionID = targetDimensionID;
+                // Terreno nuovo sotto gli oggetti rimasti a terra
+                WakeAllDroppedItems();
 
-                monumentSystem.GenerateMonuments(ps.camera.position, 5);
+                monumentSystem.Stream(&world, currentDim->terrainSeed);
+                watcherSystem.SetSeed(currentDim->terrainSeed);
 
                 CosmicState::Get().OnDimensionEntered(currentDim->name);
 
@@ -462,98 +435,226 @@ int main()
                 dimensionChangeTimer = 0.0f;
             }
         }
+    };
+
+    TraceLog(LOG_INFO, "========================================");
+    TraceLog(LOG_INFO, "   ENTERING MAIN GAME LOOP");
+    TraceLog(LOG_INFO, "========================================");
+
+    // ========== HEADLESS SIMULATION ==========
+    if (headlessTicks > 0)
+    {
+        double headlessStart = GetTime();
+        for (int i = 0; i < headlessTicks; i++)
+            simulationTick(SIM_DT);
+        double headlessTime = GetTime() - headlessStart;
+
+        TraceLog(LOG_INFO, "Headless: %d ticks (%.1fs simulated) in %.2fs (x%.1f real time)",
+                 headlessTicks, headlessTicks * SIM_DT, headlessTime,
+                 headlessTime > 0.0 ? headlessTicks * SIM_DT / headlessTime : 0.0);
+        TraceLog(LOG_INFO, "Headless: Pos (%.2f, %.2f, %.2f) | Tension %.1f | Watchers %d | Items %d",
+                 ps.camera.position.x, ps.camera.position.y, ps.camera.position.z,
+                 CosmicState::Get().GetTension(), watcherSystem.GetActiveWatcherCount(),
+                 GetDroppedItemCount());
+    }
+
+    // ========== MAIN LOOP ==========
+    SimClock simClock;
+    SimClockInit(&simClock);
+
+    FramePacer pacer;
+    FramePacerInit(&pacer, benchmarkSeconds > 0.0f ? 0 : 60);
+    bool fogDebugRequested = false;
+
+    // Lettura dell'input dopo ogni PollInputEvents (EndDrawing compreso): gli
+    // eventi "pressed" valgono solo fino al poll successivo
+    auto sampleFrameInput = [&]()
+    {
+        if (IsKeyPressed(KEY_TAB) || IsKeyPressed(KEY_E))
+            inventoryOpen = !inventoryOpen;
+
+        for (int i = 0; i < HOTBAR_SIZE; i++)
+            if (IsKeyPressed(KEY_ONE + i))
+                playerInventory.SelectSlot(i);
+
+        if (IsKeyPressed(KEY_F))
+            fogDebugRequested = true;
+
+        // Eventi "pressed" trattenuti per i tick di questo frame (o dei successivi)
+        SimInputLatch();
+
+        // Mouse look ogni frame: la visuale non aspetta il tick di simulazione
+        if (!inventoryOpen && !isChangingDimension)
+            UpdatePlayerLook(&ps, GetMouseDelta());
+    };
+
+    while (headlessTicks == 0 && !WindowShouldClose())
+    {
+        // ========== INPUT ==========
+        // Eventi raccolti da EndDrawing, poi attesa della scadenza del frame e
+        // input fresco: la simulazione parte da quello che succede adesso
+        sampleFrameInput();
+        FramePacerWait(&pacer);
+        PollInputEvents();
+        sampleFrameInput();
+        FramePacerMarkInput(&pacer);
+
+        float frameTime = GetFrameTime();
+
+        // ========== SIMULATION (FIXED STEP) ==========
+        int simSteps = SimClockAdvance(&simClock, frameTime);
+        for (int i = 0; i < simSteps; i++)
+        {
+            simulationTick(SIM_DT);
+            SimInputConsume();
+        }
+        float alpha = SimClockAlpha(&simClock);
+
+        float tension = CosmicState::Get().GetTension();
+        AudioManager::Get().Update(tension, frameTime);
 
-        // ========== RENDERING TO TEXTURE ==========
-        BeginTextureMode(screenTarget);
+        // Camera del render: posizione interpolata tra gli ultimi due tick, visuale corrente
+        Camera3D renderCamera = ps.camera;
+        renderCamera.position = Vector3Lerp(prevEyePosition, ps.camera.position, alpha);
+        renderCamera.target = Vector3Add(ps.camera.target, Vector3Subtract(renderCamera.position, ps.camera.position));
+
+        // ========== CALCULATE FOG PARAMETERS ==========
+        Color fogColor;
+        if (tension < 20.0f)
+        {
+            float intensity = 200.0f - (tension * 2.0f);
+            fogColor = (Color){
+                (unsigned char)intensity,
+                (unsigned char)intensity,
+                (unsigned char)intensity,
+                255};
+        }
+        else if (tension < 50.0f)
+        {
+            float t = (tension - 20.0f) / 30.0f;
+            fogColor.r = (unsigned char)(160 - t * 90);
+            fogColor.g = (unsigned char)(160 - t * 130);
+            fogColor.b = (unsigned char)(160 + t * 75);
+            fogColor.a = 255;
+        }
+        else if (tension < 80.0f)
+        {
+            float t = (tension - 50.0f) / 30.0f;
+            fogColor.r = (unsigned char)(70 - t * 50);
+            fogColor.g = (unsigned char)(30 - t * 20);
+            fogColor.b = (unsigned char)(235 - t * 135);
+            fogColor.a = 255;
+        }
+        else
+        {
+            float t = (tension - 80.0f) / 20.0f;
+            if (t > 1.0f)
+                t = 1.0f;
+            fogColor.r = (unsigned char)(20 - t * 10);
+            fogColor.g = (unsigned char)(10 - t * 5);
+            fogColor.b = (unsigned char)(100 - t * 50);
+            fogColor.a = 255;
+        }
+
+        // ========== POST-PROCESSING ==========
+        // Aberrazione, vignetta e shake dalla tensione: a zero la scena salta il target
+        ScreenEffects::Get().Update(tension, frameTime);
+        ScreenEffects::Get().SetRenderScale(DynamicResolutionUpdate(&dynRes, frameTime));
+        float chromaticAmount = ScreenEffects::Get().GetChromaticAmount();
+
+        // ========== FOG DEBUG (PRESS F) ==========
+        if (fogDebugRequested)
+        {
+            fogDebugRequested = false;
+            TraceLog(LOG_INFO, "========== FOG DEBUG ==========");
+            TraceLog(LOG_INFO, "  Fog Color: (%d,%d,%d)", fogColor.r, fogColor.g, fogColor.b);
+            TraceLog(LOG_INFO, "  Shader ID: %d (variant %u)", worldRenderer.terrainShader.id, worldRenderer.variant);
+            TraceLog(LOG_INFO, "  fogColorLoc: %d", worldRenderer.fogColorLoc);
+            TraceLog(LOG_INFO, "  viewPosLoc: %d", worldRenderer.viewPosLoc);
+            TraceLog(LOG_INFO, "  Tension: %.1f", tension);
+            TraceLog(LOG_INFO, "  Camera Pos: (%.1f, %.1f, %.1f)",
+                     ps.camera.position.x, ps.camera.position.y, ps.camera.position.z);
+            TraceLog(LOG_INFO, "===============================");
+        }
+
+        // Batch e atlanti delle decorazioni: eventuali render in texture prima del frame
+        PrepareDecorationRender(&decorationSystem);
+
+        // HUD ricomposto solo se qualcosa è cambiato
+        HudContent hudContent;
+        hudContent.inventory = &playerInventory;
+        hudContent.inventoryOpen = inventoryOpen;
+        hudContent.onTarget = !(interaction.decoration == NULL_ENTITY) || !(interaction.entity == NULL_ENTITY);
+        hudContent.portalPrompt = showPortalPrompt && !isChangingDimension;
+        hudContent.dimension = currentDim;
+        hudContent.portalTarget = dimensionManager.GetDimension(portalSystem.currentDimensionID);
+        hudContent.debug.tension = tension;
+        hudContent.debug.watchers = watcherSystem.GetActiveWatcherCount();
+        hudContent.debug.monumentsActivated = monumentSystem.GetActivatedCount();
+        hudContent.debug.monumentsDiscovered = monumentSystem.GetDiscoveredCount();
+        hudContent.debug.chromaticAmount = chromaticAmount;
+        hudContent.debug.position = ps.camera.position;
+        hudContent.debug.updatesNear = UpdateScheduler::Get().GetUpdatedCount(UPDATE_TIER_NEAR);
+        hudContent.debug.updatesMid = UpdateScheduler::Get().GetUpdatedCount(UPDATE_TIER_MID);
+        hudContent.debug.updatesFar = UpdateScheduler::Get().GetUpdatedCount(UPDATE_TIER_FAR);
+        hudContent.debug.renderScale = ScreenEffects::Get().GetRenderScale();
+        hudContent.debug.latencyMs = pacer.lateLatencyMs;
+        UpdateHud(&hud, &hudContent);
+
+        // ========== LATE LATCH ==========
+        // Mouse look ricampionato a ridosso del render: la visuale del frame non
+        // paga il tempo speso in simulazione e preparazione
+        PollInputEvents();
+        sampleFrameInput();
+        FramePacerMarkLateInput(&pacer);
+        renderCamera.target = Vector3Add(ps.camera.target, Vector3Subtract(renderCamera.position, ps.camera.position));
+
+        // ========== RENDERING ==========
+        BeginDrawing();
+        ScreenEffects::Get().BeginScene();
         ClearBackground(fogColor);
 
         // Skybox (no fog)
-        DrawSkybox(skybox, ps.camera);
+        DrawSkybox(skybox, renderCamera);
 
-        BeginMode3D(ps.camera);
+        BeginMode3D(renderCamera);
 
         // Draw world WITH integrated fog shader
-        DrawWorld(&worldRenderer, &world, ps.camera, fogDensity, fogColor);
-        DrawDecorations(&decorationSystem);
+        DrawWorld(&worldRenderer, &world, renderCamera, fogColor);
+        DrawDecorations(&decorationSystem, renderCamera);
 
         // Draw elements WITHOUT fog
-        monumentSystem.Draw();
-        watcherSystem.Draw(ps.camera);
+        monumentSystem.Draw(renderCamera);
+        watcherSystem.Draw(renderCamera, alpha);
         DrawPortals(&portalSystem);
-        DrawDroppedItems();
+        DrawDroppedItems(alpha);
+        // Effetti accodati da monumenti, watcher e portali: una chiamata per tipo
+        DrawEffects(renderCamera);
         DrawMiningProgress(ps.mining);
 
         // ========== VISUAL FEEDBACK MINING DECORAZIONI ==========
-        static DecorationMiningState globalDecMining = {false, 0, 0, 0.0f};
-        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
+        // Stato aggiornato dal tick: nessun nuovo raycast in fase di disegno
+        if (decMining.mining)
         {
-            MineDecoration(&decorationSystem, &globalDecMining, ps.camera, 0);
-
-            if (globalDecMining.mining &&
-                globalDecMining.targetIndex < (globalDecMining.targetType == 0
-                                                   ? decorationSystem.trees.size()
-                                                   : decorationSystem.rocks.size()))
+            // Handle stabile: se la decorazione è già stata distrutta non risolve
+            const EntityTransform *target = EntityStore::Get().Find<EntityTransform>(decMining.target);
+            if (target)
             {
+                Vector3 targetPos = target->position;
 
-                Vector3 targetPos = (globalDecMining.targetType == 0)
-                                        ? decorationSystem.trees[globalDecMining.targetIndex].position
-                                        : decorationSystem.rocks[globalDecMining.targetIndex].position;
-
-                float pulseScale = 1.0f + sinf(globalDecMining.progress * 10.0f) * 0.2f;
+                float pulseScale = 1.0f + sinf(decMining.progress * 10.0f) * 0.2f;
                 DrawSphereWires(targetPos, pulseScale * 2.0f, 8, 8, YELLOW);
             }
         }
 
         EndMode3D();
-        EndMode3D();
-        EndTextureMode();
-
-        // ========== DRAW TO SCREEN WITH CHROMATIC ABERRATION ==========
-        BeginDrawing();
-        ClearBackground(BLACK);
-
-        // Apply chromatic aberration if tension > 30
-        if (chromaticShader.id > 0 && chromaticAmount > 0.001f)
-        {
-            BeginShaderMode(chromaticShader);
-            SetShaderValue(chromaticShader, aberrationLoc, &chromaticAmount, SHADER_UNIFORM_FLOAT);
-        }
-
-        // Draw render texture to screen
-        DrawTextureRec(
-            screenTarget.texture,
-            (Rectangle){0, 0, (float)screenTarget.texture.width, -(float)screenTarget.texture.height},
-            (Vector2){0, 0},
-            WHITE);
 
-        if (chromaticShader.id > 0 && chromaticAmount > 0.001f)
-        {
-            EndShaderMode();
-        }
+        // Effetti di tensione in un solo passaggio (niente se sono tutti a zero)
+        ScreenEffects::Get().EndScene();
 
         // ========== HUD ==========
-        DrawPortalGun(&portalSystem, ps.camera);
-        DrawFPS(10, 10);
-
-        char debug[512];
-        sprintf(debug,
-                "DIM: %s | Tension: %.1f | Watchers: %d | Monuments: %d/%d\n"
-                "Fog: %.3f | Chromatic: %.4f | Pos: (%.0f,%.0f,%.0f)\n"
-                "Press F for fog debug",
-                currentDim->name.c_str(),
-                tension,
-                watcherSystem.GetActiveWatcherCount(),
-                monumentSystem.GetActivatedCount(),
-                monumentSystem.GetDiscoveredCount(),
-                fogDensity,
-                chromaticAmount,
-                ps.camera.position.x, ps.camera.position.y, ps.camera.position.z);
-        DrawText(debug, 10, 30, 16, WHITE);
-
-        DimensionConfig *selDim = dimensionManager.GetDimension(portalSystem.currentDimensionID);
-        char portalInfo[128];
-        sprintf(portalInfo, "Portal Target: %s", selDim->name.c_str());
-        DrawText(portalInfo, 10, 90, 16, selDim->grassTopColor);
+        DrawPortalGun(&portalSystem, renderCamera);
+        DrawHud(&hud, &hudContent);
 
         // Warning messages based on tension
         if (tension > 25.0f && tension < 30.0f && CosmicState::Get().IsEventTriggered("firstwatcher"))
@@ -575,28 +676,6 @@ int main()
                      Fade(RED, sinf(GetTime() * 10.0f) * 0.5f + 0.5f));
         }
 
-        DrawText("LMB: Mine | RMB: Place | MMB: Portal | TAB: Inventory | 1-9: Hotbar",
-                 20, screenHeight - 30, 16, LIGHTGRAY);
-
-        // Crosshair
-        if (!inventoryOpen)
-        {
-            int centerX = screenWidth / 2;
-            int centerY = screenHeight / 2;
-            DrawLine(centerX - 10, centerY, centerX + 10, centerY, WHITE);
-            DrawLine(centerX, centerY - 10, centerX, centerY + 10, WHITE);
-        }
-
-        // Inventory
-        if (inventoryOpen)
-        {
-            playerInventory.DrawFullInventory();
-        }
-        else
-        {
-            playerInventory.DrawHotbar();
-        }
-        
         // ========== BARRA PROGRESSO MINING DECORAZIONI ==========
         if (decMining.mining) {
             int barWidth = 200;
@@ -628,8 +707,15 @@ int main()
         }
 
         EndDrawing();
+        FramePacerPresented(&pacer);
+
+        if (benchmarkSeconds > 0.0f && FramePacerElapsed(&pacer) >= benchmarkSeconds)
+            break;
     }
 
+    if (headlessTicks == 0)
+        FramePacerLogSummary(&pacer);
+
     // ========== CLEANUP ==========
     TraceLog(LOG_INFO, "========================================");
     TraceLog(LOG_INFO, "   SHUTTING DOWN");
@@ -639,19 +725,20 @@ int main()
     monumentSystem.Cleanup();
     AudioManager::Get().Cleanup();
 
-    UnloadRenderTexture(screenTarget);
-    if (chromaticShader.id > 0)
-        UnloadShader(chromaticShader);
+    UnloadHud(&hud);
+    ScreenEffects::Get().Cleanup();
 
     UnloadSkybox(skybox);
     UnloadWorldRenderer(&worldRenderer);
     dimensionManager.Cleanup();
-    UnloadTerrainShader();
 
     WorldCleanup(&world);
     CleanupPortalSystem(&portalSystem);
     CleanupDecorationSystem(&decorationSystem);
     CleanupDroppedItems();
+    UnloadEffects();
+    UnloadShaderRegistry();
+    AssetCache::Get().Cleanup();
 
     TraceLog(LOG_INFO, "✓ Cleanup complete");
     CloseWindow();
@@ -0,0 +1,61 @@
+#include "dynamicResolution.h"
+#include <math.h>
+
+void DynamicResolutionInit(DynamicResolution *dr, float targetFrameTime, bool enabled) {
+    dr->scale = DYNRES_MAX_SCALE;
+    dr->targetFrameTime = targetFrameTime;
+    dr->smoothedFrameTime = targetFrameTime;
+    dr->stableTime = 0.0f;
+    dr->settleTime = DYNRES_SETTLE_TIME;
+    dr->raiseDelay = DYNRES_RAISE_DELAY;
+    dr->sinceChange = 0.0f;
+    dr->lastChangeWasRaise = false;
+    dr->enabled = enabled;
+}
+
+static void SetScale(DynamicResolution *dr, float scale, bool raise) {
+    dr->scale = fminf(fmaxf(scale, DYNRES_MIN_SCALE), DYNRES_MAX_SCALE);
+    dr->smoothedFrameTime = dr->targetFrameTime;
+    dr->stableTime = 0.0f;
+    dr->settleTime = DYNRES_SETTLE_TIME;
+    dr->sinceChange = 0.0f;
+    dr->lastChangeWasRaise = raise;
+}
+
+float DynamicResolutionUpdate(DynamicResolution *dr, float frameTime) {
+    if (!dr->enabled) return DYNRES_MAX_SCALE;
+
+    dr->sinceChange += frameTime;
+    if (dr->settleTime > 0.0f) {
+        dr->settleTime -= frameTime;
+        return dr->scale;
+    }
+
+    // I picchi isolati (caricamenti) pesano al massimo come due frame lenti
+    float sample = fminf(frameTime, dr->targetFrameTime * 2.0f);
+    dr->smoothedFrameTime += (sample - dr->smoothedFrameTime) * 0.1f;
+    float load = dr->smoothedFrameTime / dr->targetFrameTime;
+
+    if (load > DYNRES_HIGH && dr->scale > DYNRES_MIN_SCALE) {
+        // Il costo segue l'area: scala ridotta della radice del sovraccarico
+        float scale = dr->scale * sqrtf(1.0f / load);
+        scale = fminf(scale, dr->scale - DYNRES_RAISE_STEP);
+        // Risalita appena fallita: il prossimo tentativo aspetta di più
+        if (dr->lastChangeWasRaise && dr->sinceChange < DYNRES_RAISE_DELAY) dr->raiseDelay = fminf(dr->raiseDelay * 2.0f, DYNRES_MAX_RAISE_DELAY);
+        SetScale(dr, scale, false);
+        return dr->scale;
+    }
+
+    if (load < DYNRES_LOW && dr->scale < DYNRES_MAX_SCALE) {
+        dr->stableTime += frameTime;
+        if (dr->stableTime >= dr->raiseDelay) {
+            SetScale(dr, dr->scale + DYNRES_RAISE_STEP, true);
+        }
+    } else {
+        dr->stableTime = 0.0f;
+    }
+
+    // Una risalita che regge: i tentativi tornano frequenti
+    if (dr->lastChangeWasRaise && dr->sinceChange >= DYNRES_RAISE_DELAY) dr->raiseDelay = DYNRES_RAISE_DELAY;
+    return dr->scale;
+}
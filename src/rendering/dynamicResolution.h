@@ -0,0 +1,38 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+// Scala della risoluzione interna della scena (lato, non area)
+#define DYNRES_MIN_SCALE 0.5f
+#define DYNRES_MAX_SCALE 1.0f
+#define DYNRES_RAISE_STEP 0.05f
+// Isteresi sul tempo di frame obiettivo: sopra DYNRES_HIGH si scende subito,
+// sotto DYNRES_LOW per DYNRES_RAISE_DELAY secondi si prova a risalire
+#define DYNRES_HIGH 1.10f
+#define DYNRES_LOW 1.02f
+#define DYNRES_RAISE_DELAY 2.0f
+#define DYNRES_MAX_RAISE_DELAY 16.0f
+// Dopo un cambio di scala i frame di transizione non contano
+#define DYNRES_SETTLE_TIME 0.25f
+
+// Controller della risoluzione dinamica: il tempo di frame misurato (media
+// esponenziale) decide la scala con cui la scena viene renderizzata; il
+// passaggio di post-processing la riporta a schermo. Con il limite di FPS i
+// frame non scendono sotto l'obiettivo: la risalita è un tentativo, e se
+// fallisce subito il tentativo successivo aspetta il doppio.
+typedef struct DynamicResolution {
+    float scale;
+    float targetFrameTime;
+    float smoothedFrameTime;
+    float stableTime;      // secondi consecutivi sotto DYNRES_LOW
+    float settleTime;      // secondi da ignorare dopo un cambio
+    float raiseDelay;
+    float sinceChange;     // secondi dall'ultimo cambio di scala
+    bool lastChangeWasRaise;
+    bool enabled;
+} DynamicResolution;
+
+void DynamicResolutionInit(DynamicResolution *dr, float targetFrameTime, bool enabled);
+// Una volta per frame con GetFrameTime(); ritorna la scala da usare
+float DynamicResolutionUpdate(DynamicResolution *dr, float frameTime);
+
+#endif
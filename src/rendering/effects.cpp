@@ -0,0 +1,133 @@
+#include "effects.h"
+#include "shaders.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <vector>
+
+// Particelle (quad) per tipo: devono coincidere con gli indici di effects.vs
+//   monumento: 20 in orbita, 6 anelli, 8 raggi, 1 luce in cima
+//   portale:   8 aloni, 1 disco, 5 onde, 50 spirale, 30 bordo, 2 nucleo, 8 archi, 3 distorsioni
+//   watcher:   2 occhi, 2 aloni rossi
+static const int EFFECT_PARTICLES[EFFECT_TYPE_COUNT] = {35, 107, 4};
+
+// Parametri per tipo (EffectEmitter.params):
+//   monumento: [0] intensità del pulse, [1] 1 se attivato
+//   portale:   nessuno
+//   watcher:   [0] opacità, [1] luminosità degli occhi, [2] 1 con l'alone rosso
+
+static Mesh s_meshes[EFFECT_TYPE_COUNT];
+static Material s_material;
+static int s_timeLoc, s_effectTypeLoc, s_camRightLoc, s_camUpLoc;
+static bool s_loaded = false;
+static std::vector<Matrix> s_emitters[EFFECT_TYPE_COUNT];
+
+// count quad con vertexPosition = (angolo x, angolo y, indice della particella)
+static Mesh GenEffectMesh(int count) {
+    Mesh mesh = {};
+    mesh.vertexCount = count * 4;
+    mesh.triangleCount = count * 2;
+    mesh.vertices = (float *)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.texcoords = (float *)MemAlloc(mesh.vertexCount * 2 * sizeof(float));
+    mesh.indices = (unsigned short *)MemAlloc(mesh.triangleCount * 3 * sizeof(unsigned short));
+
+    static const float CORNERS[4][2] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+    for (int p = 0; p < count; p++) {
+        for (int c = 0; c < 4; c++) {
+            int v = p * 4 + c;
+            mesh.vertices[v * 3 + 0] = CORNERS[c][0];
+            mesh.vertices[v * 3 + 1] = CORNERS[c][1];
+            mesh.vertices[v * 3 + 2] = (float)p;
+            mesh.texcoords[v * 2 + 0] = CORNERS[c][0] + 0.5f;
+            mesh.texcoords[v * 2 + 1] = CORNERS[c][1] + 0.5f;
+        }
+        unsigned short base = (unsigned short)(p * 4);
+        unsigned short *tri = &mesh.indices[p * 6];
+        tri[0] = base; tri[1] = base + 1; tri[2] = base + 2;
+        tri[3] = base; tri[4] = base + 2; tri[5] = base + 3;
+    }
+
+    UploadMesh(&mesh, false);
+    return mesh;
+}
+
+void InitEffects() {
+    Shader shader = LoadCachedShader("assets/shaders/glsl330/effects.vs", "assets/shaders/glsl330/effects.fs");
+    int instanceLoc = GetShaderLocationAttrib(shader, "instanceTransform");
+    if (shader.id == 0 || instanceLoc < 0) {
+        TraceLog(LOG_WARNING, "⚠️ Effects shader unavailable: monument, portal and eye effects disabled");
+        return;
+    }
+
+    shader.locs[SHADER_LOC_MATRIX_MVP] = GetCachedShaderLocation(shader, "mvp");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = instanceLoc;
+    s_timeLoc = GetCachedShaderLocation(shader, "time");
+    s_effectTypeLoc = GetCachedShaderLocation(shader, "effectType");
+    s_camRightLoc = GetCachedShaderLocation(shader, "camRight");
+    s_camUpLoc = GetCachedShaderLocation(shader, "camUp");
+
+    s_material = LoadMaterialDefault();
+    s_material.shader = shader;
+    for (int t = 0; t < EFFECT_TYPE_COUNT; t++) s_meshes[t] = GenEffectMesh(EFFECT_PARTICLES[t]);
+
+    s_loaded = true;
+    TraceLog(LOG_INFO, "✓ Effects: GPU particle shader loaded (ID: %d)", shader.id);
+}
+
+void PushEffect(EffectType type, const EffectEmitter *emitter) {
+    if (!s_loaded) return;
+
+    // Colonne della matrice d'istanza: posizione + size, colore, parametri
+    Matrix m = {};
+    m.m0 = emitter->position.x;
+    m.m1 = emitter->position.y;
+    m.m2 = emitter->position.z;
+    m.m3 = emitter->size;
+    m.m4 = emitter->color.r / 255.0f;
+    m.m5 = emitter->color.g / 255.0f;
+    m.m6 = emitter->color.b / 255.0f;
+    m.m7 = emitter->color.a / 255.0f;
+    m.m8 = emitter->params[0];
+    m.m9 = emitter->params[1];
+    m.m10 = emitter->params[2];
+    m.m11 = emitter->params[3];
+    s_emitters[type].push_back(m);
+}
+
+void DrawEffects(Camera3D camera) {
+    if (!s_loaded) return;
+
+    // Assi della camera per i quad rivolti verso di lei
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    Vector3 camRight = {view.m0, view.m4, view.m8};
+    Vector3 camUp = {view.m1, view.m5, view.m9};
+    float time = (float)GetTime();
+
+    Shader shader = s_material.shader;
+    SetShaderValue(shader, s_timeLoc, &time, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, s_camRightLoc, &camRight, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, s_camUpLoc, &camUp, SHADER_UNIFORM_VEC3);
+
+    // Trasparenti senza ordinamento: non scrivono la profondità
+    rlDisableDepthMask();
+    rlDisableBackfaceCulling();
+    for (int t = 0; t < EFFECT_TYPE_COUNT; t++) {
+        if (s_emitters[t].empty()) continue;
+        SetShaderValue(shader, s_effectTypeLoc, &t, SHADER_UNIFORM_INT);
+        DrawMeshInstanced(s_meshes[t], s_material, s_emitters[t].data(), (int)s_emitters[t].size());
+        s_emitters[t].clear();
+    }
+    rlEnableBackfaceCulling();
+    rlEnableDepthMask();
+}
+
+void UnloadEffects() {
+    if (!s_loaded) return;
+
+    for (int t = 0; t < EFFECT_TYPE_COUNT; t++) {
+        UnloadMesh(s_meshes[t]);
+        s_emitters[t].clear();
+    }
+    DetachMaterialShader(&s_material);
+    UnloadMaterial(s_material);
+    s_loaded = false;
+}
@@ -0,0 +1,31 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include "raylib.h"
+
+// Tipi di effetto: ognuno è una mesh di quad (una per particella) animata
+// nel vertex shader a partire dal tempo, disegnata con una chiamata
+// instanziata per tipo (un'istanza per emettitore)
+typedef enum EffectType {
+    EFFECT_MONUMENT = 0,     // particelle in orbita, anelli e raggi da attivato, luce in cima
+    EFFECT_PORTAL,           // anelli, spirale, bordo, nucleo, archi, onde
+    EFFECT_WATCHER_EYES,     // due occhi e il loro alone rosso
+    EFFECT_TYPE_COUNT
+} EffectType;
+
+// Parametri di un emettitore, validi per il frame corrente
+typedef struct EffectEmitter {
+    Vector3 position;
+    float size;          // monumento: altezza; portale: raggio corrente; watcher: scala
+    Color color;
+    float params[4];     // per tipo, vedi effects.cpp
+} EffectEmitter;
+
+void InitEffects();
+// Accoda un emettitore per il frame; gli Draw dei sistemi chiamano solo questa
+void PushEffect(EffectType type, const EffectEmitter *emitter);
+// Una chiamata instanziata per tipo, poi svuota le code
+void DrawEffects(Camera3D camera);
+void UnloadEffects();
+
+#endif
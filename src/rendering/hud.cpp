@@ -0,0 +1,167 @@
+#include "hud.h"
+#include "../world/dimensions.h"
+#include "rlgl.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void InitHud(Hud *hud) {
+    *hud = {};
+    hud->target = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
+    hud->dirty = HUD_DIRTY_ALL;
+    hud->debugSampleTime = -HUD_DEBUG_INTERVAL;
+    hud->loaded = hud->target.id > 0;
+    if (!hud->loaded) TraceLog(LOG_WARNING, "⚠️ HUD: render texture unavailable");
+}
+
+void MarkHudDirty(Hud *hud, unsigned int flags) {
+    hud->dirty |= flags;
+}
+
+// Valori del debug arrotondati come vengono stampati
+static void GetDebugKey(const HudDebugInfo *debug, int fps, int *key) {
+    key[0] = fps;
+    key[1] = (int)lroundf(debug->tension * 10.0f);
+    key[2] = debug->watchers;
+    key[3] = debug->monumentsActivated;
+    key[4] = debug->monumentsDiscovered;
+    key[5] = (int)lroundf(debug->chromaticAmount * 10000.0f);
+    key[6] = (int)lroundf(debug->position.x);
+    key[7] = (int)lroundf(debug->position.y);
+    key[8] = (int)lroundf(debug->position.z);
+    key[9] = debug->updatesNear;
+    key[10] = debug->updatesMid;
+    key[11] = debug->updatesFar;
+    key[12] = (int)lroundf(debug->renderScale * 100.0f);
+    key[13] = (int)lroundf(debug->latencyMs * 10.0f);
+}
+
+static void DrawHudDebug(const Hud *hud, const HudContent *content) {
+    const HudDebugInfo *debug = &hud->debug;
+
+    // Come DrawFPS, ma con il valore campionato
+    Color fpsColor = LIME;
+    if (hud->fps < 15) fpsColor = RED;
+    else if (hud->fps < 30) fpsColor = ORANGE;
+    DrawText(TextFormat("%2i FPS", hud->fps), 10, 10, 20, fpsColor);
+
+    char text[512];
+    snprintf(text, sizeof(text),
+             "DIM: %s | Tension: %.1f | Watchers: %d | Monuments: %d/%d\n"
+             "Chromatic: %.4f | Pos: (%.0f,%.0f,%.0f)\n"
+             "Updates near/mid/far: %d/%d/%d | Scale: %d%% | Latency: %.1f ms\n"
+             "Press F for fog debug",
+             content->dimension ? content->dimension->name.c_str() : "?",
+             debug->tension,
+             debug->watchers,
+             debug->monumentsActivated,
+             debug->monumentsDiscovered,
+             debug->chromaticAmount,
+             debug->position.x, debug->position.y, debug->position.z,
+             debug->updatesNear, debug->updatesMid, debug->updatesFar,
+             (int)lroundf(debug->renderScale * 100.0f),
+             debug->latencyMs);
+    DrawText(text, 10, 30, 16, WHITE);
+}
+
+static void DrawHudElements(const Hud *hud, const HudContent *content, int width, int height) {
+    DrawHudDebug(hud, content);
+
+    if (content->portalTarget) {
+        char portalInfo[128];
+        snprintf(portalInfo, sizeof(portalInfo), "Portal Target: %s", content->portalTarget->name.c_str());
+        DrawText(portalInfo, 10, 110, 16, content->portalTarget->grassTopColor);
+    }
+
+    if (content->portalPrompt) {
+        DrawText("Premi [E] per attraversare il portale", width / 2 - 160, height / 2 + 40, 20, RAYWHITE);
+    }
+
+    DrawText("LMB: Mine | RMB: Place | MMB: Portal | TAB: Inventory | 1-9: Hotbar",
+             20, height - 30, 16, LIGHTGRAY);
+
+    if (!content->inventoryOpen) {
+        // Giallo su decorazioni ed entità a portata, bianco altrimenti
+        Color crosshairColor = content->onTarget ? YELLOW : WHITE;
+        DrawLine(width / 2 - 10, height / 2, width / 2 + 10, height / 2, crosshairColor);
+        DrawLine(width / 2, height / 2 - 10, width / 2, height / 2 + 10, crosshairColor);
+    }
+
+    if (content->inventory) {
+        if (content->inventoryOpen) content->inventory->DrawFullInventory();
+        else content->inventory->DrawHotbar();
+    }
+}
+
+static void ComposeHud(const Hud *hud, const HudContent *content) {
+    BeginTextureMode(hud->target);
+    ClearBackground(BLANK);
+
+    // Colore premoltiplicato e alpha accumulato: la texture si compone poi
+    // sulla scena come se gli elementi fossero disegnati direttamente
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    DrawHudElements(hud, content, hud->target.texture.width, hud->target.texture.height);
+    EndBlendMode();
+
+    EndTextureMode();
+}
+
+void UpdateHud(Hud *hud, const HudContent *content) {
+    unsigned int inventoryVersion = content->inventory ? content->inventory->version : 0;
+    if (inventoryVersion != hud->inventoryVersion || content->inventoryOpen != hud->inventoryOpen) {
+        hud->inventoryVersion = inventoryVersion;
+        hud->inventoryOpen = content->inventoryOpen;
+        hud->dirty |= HUD_DIRTY_INVENTORY;
+    }
+    if (content->dimension != hud->dimension || content->portalTarget != hud->portalTarget) {
+        hud->dimension = content->dimension;
+        hud->portalTarget = content->portalTarget;
+        hud->dirty |= HUD_DIRTY_DIMENSION;
+    }
+    if (content->onTarget != hud->onTarget || content->portalPrompt != hud->portalPrompt) {
+        hud->onTarget = content->onTarget;
+        hud->portalPrompt = content->portalPrompt;
+        hud->dirty |= HUD_DIRTY_PROMPT;
+    }
+
+    double now = GetTime();
+    if (now - hud->debugSampleTime >= HUD_DEBUG_INTERVAL) {
+        hud->debugSampleTime = now;
+        int fps = GetFPS();
+        int key[14];
+        GetDebugKey(&content->debug, fps, key);
+        if (memcmp(key, hud->debugKey, sizeof(key)) != 0) {
+            memcpy(hud->debugKey, key, sizeof(key));
+            hud->debug = content->debug;
+            hud->fps = fps;
+            hud->dirty |= HUD_DIRTY_DEBUG;
+        }
+    }
+
+    if (hud->dirty == 0 || !hud->loaded) return;
+    ComposeHud(hud, content);
+    hud->dirty = 0;
+}
+
+void DrawHud(const Hud *hud, const HudContent *content) {
+    // Senza render texture si ridisegna tutto a ogni frame
+    if (!hud->loaded) {
+        DrawHudElements(hud, content, GetScreenWidth(), GetScreenHeight());
+        return;
+    }
+
+    // La texture contiene colori premoltiplicati
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextureRec(hud->target.texture,
+                   (Rectangle){0, 0, (float)hud->target.texture.width, -(float)hud->target.texture.height},
+                   (Vector2){0, 0}, WHITE);
+    EndBlendMode();
+}
+
+void UnloadHud(Hud *hud) {
+    if (!hud->loaded) return;
+    UnloadRenderTexture(hud->target);
+    hud->loaded = false;
+}
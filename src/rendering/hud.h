@@ -0,0 +1,79 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include "raylib.h"
+#include "../gameplay/inventory.h"
+
+struct DimensionConfig;
+
+// Parti dell'HUD: quando una cambia la texture viene ricomposta
+typedef enum HudDirtyFlag {
+    HUD_DIRTY_INVENTORY = 1 << 0,   // slot, quantità, selezione, inventario aperto
+    HUD_DIRTY_DIMENSION = 1 << 1,   // dimensione corrente e bersaglio del portale
+    HUD_DIRTY_DEBUG     = 1 << 2,   // FPS e testo di debug
+    HUD_DIRTY_PROMPT    = 1 << 3,   // colore del mirino e avviso del portale
+    HUD_DIRTY_ALL       = 0xF
+} HudDirtyFlag;
+
+// Valori del testo di debug
+typedef struct HudDebugInfo {
+    float tension;
+    int watchers;
+    int monumentsActivated;
+    int monumentsDiscovered;
+    float chromaticAmount;
+    Vector3 position;
+    int updatesNear, updatesMid, updatesFar;
+    float renderScale;
+    float latencyMs;          // input -> present, media dell'ultima finestra
+} HudDebugInfo;
+
+// Contenuto dell'HUD per il frame corrente
+typedef struct HudContent {
+    const Inventory* inventory;
+    bool inventoryOpen;
+    bool onTarget;                              // mirino giallo
+    bool portalPrompt;
+    const struct DimensionConfig* dimension;
+    const struct DimensionConfig* portalTarget;
+    HudDebugInfo debug;
+} HudContent;
+
+// Campioni del debug al secondo: i valori cambiano a ogni frame
+#define HUD_DEBUG_INTERVAL 0.25
+
+// HUD in modalità retained: testo, mirino e inventario vengono composti in
+// una render texture solo quando una parte è sporca; a regime il frame
+// costa un quad. Le parti animate (avvisi di tensione, barra del mining,
+// transizione di dimensione) restano disegnate a ogni frame dal chiamante.
+typedef struct Hud {
+    RenderTexture2D target;
+    unsigned int dirty;
+
+    // Chiavi dell'ultima composizione
+    unsigned int inventoryVersion;
+    bool inventoryOpen;
+    bool onTarget;
+    bool portalPrompt;
+    const struct DimensionConfig* dimension;
+    const struct DimensionConfig* portalTarget;
+
+    // Debug campionato ogni HUD_DEBUG_INTERVAL, confrontato alla precisione mostrata
+    HudDebugInfo debug;
+    int fps;
+    int debugKey[14];
+    double debugSampleTime;
+
+    bool loaded;
+} Hud;
+
+void InitHud(Hud* hud);
+// Segna sporche le parti indicate (HudDirtyFlag): ricomposte al prossimo UpdateHud
+void MarkHudDirty(Hud* hud, unsigned int flags);
+// Confronta il contenuto con l'ultima composizione e ricompone se serve;
+// da chiamare fuori da BeginTextureMode
+void UpdateHud(Hud* hud, const HudContent* content);
+void DrawHud(const Hud* hud, const HudContent* content);
+void UnloadHud(Hud* hud);
+
+#endif
@@ -0,0 +1,114 @@
+#include "impostor.h"
+#include "shaders.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <math.h>
+
+bool LoadImpostorAtlas(ImpostorAtlas *atlas, int variantCount) {
+    *atlas = {};
+
+    Shader shader = LoadCachedShader("assets/shaders/glsl330/impostor.vs",
+                                     "assets/shaders/glsl330/impostor.fs");
+    int instanceLoc = GetShaderLocationAttrib(shader, "instanceTransform");
+    if (shader.id == 0 || instanceLoc < 0 || variantCount > IMPOSTOR_MAX_VARIANTS) {
+        TraceLog(LOG_WARNING, "⚠️ Impostors unavailable, drawing full geometry at every distance");
+        return false;
+    }
+    shader.locs[SHADER_LOC_MATRIX_MVP] = GetCachedShaderLocation(shader, "mvp");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = instanceLoc;
+
+    atlas->viewPosLoc = GetCachedShaderLocation(shader, "viewPos");
+    atlas->fadeRangeLoc = GetCachedShaderLocation(shader, "fadeRange");
+    atlas->tileLoc = GetCachedShaderLocation(shader, "tile");
+    atlas->boundsLoc = GetCachedShaderLocation(shader, "bounds");
+
+    atlas->target = LoadRenderTexture(IMPOSTOR_VIEWS * IMPOSTOR_TILE_SIZE, variantCount * IMPOSTOR_TILE_SIZE);
+    BeginTextureMode(atlas->target);
+    ClearBackground(BLANK);
+    EndTextureMode();
+
+    // Quad unitario nel piano XZ: lo shader lo raddrizza verso la camera
+    atlas->quad = GenMeshPlane(1.0f, 1.0f, 1, 1);
+    atlas->material = LoadMaterialDefault();
+    atlas->material.shader = shader;
+    atlas->material.maps[MATERIAL_MAP_DIFFUSE].texture = atlas->target.texture;
+
+    atlas->variantCount = variantCount;
+    atlas->loaded = true;
+    return true;
+}
+
+void BakeImpostor(ImpostorAtlas *atlas, int variant, BoundingBox bounds, ImpostorDrawFn draw, void *user) {
+    if (!atlas->loaded || variant < 0 || variant >= atlas->variantCount) return;
+
+    // Quad quadrato che contiene l'oggetto da ogni angolo attorno a Y
+    float reachX = fmaxf(fabsf(bounds.min.x), fabsf(bounds.max.x));
+    float reachZ = fmaxf(fabsf(bounds.min.z), fabsf(bounds.max.z));
+    float horizontal = sqrtf(reachX * reachX + reachZ * reachZ);
+    float radius = fmaxf(horizontal, (bounds.max.y - bounds.min.y) * 0.5f) * 1.05f;
+    float centerY = (bounds.min.y + bounds.max.y) * 0.5f;
+
+    atlas->centerY[variant] = centerY;
+    atlas->radius[variant] = radius;
+
+    BeginTextureMode(atlas->target);
+    rlEnableDepthTest();
+
+    for (int k = 0; k < IMPOSTOR_VIEWS; k++) {
+        rlDrawRenderBatchActive();
+        rlViewport(k * IMPOSTOR_TILE_SIZE, variant * IMPOSTOR_TILE_SIZE, IMPOSTOR_TILE_SIZE, IMPOSTOR_TILE_SIZE);
+
+        // Vista k: camera ortografica nella direzione (sin a, 0, cos a), come la campiona lo shader
+        float angle = 2.0f * PI * k / IMPOSTOR_VIEWS;
+        Vector3 center = {0.0f, centerY, 0.0f};
+        Vector3 eye = {sinf(angle) * (2.0f * radius + 1.0f), centerY, cosf(angle) * (2.0f * radius + 1.0f)};
+
+        rlMatrixMode(RL_PROJECTION);
+        rlLoadIdentity();
+        rlOrtho(-radius, radius, -radius, radius, 0.01, 4.0f * radius + 2.0f);
+        rlMatrixMode(RL_MODELVIEW);
+        rlLoadIdentity();
+        rlMultMatrixf(MatrixToFloat(MatrixLookAt(eye, center, (Vector3){0.0f, 1.0f, 0.0f})));
+
+        draw(user, variant);
+    }
+
+    rlDrawRenderBatchActive();
+    rlDisableDepthTest();
+    EndTextureMode();
+
+    GenTextureMipmaps(&atlas->target.texture);
+    SetTextureFilter(atlas->target.texture, TEXTURE_FILTER_TRILINEAR);
+    atlas->material.maps[MATERIAL_MAP_DIFFUSE].texture = atlas->target.texture;
+}
+
+void DrawImpostors(ImpostorAtlas *atlas, int variant, const Matrix *transforms, int count,
+                   Camera3D camera, float fadeStart, float fadeEnd) {
+    if (!atlas->loaded || count <= 0) return;
+
+    Shader shader = atlas->material.shader;
+    float fadeRange[2] = {fadeStart, fadeEnd};
+    float tile[3] = {(float)variant, (float)atlas->variantCount, (float)IMPOSTOR_VIEWS};
+    float bounds[2] = {atlas->centerY[variant], atlas->radius[variant]};
+    SetShaderValue(shader, atlas->viewPosLoc, &camera.position, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, atlas->fadeRangeLoc, fadeRange, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, atlas->tileLoc, tile, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, atlas->boundsLoc, bounds, SHADER_UNIFORM_VEC2);
+
+    // Il quad ruota con la camera: il verso delle facce non è stabile
+    rlDisableBackfaceCulling();
+    DrawMeshInstanced(atlas->quad, atlas->material, transforms, count);
+    rlEnableBackfaceCulling();
+}
+
+void UnloadImpostorAtlas(ImpostorAtlas *atlas) {
+    if (!atlas->loaded) return;
+
+    // La texture dell'atlante appartiene alla render texture, non al materiale
+    atlas->material.maps[MATERIAL_MAP_DIFFUSE].texture.id = rlGetTextureIdDefault();
+    DetachMaterialShader(&atlas->material);
+    UnloadMaterial(atlas->material);
+    UnloadMesh(atlas->quad);
+    UnloadRenderTexture(atlas->target);
+    atlas->loaded = false;
+}
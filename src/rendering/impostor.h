@@ -0,0 +1,39 @@
+#ifndef IMPOSTOR_H
+#define IMPOSTOR_H
+
+#include "raylib.h"
+
+// Viste per variante (attorno all'asse Y) e lato in pixel di ogni vista
+#define IMPOSTOR_VIEWS 8
+#define IMPOSTOR_TILE_SIZE 128
+#define IMPOSTOR_MAX_VARIANTS 8
+
+// Atlante di impostor: ogni variante è una riga di IMPOSTOR_VIEWS immagini
+// dell'oggetto viste da angoli diversi, renderizzate una volta al caricamento.
+// Da lontano le istanze diventano quad rivolti alla camera che campionano la
+// vista più vicina all'angolo reale; nella fascia di passaggio geometria e
+// impostor si dissolvono a retino complementare, senza ordinamento.
+typedef struct ImpostorAtlas {
+    RenderTexture2D target;
+    Mesh quad;
+    Material material;
+    int variantCount;
+    float centerY[IMPOSTOR_MAX_VARIANTS];   // centro del quad sopra l'origine (scala 1)
+    float radius[IMPOSTOR_MAX_VARIANTS];    // mezzo lato del quad (scala 1)
+    int viewPosLoc, fadeRangeLoc, tileLoc, boundsLoc;
+    bool loaded;
+} ImpostorAtlas;
+
+// Disegna la variante all'origine, con scala 1 e senza rotazione
+typedef void (*ImpostorDrawFn)(void *user, int variant);
+
+// false se lo shader degli impostor non è disponibile: il chiamante resta sulla geometria
+bool LoadImpostorAtlas(ImpostorAtlas *atlas, int variantCount);
+void BakeImpostor(ImpostorAtlas *atlas, int variant, BoundingBox bounds, ImpostorDrawFn draw, void *user);
+// Una chiamata instanziata per variante; le matrici sono quelle del modello
+// (scala uniforme, rotazione attorno a Y, traslazione)
+void DrawImpostors(ImpostorAtlas *atlas, int variant, const Matrix *transforms, int count,
+                   Camera3D camera, float fadeStart, float fadeEnd);
+void UnloadImpostorAtlas(ImpostorAtlas *atlas);
+
+#endif
@@ -1,15 +1,313 @@
 #include "shaders.h"
+#include "rlgl.h"
+#include <filesystem>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-Shader terrainShader;  // definizione reale della variabile globale
+// ---------- FUNZIONI GL DEI BINARI ----------
+// rlgl non espone glGetProgramBinary/glProgramBinary: si caricano dal
+// contesto creato da raylib (GLFW è compilato dentro la libreria)
+#if defined(_WIN32)
+#define SHADER_GL_API __stdcall
+#else
+#define SHADER_GL_API
+#endif
 
-void LoadTerrainShader() {
-    terrainShader = LoadShader("assets/shaders/terrain.vs", "assets/shaders/terrain.fs");
+#define GL_LINK_STATUS 0x8B82
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_VENDOR 0x1F00
+#define GL_RENDERER 0x1F01
+#define GL_VERSION 0x1F02
 
-    // Imposta luce direzionale
-    float dir[3] = {-0.5f, -1.0f, -0.5f};
-    SetShaderValue(terrainShader, GetShaderLocation(terrainShader, "lightDir"), dir, SHADER_UNIFORM_VEC3);
+typedef void (SHADER_GL_API *GetIntegervFn)(unsigned int pname, int *data);
+typedef void (SHADER_GL_API *GetProgramivFn)(unsigned int program, unsigned int pname, int *params);
+typedef void (SHADER_GL_API *GetProgramBinaryFn)(unsigned int program, int bufSize, int *length,
+                                                 unsigned int *binaryFormat, void *binary);
+typedef void (SHADER_GL_API *ProgramBinaryFn)(unsigned int program, unsigned int binaryFormat,
+                                              const void *binary, int length);
+typedef unsigned int (SHADER_GL_API *CreateProgramFn)(void);
+typedef void (SHADER_GL_API *DeleteProgramFn)(unsigned int program);
+typedef const unsigned char *(SHADER_GL_API *GetStringFn)(unsigned int name);
+
+extern "C" void *glfwGetProcAddress(const char *procname);
+
+static GetProgramivFn s_glGetProgramiv;
+static GetProgramBinaryFn s_glGetProgramBinary;
+static ProgramBinaryFn s_glProgramBinary;
+static CreateProgramFn s_glCreateProgram;
+static DeleteProgramFn s_glDeleteProgram;
+static bool s_registryInitialized = false;
+static bool s_binariesSupported = false;
+static uint64_t s_driverHash = 0;
+
+// ---------- REGISTRO ----------
+typedef struct ShaderEntry {
+    char vsPath[128];
+    char fsPath[128];
+    char defines[128];
+    Shader shader;
+    int uniformCount;
+    char uniformNames[SHADER_MAX_CACHED_UNIFORMS][32];
+    int uniformLocs[SHADER_MAX_CACHED_UNIFORMS];
+} ShaderEntry;
+
+static ShaderEntry s_entries[SHADER_REGISTRY_MAX];
+static int s_entryCount = 0;
+static int s_fromBinary = 0;
+static int s_compiled = 0;
+
+typedef struct ShaderBinaryHeader {
+    char magic[4];
+    int version;
+    unsigned int format;
+    int length;
+    uint64_t key;
+} ShaderBinaryHeader;
+
+static const char SHADER_BINARY_MAGIC[4] = {'D', 'W', 'S', 'B'};
+
+// FNV-1a: basta a distinguere sorgenti e driver, non serve altro
+static uint64_t HashBytes(uint64_t hash, const char *data) {
+    if (!data) return hash;
+    for (const unsigned char *p = (const unsigned char *)data; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash * 1099511628211ULL;
+}
+
+void InitShaderRegistry(void) {
+    if (s_registryInitialized) return;
+    s_registryInitialized = true;
+
+    GetIntegervFn getIntegerv = (GetIntegervFn)glfwGetProcAddress("glGetIntegerv");
+    GetStringFn getString = (GetStringFn)glfwGetProcAddress("glGetString");
+    s_glGetProgramiv = (GetProgramivFn)glfwGetProcAddress("glGetProgramiv");
+    s_glGetProgramBinary = (GetProgramBinaryFn)glfwGetProcAddress("glGetProgramBinary");
+    s_glProgramBinary = (ProgramBinaryFn)glfwGetProcAddress("glProgramBinary");
+    s_glCreateProgram = (CreateProgramFn)glfwGetProcAddress("glCreateProgram");
+    s_glDeleteProgram = (DeleteProgramFn)glfwGetProcAddress("glDeleteProgram");
+
+    int formats = 0;
+    if (getIntegerv && getString && s_glGetProgramiv && s_glGetProgramBinary &&
+        s_glProgramBinary && s_glCreateProgram && s_glDeleteProgram) {
+        getIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    s_binariesSupported = formats > 0;
+
+    if (s_binariesSupported) {
+        // Un binario vale solo per lo stesso driver: entra nella chiave del file
+        s_driverHash = 14695981039346656037ULL;
+        s_driverHash = HashBytes(s_driverHash, (const char *)getString(GL_VENDOR));
+        s_driverHash = HashBytes(s_driverHash, (const char *)getString(GL_RENDERER));
+        s_driverHash = HashBytes(s_driverHash, (const char *)getString(GL_VERSION));
+
+        std::error_code err;
+        std::filesystem::create_directories(SHADER_CACHE_DIR, err);
+        TraceLog(LOG_INFO, "✓ Shader registry: program binaries cached in %s", SHADER_CACHE_DIR);
+    } else {
+        TraceLog(LOG_INFO, "Shader registry: program binaries unsupported, compiling from source");
+    }
 }
 
-void UnloadTerrainShader() {
-    UnloadShader(terrainShader);
+static void GetBinaryPath(uint64_t key, char *path, size_t size) {
+    snprintf(path, size, "%s/%016llx.bin", SHADER_CACHE_DIR, (unsigned long long)key);
+}
+
+// Posizioni standard di raylib, come le imposta LoadShaderFromMemory
+static void SetDefaultLocations(Shader *shader) {
+    shader->locs = (int *)MemAlloc(RL_MAX_SHADER_LOCATIONS * sizeof(int));
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader->locs[i] = -1;
+
+    shader->locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(shader->id, "vertexPosition");
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD01] = rlGetLocationAttrib(shader->id, "vertexTexCoord");
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD02] = rlGetLocationAttrib(shader->id, "vertexTexCoord2");
+    shader->locs[SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib(shader->id, "vertexNormal");
+    shader->locs[SHADER_LOC_VERTEX_TANGENT] = rlGetLocationAttrib(shader->id, "vertexTangent");
+    shader->locs[SHADER_LOC_VERTEX_COLOR] = rlGetLocationAttrib(shader->id, "vertexColor");
+
+    shader->locs[SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform(shader->id, "mvp");
+    shader->locs[SHADER_LOC_MATRIX_VIEW] = rlGetLocationUniform(shader->id, "matView");
+    shader->locs[SHADER_LOC_MATRIX_PROJECTION] = rlGetLocationUniform(shader->id, "matProjection");
+    shader->locs[SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform(shader->id, "matModel");
+    shader->locs[SHADER_LOC_MATRIX_NORMAL] = rlGetLocationUniform(shader->id, "matNormal");
+    shader->locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(shader->id, "colDiffuse");
+    shader->locs[SHADER_LOC_MAP_DIFFUSE] = rlGetLocationUniform(shader->id, "texture0");
+    shader->locs[SHADER_LOC_MAP_SPECULAR] = rlGetLocationUniform(shader->id, "texture1");
+    shader->locs[SHADER_LOC_MAP_NORMAL] = rlGetLocationUniform(shader->id, "texture2");
+}
+
+static bool LoadShaderBinary(uint64_t key, Shader *shader) {
+    char path[256];
+    GetBinaryPath(key, path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    ShaderBinaryHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+              memcmp(header.magic, SHADER_BINARY_MAGIC, 4) == 0 &&
+              header.version == SHADER_CACHE_VERSION &&
+              header.key == key && header.length > 0;
+    void *data = ok ? malloc(header.length) : NULL;
+    ok = ok && data && fread(data, 1, header.length, f) == (size_t)header.length;
+    fclose(f);
+
+    unsigned int program = 0;
+    if (ok) {
+        program = s_glCreateProgram();
+        s_glProgramBinary(program, header.format, data, header.length);
+        int linked = 0;
+        s_glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        // Driver aggiornato o binario rifiutato: si ricompila dai sorgenti
+        if (!linked) {
+            s_glDeleteProgram(program);
+            ok = false;
+        }
+    }
+    free(data);
+    if (!ok) return false;
+
+    shader->id = program;
+    SetDefaultLocations(shader);
+    return true;
+}
+
+static void SaveShaderBinary(uint64_t key, Shader shader) {
+    int length = 0;
+    s_glGetProgramiv(shader.id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    ShaderBinaryHeader header;
+    memcpy(header.magic, SHADER_BINARY_MAGIC, 4);
+    header.version = SHADER_CACHE_VERSION;
+    header.key = key;
+    void *data = malloc(length);
+    if (!data) return;
+    s_glGetProgramBinary(shader.id, length, &header.length, &header.format, data);
+
+    char path[256];
+    GetBinaryPath(key, path, sizeof(path));
+    FILE *f = fopen(path, "wb");
+    if (f) {
+        bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+                  fwrite(data, 1, header.length, f) == (size_t)header.length;
+        fclose(f);
+        if (!ok) remove(path);
+    }
+    free(data);
+}
+
+// Sorgente con i defines subito dopo la riga #version (malloc, NULL se manca il file)
+static char *LoadShaderSource(const char *path, const char *defines) {
+    char *text = LoadFileText(path);
+    if (!text) return NULL;
+
+    size_t textLength = strlen(text);
+    size_t definesLength = strlen(defines);
+    char *code = (char *)malloc(textLength + definesLength + 1);
+    if (!code) {
+        UnloadFileText(text);
+        return NULL;
+    }
+
+    size_t split = 0;
+    if (strncmp(text, "#version", 8) == 0) {
+        const char *newline = strchr(text, '\n');
+        split = newline ? (size_t)(newline - text) + 1 : textLength;
+    }
+    memcpy(code, text, split);
+    memcpy(code + split, defines, definesLength);
+    memcpy(code + split + definesLength, text + split, textLength - split + 1);
+    UnloadFileText(text);
+    return code;
+}
+
+Shader LoadCachedShader(const char *vsPath, const char *fsPath) {
+    return LoadCachedShaderVariant(vsPath, fsPath, "");
+}
+
+Shader LoadCachedShaderVariant(const char *vsPath, const char *fsPath, const char *defines) {
+    for (int i = 0; i < s_entryCount; i++) {
+        if (strcmp(s_entries[i].vsPath, vsPath) == 0 && strcmp(s_entries[i].fsPath, fsPath) == 0 &&
+            strcmp(s_entries[i].defines, defines) == 0)
+            return s_entries[i].shader;
+    }
+
+    char *vsCode = LoadShaderSource(vsPath, defines);
+    char *fsCode = LoadShaderSource(fsPath, defines);
+    uint64_t key = s_driverHash;
+    key = HashBytes(key, vsCode);
+    key = HashBytes(key, fsCode);
+
+    Shader shader = {};
+    if (s_binariesSupported && vsCode && fsCode && LoadShaderBinary(key, &shader)) {
+        s_fromBinary++;
+    } else {
+        shader = LoadShaderFromMemory(vsCode, fsCode);
+        s_compiled++;
+        if (s_binariesSupported && shader.id > 0 && shader.id != rlGetShaderIdDefault())
+            SaveShaderBinary(key, shader);
+    }
+    free(vsCode);
+    free(fsCode);
+
+    if (s_entryCount >= SHADER_REGISTRY_MAX) {
+        TraceLog(LOG_WARNING, "⚠️ Shader registry full: %s not cached", fsPath);
+        return shader;
+    }
+
+    ShaderEntry *entry = &s_entries[s_entryCount++];
+    memset(entry, 0, sizeof(*entry));
+    snprintf(entry->vsPath, sizeof(entry->vsPath), "%s", vsPath);
+    snprintf(entry->fsPath, sizeof(entry->fsPath), "%s", fsPath);
+    snprintf(entry->defines, sizeof(entry->defines), "%s", defines);
+    entry->shader = shader;
+    return shader;
+}
+
+int GetCachedShaderLocation(Shader shader, const char *uniformName) {
+    ShaderEntry *entry = NULL;
+    for (int i = 0; i < s_entryCount && !entry; i++) {
+        if (s_entries[i].shader.id == shader.id) entry = &s_entries[i];
+    }
+    if (!entry) return GetShaderLocation(shader, uniformName);
+
+    for (int i = 0; i < entry->uniformCount; i++) {
+        if (strcmp(entry->uniformNames[i], uniformName) == 0) return entry->uniformLocs[i];
+    }
+
+    int loc = GetShaderLocation(shader, uniformName);
+    if (entry->uniformCount < SHADER_MAX_CACHED_UNIFORMS && strlen(uniformName) < sizeof(entry->uniformNames[0])) {
+        strcpy(entry->uniformNames[entry->uniformCount], uniformName);
+        entry->uniformLocs[entry->uniformCount] = loc;
+        entry->uniformCount++;
+    }
+    return loc;
+}
+
+void DetachMaterialShader(Material *material) {
+    material->shader.id = rlGetShaderIdDefault();
+    material->shader.locs = rlGetShaderLocsDefault();
+}
+
+void UnloadShaderRegistry(void) {
+    TraceLog(LOG_INFO, "Shader registry: %d programs (%d from binary cache, %d compiled)",
+             s_entryCount, s_fromBinary, s_compiled);
+    for (int i = 0; i < s_entryCount; i++) UnloadShader(s_entries[i].shader);
+    s_entryCount = 0;
+    s_fromBinary = 0;
+    s_compiled = 0;
+}
+
+Shader LoadTerrainShader(unsigned int variant) {
+    char defines[128] = "";
+    if (variant & TERRAIN_VARIANT_FOG) strcat(defines, "#define TERRAIN_FOG\n");
+    if (variant & TERRAIN_VARIANT_TEXTURED) strcat(defines, "#define TERRAIN_TEXTURED\n");
+    if (variant & TERRAIN_VARIANT_WATER) strcat(defines, "#define TERRAIN_WATER\n");
+
+    return LoadCachedShaderVariant("assets/shaders/glsl330/terrain.vs",
+                                   "assets/shaders/glsl330/terrain.fs", defines);
 }
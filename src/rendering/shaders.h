@@ -4,10 +4,36 @@
 
 #include <raylib.h>
 
-extern Shader terrainShader;
+#define SHADER_REGISTRY_MAX 24
+#define SHADER_MAX_CACHED_UNIFORMS 16
+#define SHADER_CACHE_DIR "cache/shaders"
+#define SHADER_CACHE_VERSION 1
 
-void LoadTerrainShader();
-void UnloadTerrainShader();
+// Registro dei programmi: ogni coppia vs/fs viene compilata una sola volta per
+// processo e condivisa da chi la chiede (cambi di dimensione compresi). Se il
+// driver lo supporta il binario GL del programma finisce in SHADER_CACHE_DIR e
+// agli avvii successivi la compilazione viene saltata. Gli shader restituiti
+// appartengono al registro: niente UnloadShader, e DetachMaterialShader prima
+// di UnloadMaterial.
+void InitShaderRegistry(void);
+Shader LoadCachedShader(const char *vsPath, const char *fsPath);
+// Variante dello stesso sorgente: le righe di defines (es. "#define FOG\n")
+// vengono inserite dopo #version, e ogni combinazione è un programma a sé
+Shader LoadCachedShaderVariant(const char *vsPath, const char *fsPath, const char *defines);
+// Come GetShaderLocation, con le posizioni ricordate per programma
+int GetCachedShaderLocation(Shader shader, const char *uniformName);
+// Rimette lo shader di default sul materiale, così UnloadMaterial non scarica
+// quello del registro
+void DetachMaterialShader(Material *material);
+void UnloadShaderRegistry(void);
 
-#endif
+// Varianti dello shader del terreno (assets/shaders/glsl330/terrain.*)
+typedef enum TerrainVariantFlag {
+    TERRAIN_VARIANT_FOG = 1 << 0,
+    TERRAIN_VARIANT_TEXTURED = 1 << 1,
+    TERRAIN_VARIANT_WATER = 1 << 2,
+} TerrainVariantFlag;
+
+Shader LoadTerrainShader(unsigned int variant);
 
+#endif
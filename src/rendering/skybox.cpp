@@ -6,9 +6,12 @@
 Skybox LoadSkybox(const char *imagePath, Color tint) {
     Skybox skybox = {};
     
+    // Stesso file della dimensione: l'AssetCache restituisce la texture già caricata
     if (FileExists(imagePath)) {
-        skybox.texture = LoadTexture(imagePath);
-    } else {
+        skybox.handle = AssetCache::Get().AcquireTexture(imagePath);
+        skybox.texture = AssetCache::Get().GetTexture(skybox.handle);
+    }
+    if (skybox.texture.id == 0) {
         Image img = GenImageColor(512, 512, tint);
         ImageDrawRectangleLines(&img, (Rectangle){0, 0, 512, 512}, 5, Fade(tint, 0.5f));
         skybox.texture = LoadTextureFromImage(img);
@@ -44,6 +47,10 @@ void DrawSkybox(Skybox skybox, Camera3D camera) {
 }
 
 void UnloadSkybox(Skybox skybox) {
-    UnloadTexture(skybox.texture);
+    if (skybox.handle.IsValid()) {
+        AssetCache::Get().Release(skybox.handle);
+    } else {
+        UnloadTexture(skybox.texture);
+    }
     UnloadMesh(skybox.mesh);
 }
\ No newline at end of file
@@ -2,12 +2,14 @@
 #define SKYBOX_H
 
 #include "raylib.h"
+#include "../core/assetCache.h"
 
 // Forward declaration - NON includere dimensions.h qui per evitare dipendenze circolari
 struct DimensionConfig;
 
 typedef struct {
     Texture2D texture;
+    TextureHandle handle;   // nullo se la texture è generata (file mancante)
     Mesh mesh;
     Color tint;
 } Skybox;
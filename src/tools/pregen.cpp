@@ -0,0 +1,154 @@
+// Pre-generazione offline del mondo: genera i chunk attorno allo spawn per
+// ogni dimensione (altezze, voxel, minerali, e a richiesta le mesh) e li salva
+// in cache/world, letti dal gioco all'avvio. Le decorazioni non hanno stato
+// proprio: sono funzione del seed e delle altezze del chunk, e il gioco le
+// ricostruisce dal chunk in cache quando entra nel raggio di vista.
+// Non apre finestre né contesti GL.
+//
+// Uso: ./build/pregen [--radius N] [--meshes] [--dim ID] [--threads N]
+
+#include "raylib.h"
+#include "../world/firstWorld.h"
+#include "../world/dimensions.h"
+#include "../world/worldCache.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+// Chunk in un quadrato (2r+1)^2: oltre CHUNK_KEEP_DISTANCE il gioco li scaricherebbe subito
+#define PREGEN_MAX_RADIUS CHUNK_KEEP_DISTANCE
+
+struct PregenOptions {
+    int radius = RENDER_DISTANCE + 1;
+    bool meshes = false;
+    int dimensionId = -1;  // -1 = tutte
+    int threads = 0;       // 0 = tutti i core
+};
+
+static void PrintUsage() {
+    printf("Usage: pregen [--radius N] [--meshes] [--dim ID] [--threads N]\n");
+    printf("  --radius N   chunk radius around spawn (default %d, max %d)\n", RENDER_DISTANCE + 1, PREGEN_MAX_RADIUS);
+    printf("  --meshes     also store chunk meshes\n");
+    printf("  --dim ID     only this dimension (default: all)\n");
+    printf("  --threads N  worker threads (default: all cores)\n");
+}
+
+static bool ParseOptions(int argc, char** argv, PregenOptions* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--radius") == 0 && i + 1 < argc) {
+            opt->radius = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--meshes") == 0) {
+            opt->meshes = true;
+        } else if (strcmp(argv[i], "--dim") == 0 && i + 1 < argc) {
+            opt->dimensionId = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            opt->threads = atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+
+    if (opt->radius < 0) opt->radius = 0;
+    if (opt->radius > PREGEN_MAX_RADIUS) opt->radius = PREGEN_MAX_RADIUS;
+    if (opt->threads <= 0) opt->threads = (int)std::thread::hardware_concurrency();
+    if (opt->threads <= 0) opt->threads = 1;
+    return true;
+}
+
+// Le mesh non vengono mai caricate sulla GPU: libera solo gli array CPU
+static void FreeChunkMeshData(Chunk* c) {
+    free(c->mesh.vertices);
+    free(c->mesh.normals);
+    free(c->mesh.texcoords);
+    free(c->mesh.colors);
+    memset(&c->mesh, 0, sizeof(Mesh));
+}
+
+// Secondi trascorsi da start: GetTime di raylib richiede una finestra aperta
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool PregenDimension(DimensionConfig* dim, const PregenOptions& opt) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Configurazione globale del generatore: letta in sola lettura dai worker
+    SetWorldDimension(dim->terrainSeed);
+    SetWorldBiomes(dim);
+    SetWorldTerrainMode(dim->useDensityTerrain);
+    SetDimensionColors(dim->grassTopColor, dim->dirtSideColor, dim->dirtColor);
+
+    World* world = new World;
+    WorldInit(world);
+
+    // Gli slot dei chunk vengono creati in serie, poi riempiti in parallelo
+    std::vector<Chunk*> pending;
+    for (int x = -opt.radius; x <= opt.radius; x++) {
+        for (int z = -opt.radius; z <= opt.radius; z++) {
+            Chunk* c = WorldGetChunk(world, x, z);
+            if (c) pending.push_back(c);
+        }
+    }
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int i = next++; i < (int)pending.size(); i = next++) {
+            WorldGenerateChunkData(pending[i]);
+            if (opt.meshes) WorldBuildChunkMesh(pending[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < opt.threads; t++) threads.emplace_back(worker);
+    for (std::thread& t : threads) t.join();
+
+    // Decorazioni escluse: vengono ricostruite dalle altezze salvate qui
+    std::string path = GetWorldCachePath(dim);
+    bool ok = WorldCacheSave(path.c_str(), dim, world, opt.meshes);
+
+    if (opt.meshes) {
+        for (Chunk* c : pending) FreeChunkMeshData(c);
+    }
+    WorldCleanup(world);
+    delete world;
+
+    if (ok) {
+        TraceLog(LOG_INFO, "✓ %s: %d chunks -> %s (%.2fs)", dim->name.c_str(),
+                 (int)pending.size(), path.c_str(), SecondsSince(start));
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    PregenOptions opt;
+    if (!ParseOptions(argc, argv, &opt)) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::error_code err;
+    std::filesystem::create_directories(WORLD_CACHE_DIR, err);
+    if (err) {
+        TraceLog(LOG_ERROR, "pregen: cannot create %s", WORLD_CACHE_DIR);
+        return 1;
+    }
+
+    DimensionManager dimensionManager;
+    dimensionManager.Initialize();
+
+    TraceLog(LOG_INFO, "pregen: radius %d, %d threads%s", opt.radius, opt.threads,
+             opt.meshes ? ", with meshes" : "");
+
+    int failures = 0;
+    for (DimensionConfig& dim : dimensionManager.dimensions) {
+        if (opt.dimensionId >= 0 && dim.id != opt.dimensionId) continue;
+        if (!PregenDimension(&dim, opt)) failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#include "biomes.h"
+#include "stb_perlin.h"
+#include <math.h>
+
+void BiomeMapInit(BiomeMap* map, int seed, const std::vector<BiomeConfig>& biomes) {
+    map->seed = seed;
+    map->biomes = biomes;
+
+    // Dimensione senza biomi: un unico bioma con i parametri storici
+    if (map->biomes.empty()) {
+        BiomeConfig fallback;
+        fallback.name = "Default";
+        map->biomes.push_back(fallback);
+    }
+}
+
+int BiomeMapGetNodeBiome(const BiomeMap* map, int nodeX, int nodeZ) {
+    int count = (int)map->biomes.size();
+    if (count <= 1) return 0;
+
+    // Rumore a bassa frequenza sui nodi: biomi grandi qualche centinaio di blocchi
+    float n = stb_perlin_noise3(nodeX * 0.37f, 30 + map->seed, nodeZ * 0.37f, 0, 0, 0);
+    float t = n * 0.9f + 0.5f;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 0.999f) t = 0.999f;
+
+    return (int)(t * count);
+}
+
+const BiomeConfig* BiomeMapGetBiomeAt(const BiomeMap* map, float x, float z) {
+    int nodeX = (int)floorf(x / BIOME_CELL_SIZE + 0.5f);
+    int nodeZ = (int)floorf(z / BIOME_CELL_SIZE + 0.5f);
+    return &map->biomes[BiomeMapGetNodeBiome(map, nodeX, nodeZ)];
+}
+
+void BiomeMapBuildPatch(const BiomeMap* map, int minX, int minZ, BiomePatch* patch) {
+    patch->originX = (int)floorf((float)minX / BIOME_CELL_SIZE);
+    patch->originZ = (int)floorf((float)minZ / BIOME_CELL_SIZE);
+
+    for (int i = 0; i < BIOME_PATCH_NODES; i++) {
+        for (int j = 0; j < BIOME_PATCH_NODES; j++) {
+            int biome = BiomeMapGetNodeBiome(map, patch->originX + i, patch->originZ + j);
+            patch->nodes[i][j] = map->biomes[biome].params;
+        }
+    }
+}
+
+BiomeParams BiomePatchSample(const BiomePatch* patch, float x, float z) {
+    float gx = x / BIOME_CELL_SIZE - patch->originX;
+    float gz = z / BIOME_CELL_SIZE - patch->originZ;
+
+    int i = (int)floorf(gx);
+    int j = (int)floorf(gz);
+    if (i < 0) i = 0;
+    if (j < 0) j = 0;
+    if (i > BIOME_PATCH_NODES - 2) i = BIOME_PATCH_NODES - 2;
+    if (j > BIOME_PATCH_NODES - 2) j = BIOME_PATCH_NODES - 2;
+
+    float tx = gx - i;
+    float tz = gz - j;
+
+    const BiomeParams& a = patch->nodes[i][j];
+    const BiomeParams& b = patch->nodes[i + 1][j];
+    const BiomeParams& c = patch->nodes[i][j + 1];
+    const BiomeParams& d = patch->nodes[i + 1][j + 1];
+
+    float wa = (1.0f - tx) * (1.0f - tz);
+    float wb = tx * (1.0f - tz);
+    float wc = (1.0f - tx) * tz;
+    float wd = tx * tz;
+
+    BiomeParams out;
+    out.heightScale = a.heightScale * wa + b.heightScale * wb + c.heightScale * wc + d.heightScale * wd;
+    out.heightOffset = a.heightOffset * wa + b.heightOffset * wb + c.heightOffset * wc + d.heightOffset * wd;
+    out.roughness = a.roughness * wa + b.roughness * wb + c.roughness * wc + d.roughness * wd;
+    return out;
+}
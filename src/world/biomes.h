@@ -0,0 +1,53 @@
+#ifndef BIOMES_H
+#define BIOMES_H
+
+#include "raylib.h"
+#include <string>
+#include <vector>
+
+// Distanza (in blocchi) tra i nodi della griglia dei biomi.
+// Deve essere >= CHUNK_SIZE: un chunk tocca al massimo 3x3 nodi.
+#define BIOME_CELL_SIZE 32
+#define BIOME_PATCH_NODES 3
+
+// Parametri di generazione interpolabili tra biomi vicini
+typedef struct BiomeParams {
+    float heightScale;   // moltiplica l'ampiezza del rumore
+    float heightOffset;  // altezza base del terreno
+    float roughness;     // peso dell'ottava di dettaglio
+} BiomeParams;
+
+struct BiomeConfig {
+    std::string name;
+    BiomeParams params{1.0f, 5.0f, 1.0f};
+
+    // Densità decorazioni: oggetti per area 100x100 blocchi
+    int treeCount{0};
+    int rockCount{0};
+    int crystalCount{0};
+};
+
+typedef struct BiomeMap {
+    int seed;
+    std::vector<BiomeConfig> biomes;
+} BiomeMap;
+
+// Nodi della griglia che coprono un chunk, valutati una volta sola
+// prima di generare le colonne del chunk
+typedef struct BiomePatch {
+    int originX, originZ;  // primo nodo (coordinate griglia)
+    BiomeParams nodes[BIOME_PATCH_NODES][BIOME_PATCH_NODES];
+} BiomePatch;
+
+void BiomeMapInit(BiomeMap* map, int seed, const std::vector<BiomeConfig>& biomes);
+
+// Bioma assegnato a un nodo della griglia (funzione pura del seed)
+int BiomeMapGetNodeBiome(const BiomeMap* map, int nodeX, int nodeZ);
+// Bioma dominante in un punto del mondo (nodo più vicino)
+const BiomeConfig* BiomeMapGetBiomeAt(const BiomeMap* map, float x, float z);
+
+void BiomeMapBuildPatch(const BiomeMap* map, int minX, int minZ, BiomePatch* patch);
+// Interpolazione bilineare dei parametri: solo 4 letture per colonna
+BiomeParams BiomePatchSample(const BiomePatch* patch, float x, float z);
+
+#endif
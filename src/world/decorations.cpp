@@ -1,75 +1,133 @@
 #include "decorations.h"
 #include <raymath.h>
 #include <stdlib.h>
-#include <time.h>
 #include "raylib.h"   // Core Raylib
 #include "raymath.h"
 #include "../gameplay/dropped_item.h"
-bool MineDecoration(DecorationSystem* ds, DecorationMiningState* mining, Camera3D cam, float deltaTime) {
-    if (!IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
-        mining->mining = false;
-        mining->progress = 0.0f;
-        return false;
+#include "../core/random.h"
+#include "../core/spatialIndex.h"
+#include "../gameplay/interaction.h"
+#include "../rendering/shaders.h"
+
+// Fascia (m, in XZ) in cui alberi e rocce passano dalla geometria agli impostor
+#define DECORATION_IMPOSTOR_START 48.0f
+#define DECORATION_IMPOSTOR_END 56.0f
+// Inizio dissolvenza per i batch che non la usano: mai raggiunto
+#define DECORATION_NO_FADE 1.0e6f
+// Righe dell'atlante
+#define DECORATION_IMPOSTOR_TREE 0
+#define DECORATION_IMPOSTOR_ROCK 1
+
+// Box di collisione di una decorazione (tronco + 3 chiome per gli alberi,
+// un box alla base di lato pari alla scala per rocce e cristalli)
+static int GetDecorationBoxes(const EntityTransform& transform, uint32_t category, BoundingBox* boxes)
+{
+    Vector3 position = transform.position;
+    float s = transform.scale;
+
+    if (category != SPATIAL_TREE)
+    {
+        boxes[0].min = { position.x - s/2, position.y, position.z - s/2 };
+        boxes[0].max = { position.x + s/2, position.y + s, position.z + s/2 };
+        return 1;
     }
-    
-    // Raycast verso decorazione più vicina
-    Vector3 dir = Vector3Normalize(Vector3Subtract(cam.target, cam.position));
-    float bestDist = 10.0f;
-    int bestType = -1;
-    int bestIndex = -1;
-    
-    // Check trees
-    for (size_t i = 0; i < ds->trees.size(); i++) {
-        float dist = Vector3Distance(cam.position, ds->trees[i].position);
-        if (dist < bestDist) {
-            Vector3 toTree = Vector3Subtract(ds->trees[i].position, cam.position);
-            float dot = Vector3DotProduct(dir, Vector3Normalize(toTree));
-            if (dot > 0.9f) { // 25° cone
-                bestDist = dist;
-                bestType = 0;
-                bestIndex = i;
-            }
-        }
+
+    // TRONCO (cilindro alla base)
+    boxes[0].min = { position.x - s*0.3f, position.y, position.z - s*0.3f };
+    boxes[0].max = { position.x + s*0.3f, position.y + 4.0f*s, position.z + s*0.3f };
+
+    // CHIOMA (3 sfere sovrapposte, approssimate con box)
+    Vector3 foliagePos = position;
+    foliagePos.y += 3.0f * s;
+
+    for (int j = 0; j < 3; j++)
+    {
+        float offset = (j - 1) * 0.8f * s;
+        Vector3 leafPos = foliagePos;
+        leafPos.y += offset;
+
+        float leafRadius = 1.5f * s * (1.0f - abs((float)j - 1) * 0.2f);
+
+        boxes[j + 1].min = { leafPos.x - leafRadius, leafPos.y - leafRadius, leafPos.z - leafRadius };
+        boxes[j + 1].max = { leafPos.x + leafRadius, leafPos.y + leafRadius, leafPos.z + leafRadius };
     }
-    
-    // Check rocks
-    for (size_t i = 0; i < ds->rocks.size(); i++) {
-        float dist = Vector3Distance(cam.position, ds->rocks[i].position);
-        if (dist < bestDist) {
-            Vector3 toRock = Vector3Subtract(ds->rocks[i].position, cam.position);
-            float dot = Vector3DotProduct(dir, Vector3Normalize(toRock));
-            if (dot > 0.9f) {
-                bestDist = dist;
-                bestType = 1;
-                bestIndex = i;
+    return 4;
+}
+
+#define DECORATION_MAX_BOXES 4
+
+EntityHandle RaycastDecorations(Ray ray, float maxDistance, uint32_t* category, float* distance) {
+    // Candidati dall'indice spaziale (sfere), poi test preciso contro i box
+    float bestDist = maxDistance;
+    uint32_t bestCategory = 0;
+    EntityHandle best = NULL_ENTITY;
+    EntityStore& store = EntityStore::Get();
+
+    static std::vector<SpatialHit> candidates;
+    candidates.clear();
+    SpatialIndex::Get().QueryRay(ray.position, ray.direction, bestDist, SPATIAL_TREE | SPATIAL_ROCK, candidates);
+
+    for (const SpatialHit& candidate : candidates) {
+        // Ordinati per ingresso nella sfera: oltre il migliore non si trova di meglio
+        if (candidate.distance >= bestDist) break;
+
+        const EntityTransform* transform = store.Find<EntityTransform>(candidate.handle);
+        if (!transform) continue;
+
+        BoundingBox boxes[DECORATION_MAX_BOXES];
+        int boxCount = GetDecorationBoxes(*transform, candidate.category, boxes);
+        for (int b = 0; b < boxCount; b++) {
+            RayCollision hit = GetRayCollisionBox(ray, boxes[b]);
+            if (hit.hit && hit.distance < bestDist) {
+                bestDist = hit.distance;
+                bestCategory = candidate.category;
+                best = candidate.handle;
             }
         }
     }
-    
-    if (bestType == -1) {
+
+    *category = bestCategory;
+    *distance = bestDist;
+    return best;
+}
+
+bool MineDecoration(DecorationSystem* ds, DecorationMiningState* mining, const InteractionQuery* query, float deltaTime) {
+    if (!IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
         mining->mining = false;
         mining->progress = 0.0f;
         return false;
     }
+
+    // Bersaglio già risolto dalla query del mirino di questo tick
+    EntityStore& store = EntityStore::Get();
+    EntityHandle best = query->decoration;
+    const EntityTransform* transform = store.Find<EntityTransform>(best);
+    if (!transform) {
+        mining->mining = false;
+        mining->progress = 0.0f;
+        return false;
+    }
+    int bestType = (query->decorationCategory == SPATIAL_TREE) ? 0 : 1;
     
     // Mining in corso
-    if (mining->mining && mining->targetType == bestType && mining->targetIndex == bestIndex) {
+    if (mining->mining && mining->target == best) {
         mining->progress += deltaTime;
         
         if (mining->progress >= 3.0f) { // 3 secondi per minare
-            Vector3 dropPos;
-            ItemType dropType;
+            Vector3 dropPos = transform->position;
+            ItemType dropType = (bestType == 0) ? ItemType::WOOD : ItemType::STONE;
             
-            if (bestType == 0) { // Tree
-                dropPos = ds->trees[bestIndex].position;
-                dropType = ItemType::WOOD;
-                ds->trees.erase(ds->trees.begin() + bestIndex);
-            } else { // Rock
-                dropPos = ds->rocks[bestIndex].position;
-                dropType = ItemType::STONE;
-                ds->rocks.erase(ds->rocks.begin() + bestIndex);
+            // Raccolta per sempre: la cella rigenerata la salta
+            const DecorationOrigin* origin = store.Find<DecorationOrigin>(best);
+            if (origin && ds->dimension) {
+                ds->mined[std::make_tuple(ds->dimension->terrainSeed, origin->chunkX, origin->chunkZ)]
+                    .push_back(origin->index);
             }
             
+            // La distruzione la toglie anche dall'indice spaziale
+            store.Destroy(best);
+            ds->batchesDirty = true;
+            
             SpawnDroppedItem(dropType, dropPos);
             mining->mining = false;
             mining->progress = 0.0f;
@@ -78,7 +136,7 @@ bool MineDecoration(DecorationSystem* ds, DecorationMiningState* mining, Camera3
     } else {
         mining->mining = true;
         mining->targetType = bestType;
-        mining->targetIndex = bestIndex;
+        mining->target = best;
         mining->progress = 0.0f;
     }
     
@@ -89,243 +147,595 @@ Mesh CreateTreeMesh()
 {
     return GenMeshCylinder(0.3f, 4.0f, 8);
 }
-inline bool CheckCollisionPointBoxCustom(Vector3 point, BoundingBox box)
-{
-    return (point.x >= box.min.x && point.x <= box.max.x) &&
-           (point.y >= box.min.y && point.y <= box.max.y) &&
-           (point.z >= box.min.z && point.z <= box.max.z);
-}
-
 Mesh CreateRockMesh(int seed)
 {
-    srand(seed);
-    float radius = 0.5f + (rand() % 50) / 100.0f;
-    int rings = 4 + rand() % 4;
-    int slices = 4 + rand() % 4;
+    RandomStream rng = RandomStream::For(seed, RandomSystem::ROCK_MESH);
+    float radius = 0.5f + rng.NextInt(50) / 100.0f;
+    int rings = 4 + rng.NextInt(4);
+    int slices = 4 + rng.NextInt(4);
     return GenMeshSphere(radius, rings, slices);
 }
 
 Mesh CreateCrystalMesh(int seed)
 {
-    srand(seed);
-    float height = 2.0f + (rand() % 100) / 50.0f;
-    float radius = 0.3f + (rand() % 50) / 100.0f;
-    int sides = 6 + rand() % 3;
+    RandomStream rng = RandomStream::For(seed, RandomSystem::CRYSTAL_MESH);
+    float height = 2.0f + rng.NextInt(100) / 50.0f;
+    float radius = 0.3f + rng.NextInt(50) / 100.0f;
+    int sides = 6 + rng.NextInt(3);
     return GenMeshCylinder(radius, height, sides);
 }
 
-void CollisionWithDecoration(DecorationSystem* ds, PlayerSystem* player)
-{
-    if (!ds || !player) return;
+// ---------- INDICE SPAZIALE ----------
 
-    auto pushPlayerOut = [&](BoundingBox box, const char* name)
+// Sfera che contiene tutti i box della decorazione
+static void RegisterDecoration(EntityHandle h, const EntityTransform& transform, uint32_t category)
+{
+    Vector3 center = transform.position;
+    float radius;
+    if (category == SPATIAL_TREE)
     {
-        Vector3 pos = player->camera.position;
-
-        if (CheckCollisionPointBoxCustom(pos, box))
-        {
-            Vector3 center = {
-                (box.min.x + box.max.x) * 0.5f,
-                (box.min.y + box.max.y) * 0.5f,
-                (box.min.z + box.max.z) * 0.5f
-            };
-
-            float dx = pos.x - center.x;
-            float dz = pos.z - center.z;
-
-            float overlapX = (box.max.x - box.min.x) / 2 - fabsf(dx);
-            float overlapZ = (box.max.z - box.min.z) / 2 - fabsf(dz);
-
-            if (overlapX < overlapZ)
-                pos.x += (dx > 0 ? overlapX : -overlapX);
-            else
-                pos.z += (dz > 0 ? overlapZ : -overlapZ);
+        center.y += 2.5f * transform.scale;
+        radius = 3.1f * transform.scale;
+    }
+    else
+    {
+        center.y += 0.5f * transform.scale;
+        radius = 0.87f * transform.scale;
+    }
+    SpatialIndex::Get().Insert(h, category, center, radius);
+}
 
-            player->camera.position = pos;
-        }
-    };
+void QueryDecorationColliders(const DecorationSystem * /*ds*/, BoundingBox area, std::vector<BoundingBox>& out)
+{
+    static std::vector<SpatialHit> candidates;
+    candidates.clear();
+    SpatialIndex::Get().QueryBox(area, SPATIAL_DECORATIONS, candidates);
 
-    for (auto& tree : ds->trees)
+    EntityStore& store = EntityStore::Get();
+    for (const SpatialHit& candidate : candidates)
     {
-        float s = tree.scale;
-        
-        // TRONCO (cilindro alla base)
-        BoundingBox trunk;
-        trunk.min = { tree.position.x - s*0.3f, tree.position.y, tree.position.z - s*0.3f };
-        trunk.max = { tree.position.x + s*0.3f, tree.position.y + 4.0f*s, tree.position.z + s*0.3f };
-        pushPlayerOut(trunk, "Tree trunk");
-        
-        // CHIOMA (3 sfere sovrapposte)
-        Vector3 foliagePos = tree.position;
-        foliagePos.y += 3.0f * s;
-        
-        for (int j = 0; j < 3; j++)
+        const EntityTransform* transform = store.Find<EntityTransform>(candidate.handle);
+        if (!transform)
+            continue;
+
+        BoundingBox boxes[DECORATION_MAX_BOXES];
+        int boxCount = GetDecorationBoxes(*transform, candidate.category, boxes);
+        for (int b = 0; b < boxCount; b++)
         {
-            float offset = (j - 1) * 0.8f * s;
-            Vector3 leafPos = foliagePos;
-            leafPos.y += offset;
-            
-            float leafRadius = 1.5f * s * (1.0f - abs((float)j - 1) * 0.2f);
-            
-            // Converti sfera in bounding box
-            BoundingBox leafBox;
-            leafBox.min = { leafPos.x - leafRadius, leafPos.y - leafRadius, leafPos.z - leafRadius };
-            leafBox.max = { leafPos.x + leafRadius, leafPos.y + leafRadius, leafPos.z + leafRadius };
-            pushPlayerOut(leafBox, "Tree foliage");
+            if (CheckCollisionBoxes(boxes[b], area))
+                out.push_back(boxes[b]);
         }
     }
+}
 
-    for (auto& rock : ds->rocks)
-    {
-        BoundingBox box;
-        float s = rock.scale;
-        box.min = { rock.position.x - s/2, rock.position.y, rock.position.z - s/2 };
-        box.max = { rock.position.x + s/2, rock.position.y + s, rock.position.z + s/2 };
-        pushPlayerOut(box, "Rock");
-    }
+void ClearDecorations(DecorationSystem *ds)
+{
+    ds->batchesDirty = true;
+    EntityStore::Get().DestroyAll<TreeDecoration>();
+    EntityStore::Get().DestroyAll<RockDecoration>();
+    EntityStore::Get().DestroyAll<CrystalDecoration>();
+}
 
-    for (auto& crystal : ds->crystals)
-    {
-        BoundingBox box;
-        float s = crystal.scale;
-        box.min = { crystal.position.x - s/2, crystal.position.y, crystal.position.z - s/2 };
-        box.max = { crystal.position.x + s/2, crystal.position.y + s, crystal.position.z + s/2 };
-        pushPlayerOut(box, "Crystal");
-    }
+int GetDecorationCount(const DecorationSystem * /*ds*/)
+{
+    const EntityStore& store = EntityStore::Get();
+    return store.Count<TreeDecoration>() + store.Count<RockDecoration>() + store.Count<CrystalDecoration>();
 }
 
 void InitDecorationSystem(DecorationSystem *ds)
 {
-    ds->trees.clear();
-    ds->rocks.clear();
-    ds->crystals.clear();
+    ClearDecorations(ds);
     ds->hasModels = false;
+    ds->world = NULL;
+    ds->dimension = NULL;
+
+    ds->trunkMesh = CreateTreeMesh();
+    ds->foliageMesh = GenMeshSphere(1.0f, 16, 16);
+    for (int v = 0; v < DECORATION_ROCK_VARIANTS; v++)
+        ds->rockMeshes[v] = CreateRockMesh(42 + v);
+    for (int v = 0; v < DECORATION_CRYSTAL_VARIANTS; v++)
+        ds->crystalMeshes[v] = CreateCrystalMesh(123 + v);
+
+    ds->material = LoadMaterialDefault();
+    Shader shader = LoadCachedShader("assets/shaders/glsl330/decoration_instanced.vs",
+                                     "assets/shaders/glsl330/decoration_instanced.fs");
+    int instanceLoc = GetShaderLocationAttrib(shader, "instanceTransform");
+
+    if (shader.id > 0 && instanceLoc >= 0)
+    {
+        shader.locs[SHADER_LOC_MATRIX_MVP] = GetCachedShaderLocation(shader, "mvp");
+        shader.locs[SHADER_LOC_MATRIX_MODEL] = instanceLoc;
+        ds->viewPosLoc = GetCachedShaderLocation(shader, "viewPos");
+        ds->fadeRangeLoc = GetCachedShaderLocation(shader, "fadeRange");
+        ds->material.shader = shader;
+        ds->instanced = true;
+        TraceLog(LOG_INFO, "✓ Decorations: instanced shader loaded (ID: %d)", shader.id);
+    }
+    else
+    {
+        ds->instanced = false;
+        TraceLog(LOG_WARNING, "⚠️ Decorations: instanced shader unavailable, drawing one mesh per instance");
+    }
 
-    ds->treeModel = LoadModelFromMesh(CreateTreeMesh());
-    ds->rockModel = LoadModelFromMesh(CreateRockMesh(42));
-    ds->crystalModel = LoadModelFromMesh(CreateCrystalMesh(123));
+    // Gli impostor riusano lo shader instanziato per cuocere l'atlante
+    ds->trunkColor = ds->foliageColor = ds->rockColor = ds->crystalColor = WHITE;
+    ds->impostorsBaked = false;
+    ds->impostors.loaded = false;
+    if (ds->instanced)
+        LoadImpostorAtlas(&ds->impostors, DECORATION_IMPOSTOR_ROCK + DECORATION_ROCK_VARIANTS);
 
     ds->hasModels = true;
 }
 
-Vector3 FindValidTerrainPosition(World *world, float minX, float maxX, float minZ, float maxZ)
+Vector3 FindValidTerrainPosition(World *world, RandomStream& rng, float minX, float maxX, float minZ, float maxZ)
 {
-    float x = minX + (rand() % (int)(maxX - minX));
-    float z = minZ + (rand() % (int)(maxZ - minZ));
+    float x = minX + rng.NextInt((int)(maxX - minX));
+    float z = minZ + rng.NextInt((int)(maxZ - minZ));
     float y = GetTerrainHeightAt(world, x, z);
     return {x, y, z};
 }
 
-void GenerateDecorationsForDimension(DecorationSystem *ds, World *world, DimensionConfig *dim)
+// Densità del bioma per tipo di decorazione (0=tree, 1=rock, 2=crystal)
+static int GetBiomeDecorationCount(const BiomeConfig& biome, int type)
 {
-    ds->trees.clear();
-    ds->rocks.clear();
-    ds->crystals.clear();
+    if (type == 0) return biome.treeCount;
+    if (type == 1) return biome.rockCount;
+    return biome.crystalCount;
+}
 
-    srand((unsigned int)time(NULL) + dim->id);
+static int GetMaxDecorationCount(const BiomeMap* biomes, int type)
+{
+    int maxCount = 0;
+    for (const BiomeConfig& biome : biomes->biomes)
+    {
+        int count = GetBiomeDecorationCount(biome, type);
+        if (count > maxCount) maxCount = count;
+    }
+    return maxCount;
+}
+
+// Candidati generati alla densità massima, poi accettati in proporzione
+// alla densità del bioma in cui cadono
+static bool AcceptDecoration(RandomStream& rng, const BiomeMap* biomes, Vector3 pos, int type, int maxCount)
+{
+    const BiomeConfig* biome = BiomeMapGetBiomeAt(biomes, pos.x, pos.z);
+    return rng.NextInt(maxCount) < GetBiomeDecorationCount(*biome, type);
+}
+
+// Candidati in una cella: densità per area 100x100 scalata sull'area della cella
+static int GetCellCandidateCount(RandomStream& rng, int maxCount, float area)
+{
+    float expected = maxCount * area / 10000.0f;
+    int count = (int)expected;
+    if (rng.NextFloat() < expected - count)
+        count++;
+    return count;
+}
+
+static bool IsMinedDecoration(const std::vector<int>* mined, int index)
+{
+    if (!mined)
+        return false;
+    for (int m : *mined)
+    {
+        if (m == index)
+            return true;
+    }
+    return false;
+}
+
+// Decorazioni di una cella (chunk) con il suo stream: il risultato non
+// dipende dall'ordine in cui le celle vengono generate. Le decorazioni
+// raccolte consumano lo stream come le altre ma non vengono create.
+static void GenerateDecorationCell(World *world, DimensionConfig *dim, RandomStream& rng, int chunkX, int chunkZ,
+                                   const std::vector<int>* mined)
+{
+    const BiomeMap* biomes = GetWorldBiomeMap();
+    EntityStore& store = EntityStore::Get();
+    float minX = (float)(chunkX * CHUNK_SIZE);
+    float minZ = (float)(chunkZ * CHUNK_SIZE);
+    float maxX = minX + CHUNK_SIZE;
+    float maxZ = minZ + CHUNK_SIZE;
+    float area = (maxX - minX) * (maxZ - minZ);
+    DecorationOrigin origin = {chunkX, chunkZ, 0};
 
     // ---------- ALBERI ----------
-    if (dim->treeCount > 0)
+    int maxTrees = GetMaxDecorationCount(biomes, 0);
+    int treeCandidates = GetCellCandidateCount(rng, maxTrees, area);
+    for (int i = 0; i < treeCandidates; i++)
     {
-        for (int i = 0; i < dim->treeCount; i++)
-        {
-            TreeDecoration tree;
-            tree.position = FindValidTerrainPosition(world, -50, 50, -50, 50);
-            tree.scale = 1.5f + (rand() % 100) / 100.0f;
-            tree.trunkColor = {101, 67, 33, 255};
-            tree.foliageColor = dim->treeColor;
-            ds->trees.push_back(tree);
-        }
+        EntityTransform transform;
+        transform.position = FindValidTerrainPosition(world, rng, minX, maxX, minZ, maxZ);
+        if (!AcceptDecoration(rng, biomes, transform.position, 0, maxTrees))
+            continue;
+        transform.scale = 1.5f + rng.NextInt(100) / 100.0f;
+
+        TreeDecoration tree;
+        tree.trunkColor = {101, 67, 33, 255};
+        tree.foliageColor = dim->treeColor;
+        if (!IsMinedDecoration(mined, origin.index))
+            RegisterDecoration(store.Create(transform, tree, origin), transform, SPATIAL_TREE);
+        origin.index++;
     }
 
     // ---------- ROCCE ----------
-    if (dim->rockCount > 0)
+    int maxRocks = GetMaxDecorationCount(biomes, 1);
+    int rockCandidates = GetCellCandidateCount(rng, maxRocks, area);
+    for (int i = 0; i < rockCandidates; i++)
     {
-        for (int i = 0; i < dim->rockCount; i++)
-        {
-            RockDecoration rock;
-            rock.position = FindValidTerrainPosition(world, -50, 50, -50, 50);
-            rock.scale = 0.8f + (rand() % 120) / 100.0f;
-            rock.color = dim->rockColor;
-            rock.seed = rand();
-            ds->rocks.push_back(rock);
-        }
+        EntityTransform transform;
+        transform.position = FindValidTerrainPosition(world, rng, minX, maxX, minZ, maxZ);
+        if (!AcceptDecoration(rng, biomes, transform.position, 1, maxRocks))
+            continue;
+        transform.scale = 0.8f + rng.NextInt(120) / 100.0f;
+
+        RockDecoration rock;
+        rock.color = dim->rockColor;
+        rock.seed = (int)(rng.NextU32() & 0x7FFFFFFF);
+        if (!IsMinedDecoration(mined, origin.index))
+            RegisterDecoration(store.Create(transform, rock, origin), transform, SPATIAL_ROCK);
+        origin.index++;
     }
 
-    // ---------- CRISTALLI SOLO SE dim->crystalCount > 0 ----------
-    if (dim->crystalCount > 0)
+    // ---------- CRISTALLI SOLO NEI BIOMI CHE LI PREVEDONO ----------
+    int maxCrystals = GetMaxDecorationCount(biomes, 2);
+    int crystalCandidates = GetCellCandidateCount(rng, maxCrystals, area);
+    for (int i = 0; i < crystalCandidates; i++)
     {
-        for (int i = 0; i < dim->crystalCount; i++)
-        {
-            CrystalDecoration crystal;
-            crystal.position = FindValidTerrainPosition(world, -50, 50, -50, 50);
-            crystal.position.y += 0.5f;
-            crystal.scale = 1.0f + (rand() % 150) / 100.0f;
-            crystal.rotation = (float)(rand() % 360);
-            crystal.tiltAngle = 15.0f + (rand() % 30);
-            crystal.tiltAxis = {(rand() % 100) / 100.0f - 0.5f, 0.0f, (rand() % 100) / 100.0f - 0.5f};
-            crystal.tiltAxis = Vector3Normalize(crystal.tiltAxis);
-            crystal.color = dim->crystalColor;
-            crystal.seed = rand();
-            crystal.glowing = true;
-            ds->crystals.push_back(crystal);
-        }
+        EntityTransform transform;
+        transform.position = FindValidTerrainPosition(world, rng, minX, maxX, minZ, maxZ);
+        if (!AcceptDecoration(rng, biomes, transform.position, 2, maxCrystals))
+            continue;
+        transform.position.y += 0.5f;
+        transform.scale = 1.0f + rng.NextInt(150) / 100.0f;
+
+        CrystalDecoration crystal;
+        crystal.rotation = (float)rng.NextInt(360);
+        crystal.tiltAngle = 15.0f + rng.NextInt(30);
+        crystal.tiltAxis = {rng.NextInt(100) / 100.0f - 0.5f, 0.0f, rng.NextInt(100) / 100.0f - 0.5f};
+        crystal.tiltAxis = Vector3Normalize(crystal.tiltAxis);
+        crystal.color = dim->crystalColor;
+        crystal.seed = (int)(rng.NextU32() & 0x7FFFFFFF);
+        crystal.glowing = true;
+        if (!IsMinedDecoration(mined, origin.index))
+            RegisterDecoration(store.Create(transform, crystal, origin), transform, SPATIAL_CRYSTAL);
+        origin.index++;
     }
 }
 
-    void DrawDecorations(DecorationSystem * ds)
+// Il chunk entra nel raggio di vista: le sue decorazioni, sempre le stesse,
+// meno quelle già raccolte
+static void OnDecorationChunkLoaded(void *user, Chunk *chunk)
+{
+    DecorationSystem *ds = (DecorationSystem *)user;
+    int seed = ds->dimension->terrainSeed;
+
+    auto mined = ds->mined.find(std::make_tuple(seed, chunk->chunkX, chunk->chunkZ));
+    RandomStream rng = RandomStream::For(seed, RandomSystem::DECORATIONS, chunk->chunkX, chunk->chunkZ);
+    GenerateDecorationCell(ds->world, ds->dimension, rng, chunk->chunkX, chunk->chunkZ,
+                           mined != ds->mined.end() ? &mined->second : NULL);
+    ds->batchesDirty = true;
+}
+
+// Il chunk viene scaricato: via le decorazioni con la base nelle sue colonne
+static void OnDecorationChunkEvicted(void *user, Chunk *chunk)
+{
+    DecorationSystem *ds = (DecorationSystem *)user;
+    float minX = (float)(chunk->chunkX * CHUNK_SIZE);
+    float minZ = (float)(chunk->chunkZ * CHUNK_SIZE);
+    BoundingBox area = {{minX, -CHUNK_SIZE, minZ}, {minX + CHUNK_SIZE, MAX_HEIGHT + CHUNK_SIZE, minZ + CHUNK_SIZE}};
+
+    static std::vector<SpatialHit> candidates;
+    candidates.clear();
+    SpatialIndex::Get().QueryBox(area, SPATIAL_DECORATIONS, candidates);
+
+    EntityStore& store = EntityStore::Get();
+    for (const SpatialHit& candidate : candidates)
     {
-        // ---------- ALBERI ----------
-        for (auto &tree : ds->trees)
-        {
-            // Tronco
-            DrawModelEx(ds->treeModel, tree.position, {0, 1, 0}, 0, {tree.scale, tree.scale, tree.scale}, tree.trunkColor);
+        const EntityTransform* transform = store.Find<EntityTransform>(candidate.handle);
+        if (!transform)
+            continue;
+        if ((int)floorf(transform->position.x / CHUNK_SIZE) != chunk->chunkX ||
+            (int)floorf(transform->position.z / CHUNK_SIZE) != chunk->chunkZ)
+            continue;
+        store.Destroy(candidate.handle);
+    }
+    ds->batchesDirty = true;
+}
 
-            // Chioma
-            Vector3 foliagePos = tree.position;
-            foliagePos.y += 3.0f * tree.scale; // posizionamento base chioma
+void StreamDecorations(DecorationSystem *ds, World *world, DimensionConfig *dim)
+{
+    ds->world = world;
+    ds->dimension = dim;
+    WorldAddChunkListener(world, (ChunkListener){OnDecorationChunkLoaded, OnDecorationChunkEvicted, ds});
+}
 
-            for (int j = 0; j < 3; j++)
-            {
-                float offset = (j - 1) * 0.8f * tree.scale;
-                Vector3 leafPos = foliagePos;
-                leafPos.y += offset;
+// Scala uniforme + traslazione, scritte direttamente (colonne di raylib)
+static Matrix ScaleTranslate(float scale, Vector3 position)
+{
+    Matrix m = {};
+    m.m0 = scale;
+    m.m5 = scale;
+    m.m10 = scale;
+    m.m12 = position.x;
+    m.m13 = position.y;
+    m.m14 = position.z;
+    m.m15 = 1.0f;
+    return m;
+}
 
-                float leafRadius = 1.5f * tree.scale * (1.0f - abs((float)j - 1) * 0.2f);
-                DrawSphere(leafPos, leafRadius, tree.foliageColor);
-            }
+// Chioma: 3 sfere sovrapposte
+static void GetFoliageTransforms(Vector3 position, float scale, Matrix *out)
+{
+    Vector3 foliagePos = position;
+    foliagePos.y += 3.0f * scale; // posizionamento base chioma
+
+    for (int j = 0; j < 3; j++)
+    {
+        float offset = (j - 1) * 0.8f * scale;
+        Vector3 leafPos = foliagePos;
+        leafPos.y += offset;
+
+        float leafRadius = 1.5f * scale * (1.0f - abs((float)j - 1) * 0.2f);
+        out[j] = ScaleTranslate(leafRadius, leafPos);
+    }
+}
+
+// Matrici di tutte le decorazioni, raggruppate per mesh: si rifà solo quando
+// le decorazioni cambiano (generazione, cache, mining), non a ogni frame
+static void RebuildDecorationBatches(DecorationSystem *ds)
+{
+    EntityStore& store = EntityStore::Get();
+
+    ds->trunkTransforms.clear();
+    ds->foliageTransforms.clear();
+    for (std::vector<Matrix>& batch : ds->rockTransforms) batch.clear();
+    for (std::vector<Matrix>& batch : ds->crystalTransforms) batch.clear();
+
+    // ---------- ALBERI ----------
+    store.ForEach<EntityTransform, TreeDecoration>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, TreeDecoration* trees) {
+        for (int i = 0; i < count; i++)
+        {
+            Vector3 position = transforms[i].position;
+            float scale = transforms[i].scale;
+
+            // Tronco e chioma
+            ds->trunkTransforms.push_back(ScaleTranslate(scale, position));
+
+            Matrix foliage[3];
+            GetFoliageTransforms(position, scale, foliage);
+            ds->foliageTransforms.insert(ds->foliageTransforms.end(), foliage, foliage + 3);
+            // Colori uguali per tutta la dimensione: vanno nel materiale
+            ds->trunkColor = trees[i].trunkColor;
+            ds->foliageColor = trees[i].foliageColor;
         }
-        for (auto &rock : ds->rocks)
+    });
+
+    // ---------- ROCCE ----------
+    store.ForEach<EntityTransform, RockDecoration>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, RockDecoration* rocks) {
+        for (int i = 0; i < count; i++)
         {
-            DrawModelEx(ds->rockModel, rock.position, {0, 1, 0}, (float)(rock.seed % 360), {rock.scale, rock.scale, rock.scale}, rock.color);
+            float scale = transforms[i].scale;
+            Vector3 position = transforms[i].position;
+
+            Matrix transform = MatrixMultiply(MatrixScale(scale, scale, scale),
+                                              MatrixRotateY((float)(rocks[i].seed % 360) * DEG2RAD));
+            transform = MatrixMultiply(transform, MatrixTranslate(position.x, position.y, position.z));
+
+            ds->rockTransforms[rocks[i].seed % DECORATION_ROCK_VARIANTS].push_back(transform);
+            ds->rockColor = rocks[i].color;
         }
+    });
 
-        for (auto &crystal : ds->crystals)
+    // ---------- CRISTALLI ----------
+    store.ForEach<EntityTransform, CrystalDecoration>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, CrystalDecoration* crystals) {
+        for (int i = 0; i < count; i++)
         {
+            const CrystalDecoration &crystal = crystals[i];
+            Vector3 position = transforms[i].position;
+            float scale = transforms[i].scale;
+
             Matrix matRotY = MatrixRotateY(crystal.rotation * DEG2RAD);
             Matrix matTilt = MatrixRotate(crystal.tiltAxis, crystal.tiltAngle * DEG2RAD);
-            Matrix matScale = MatrixScale(crystal.scale, crystal.scale, crystal.scale);
-            Matrix matTrans = MatrixTranslate(crystal.position.x, crystal.position.y, crystal.position.z);
+            Matrix matScale = MatrixScale(scale, scale, scale);
+            Matrix matTrans = MatrixTranslate(position.x, position.y, position.z);
 
             Matrix transform = MatrixMultiply(matScale, matTilt);
             transform = MatrixMultiply(transform, matRotY);
             transform = MatrixMultiply(transform, matTrans);
 
-            DrawMesh(ds->crystalModel.meshes[0], ds->crystalModel.materials[0], transform);
+            ds->crystalTransforms[crystal.seed % DECORATION_CRYSTAL_VARIANTS].push_back(transform);
+            ds->crystalColor = crystal.color;
+        }
+    });
+
+    ds->batchesDirty = false;
+}
+
+// Una chiamata per mesh: il colore è quello del materiale
+static void DrawDecorationBatch(DecorationSystem *ds, Mesh mesh, const Matrix *transforms, int count, Color color)
+{
+    if (count <= 0)
+        return;
+
+    ds->material.maps[MATERIAL_MAP_DIFFUSE].color = color;
+    if (ds->instanced)
+    {
+        DrawMeshInstanced(mesh, ds->material, transforms, count);
+        return;
+    }
+    for (int i = 0; i < count; i++)
+        DrawMesh(mesh, ds->material, transforms[i]);
+}
+
+static void DrawDecorationBatch(DecorationSystem *ds, Mesh mesh, const std::vector<Matrix>& batch, Color color)
+{
+    DrawDecorationBatch(ds, mesh, batch.data(), (int)batch.size(), color);
+}
+
+// Fascia di dissolvenza della geometria; fuori dai LOD non si dissolve mai
+static void SetDecorationFade(DecorationSystem *ds, Vector3 viewPos, float fadeStart, float fadeEnd)
+{
+    if (!ds->instanced)
+        return;
+    float fadeRange[2] = {fadeStart, fadeEnd};
+    SetShaderValue(ds->material.shader, ds->viewPosLoc, &viewPos, SHADER_UNIFORM_VEC3);
+    SetShaderValue(ds->material.shader, ds->fadeRangeLoc, fadeRange, SHADER_UNIFORM_VEC2);
+}
+
+// Variante all'origine per l'atlante: 0 l'albero, poi le rocce
+static void DrawDecorationVariant(void *user, int variant)
+{
+    DecorationSystem *ds = (DecorationSystem *)user;
+    Matrix identity = MatrixIdentity();
+
+    if (variant == DECORATION_IMPOSTOR_TREE)
+    {
+        Matrix foliage[3];
+        GetFoliageTransforms((Vector3){0.0f, 0.0f, 0.0f}, 1.0f, foliage);
+        DrawDecorationBatch(ds, ds->trunkMesh, &identity, 1, ds->trunkColor);
+        DrawDecorationBatch(ds, ds->foliageMesh, foliage, 3, ds->foliageColor);
+        return;
+    }
+    DrawDecorationBatch(ds, ds->rockMeshes[variant - DECORATION_IMPOSTOR_ROCK], &identity, 1, ds->rockColor);
+}
+
+static bool SameColor(Color a, Color b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+void PrepareDecorationRender(DecorationSystem *ds)
+{
+    if (!ds->hasModels)
+        return;
+    if (ds->batchesDirty)
+        RebuildDecorationBatches(ds);
+
+    // I colori dipendono dalla dimensione: l'atlante si rifà quando cambiano
+    if (!ds->impostors.loaded)
+        return;
+    if (ds->impostorsBaked && SameColor(ds->bakedFoliageColor, ds->foliageColor) &&
+        SameColor(ds->bakedRockColor, ds->rockColor))
+        return;
+
+    SetDecorationFade(ds, (Vector3){0.0f, 0.0f, 0.0f}, DECORATION_NO_FADE, 2.0f * DECORATION_NO_FADE);
+    BakeImpostor(&ds->impostors, DECORATION_IMPOSTOR_TREE, (BoundingBox){{-1.5f, 0.0f, -1.5f}, {1.5f, 5.0f, 1.5f}},
+                 DrawDecorationVariant, ds);
+    for (int v = 0; v < DECORATION_ROCK_VARIANTS; v++)
+        BakeImpostor(&ds->impostors, DECORATION_IMPOSTOR_ROCK + v, GetMeshBoundingBox(ds->rockMeshes[v]),
+                     DrawDecorationVariant, ds);
+
+    ds->impostorsBaked = true;
+    ds->bakedFoliageColor = ds->foliageColor;
+    ds->bakedRockColor = ds->rockColor;
+}
+
+// Distanza in XZ dall'origine dell'istanza, come negli shader
+static float DistanceSqr(const Matrix& transform, Vector3 point)
+{
+    float dx = transform.m12 - point.x;
+    float dz = transform.m14 - point.z;
+    return dx * dx + dz * dz;
+}
+
+// Divide un batch: geometria fino alla fine della dissolvenza, impostor dall'inizio
+static void SplitDecorationBatch(const std::vector<Matrix>& batch, Vector3 viewPos,
+                                 std::vector<Matrix>& nearOut, std::vector<Matrix>& farOut)
+{
+    nearOut.clear();
+    farOut.clear();
+    for (const Matrix& transform : batch)
+    {
+        float distSq = DistanceSqr(transform, viewPos);
+        if (distSq < DECORATION_IMPOSTOR_END * DECORATION_IMPOSTOR_END)
+            nearOut.push_back(transform);
+        if (distSq > DECORATION_IMPOSTOR_START * DECORATION_IMPOSTOR_START)
+            farOut.push_back(transform);
+    }
+}
+
+void DrawDecorations(DecorationSystem *ds, Camera3D camera)
+{
+    if (!ds->hasModels)
+        return;
+    if (ds->batchesDirty)
+        RebuildDecorationBatches(ds);
+
+    if (!ds->impostorsBaked)
+    {
+        // Senza atlante: tutta la geometria, a ogni distanza
+        SetDecorationFade(ds, camera.position, DECORATION_NO_FADE, 2.0f * DECORATION_NO_FADE);
+        DrawDecorationBatch(ds, ds->trunkMesh, ds->trunkTransforms, ds->trunkColor);
+        DrawDecorationBatch(ds, ds->foliageMesh, ds->foliageTransforms, ds->foliageColor);
+        for (int v = 0; v < DECORATION_ROCK_VARIANTS; v++)
+            DrawDecorationBatch(ds, ds->rockMeshes[v], ds->rockTransforms[v], ds->rockColor);
+        for (int v = 0; v < DECORATION_CRYSTAL_VARIANTS; v++)
+            DrawDecorationBatch(ds, ds->crystalMeshes[v], ds->crystalTransforms[v], ds->crystalColor);
+        return;
+    }
+
+    static std::vector<Matrix> nearTrunks, nearFoliage, nearBatch, farBatch;
+    Vector3 viewPos = camera.position;
+
+    // ---------- ALBERI ----------
+    // La chioma segue il tronco: le 3 sfere dell'albero i stanno in 3i..3i+2
+    nearTrunks.clear();
+    nearFoliage.clear();
+    farBatch.clear();
+    for (size_t i = 0; i < ds->trunkTransforms.size(); i++)
+    {
+        const Matrix& trunk = ds->trunkTransforms[i];
+        float distSq = DistanceSqr(trunk, viewPos);
+        if (distSq < DECORATION_IMPOSTOR_END * DECORATION_IMPOSTOR_END)
+        {
+            nearTrunks.push_back(trunk);
+            nearFoliage.insert(nearFoliage.end(), &ds->foliageTransforms[3 * i], &ds->foliageTransforms[3 * i] + 3);
         }
+        if (distSq > DECORATION_IMPOSTOR_START * DECORATION_IMPOSTOR_START)
+            farBatch.push_back(trunk);
     }
 
+    // Dissolvenza sulla distanza in XZ: le sfere della chioma hanno la stessa del tronco
+    SetDecorationFade(ds, viewPos, DECORATION_IMPOSTOR_START, DECORATION_IMPOSTOR_END);
+    DrawDecorationBatch(ds, ds->trunkMesh, nearTrunks, ds->trunkColor);
+    DrawDecorationBatch(ds, ds->foliageMesh, nearFoliage, ds->foliageColor);
+    DrawImpostors(&ds->impostors, DECORATION_IMPOSTOR_TREE, farBatch.data(), (int)farBatch.size(), camera,
+                  DECORATION_IMPOSTOR_START, DECORATION_IMPOSTOR_END);
 
+    // ---------- ROCCE ----------
+    for (int v = 0; v < DECORATION_ROCK_VARIANTS; v++)
+    {
+        SplitDecorationBatch(ds->rockTransforms[v], viewPos, nearBatch, farBatch);
+        DrawDecorationBatch(ds, ds->rockMeshes[v], nearBatch, ds->rockColor);
+        DrawImpostors(&ds->impostors, DECORATION_IMPOSTOR_ROCK + v, farBatch.data(), (int)farBatch.size(), camera,
+                      DECORATION_IMPOSTOR_START, DECORATION_IMPOSTOR_END);
+    }
+
+    // ---------- CRISTALLI ----------
+    SetDecorationFade(ds, viewPos, DECORATION_NO_FADE, 2.0f * DECORATION_NO_FADE);
+    for (int v = 0; v < DECORATION_CRYSTAL_VARIANTS; v++)
+        DrawDecorationBatch(ds, ds->crystalMeshes[v], ds->crystalTransforms[v], ds->crystalColor);
+}
 
 void CleanupDecorationSystem(DecorationSystem *ds)
 {
     if (ds->hasModels)
     {
-        UnloadModel(ds->treeModel);
-        UnloadModel(ds->rockModel);
-        UnloadModel(ds->crystalModel);
+        UnloadMesh(ds->trunkMesh);
+        UnloadMesh(ds->foliageMesh);
+        for (int v = 0; v < DECORATION_ROCK_VARIANTS; v++)
+            UnloadMesh(ds->rockMeshes[v]);
+        for (int v = 0; v < DECORATION_CRYSTAL_VARIANTS; v++)
+            UnloadMesh(ds->crystalMeshes[v]);
+        DetachMaterialShader(&ds->material);
+        UnloadMaterial(ds->material);
+        UnloadImpostorAtlas(&ds->impostors);
+        ds->impostorsBaked = false;
+        ds->hasModels = false;
     }
-    ds->trees.clear();
-    ds->rocks.clear();
-    ds->crystals.clear();
+    ClearDecorations(ds);
 }
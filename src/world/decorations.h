@@ -4,33 +4,33 @@
 #include "raylib.h"
 #include "../world/firstWorld.h"      // ← CAMBIA QUI
 #include "../world/dimensions.h"
+#include "../core/entityStore.h"
+#include "../rendering/impostor.h"
+#include <map>
+#include <tuple>
 #include <vector>
-#include "../core/player.h"
+
+struct InteractionQuery;
 
 struct DecorationMiningState {
     bool mining;
     int targetType; // 0=tree, 1=rock, 2=crystal
-    int targetIndex;
+    EntityHandle target;
     float progress;
 };
 
+// Componenti delle decorazioni: posizione e scala stanno in EntityTransform
 typedef struct TreeDecoration {
-    Vector3 position;
-    float scale;
     Color trunkColor;
     Color foliageColor;
 } TreeDecoration;
 
 typedef struct RockDecoration {
-    Vector3 position;
-    float scale;
     Color color;
     int seed;
 } RockDecoration;
 
 typedef struct CrystalDecoration {
-    Vector3 position;
-    float scale;
     float rotation;
     float tiltAngle;
     Vector3 tiltAxis;
@@ -39,23 +39,75 @@ typedef struct CrystalDecoration {
     bool glowing;
 } CrystalDecoration;
 
+// Cella (chunk) di origine e ordine di generazione nella cella: le decorazioni
+// raccolte vengono ricordate così e non ricrescono quando il chunk torna
+typedef struct DecorationOrigin {
+    int chunkX, chunkZ;
+    int index;
+} DecorationOrigin;
+
+// Varianti di mesh pre-generate: ogni roccia e cristallo ne usa una scelta dal seed
+#define DECORATION_ROCK_VARIANTS 4
+#define DECORATION_CRYSTAL_VARIANTS 4
+
+// Alberi, rocce e cristalli sono entità dell'EntityStore condiviso,
+// registrate nello SpatialIndex per collisioni e mining. Nascono con il
+// chunk che le contiene (stesso stream casuale a ogni caricamento) e
+// vengono distrutte quando il chunk viene scaricato; quelle raccolte restano
+// in mined e non ricrescono.
+// Il render raccoglie le matrici per variante di mesh una sola volta, quando
+// le decorazioni cambiano, e disegna ogni variante con una chiamata instanziata.
+// Oltre DECORATION_IMPOSTOR_START alberi e rocce passano agli impostor (i
+// cristalli, inclinati, restano geometria).
 typedef struct DecorationSystem {
-    std::vector<TreeDecoration> trees;
-    std::vector<RockDecoration> rocks;
-    std::vector<CrystalDecoration> crystals;
-    Model treeModel;
-    Model rockModel;
-    Model crystalModel;
+    Mesh trunkMesh;
+    Mesh foliageMesh;     // sfera unitaria, scalata per ciascuna delle 3 chiome
+    Mesh rockMeshes[DECORATION_ROCK_VARIANTS];
+    Mesh crystalMeshes[DECORATION_CRYSTAL_VARIANTS];
+    Material material;
+    bool instanced;       // false: shader non disponibile, una DrawMesh per matrice
     bool hasModels;
+    int viewPosLoc, fadeRangeLoc;
+
+    // Riga 0 l'albero, poi una riga per variante di roccia; rifatto quando cambiano i colori
+    ImpostorAtlas impostors;
+    bool impostorsBaked;
+    Color bakedFoliageColor, bakedRockColor;
+
+    // Matrici per istanza, ricostruite quando batchesDirty
+    std::vector<Matrix> trunkTransforms;
+    std::vector<Matrix> foliageTransforms;
+    std::vector<Matrix> rockTransforms[DECORATION_ROCK_VARIANTS];
+    std::vector<Matrix> crystalTransforms[DECORATION_CRYSTAL_VARIANTS];
+    Color trunkColor, foliageColor, rockColor, crystalColor;
+    bool batchesDirty;
+
+    // Mondo e dimensione a cui è collegato lo streaming
+    World* world;
+    DimensionConfig* dimension;
+    // Indici delle decorazioni raccolte per (seed, chunk x, chunk z), come la
+    // memoria dei monumenti: sopravvive ai cambi di dimensione
+    std::map<std::tuple<int, int, int>, std::vector<int>> mined;
 } DecorationSystem;
 
 void InitDecorationSystem(DecorationSystem* ds);
-void GenerateDecorationsForDimension(DecorationSystem* ds, World* world, DimensionConfig* dimension);
-void DrawDecorations(DecorationSystem* ds);
+// Collega le decorazioni al ciclo di vita dei chunk di world; da chiamare dopo ogni WorldInit
+void StreamDecorations(DecorationSystem* ds, World* world, DimensionConfig* dimension);
+// Batch e impostor aggiornati: da chiamare fuori da BeginTextureMode
+void PrepareDecorationRender(DecorationSystem* ds);
+void DrawDecorations(DecorationSystem* ds, Camera3D camera);
 void CleanupDecorationSystem(DecorationSystem* ds);
-void CollisionWithDecoration(DecorationSystem* ds, PlayerSystem* player);
+// Distrugge tutte le entità decorazione
+void ClearDecorations(DecorationSystem* ds);
+int GetDecorationCount(const DecorationSystem* ds);
+// Aggiunge a out i collider che intersecano area
+void QueryDecorationColliders(const DecorationSystem* ds, BoundingBox area, std::vector<BoundingBox>& out);
 Mesh CreateTreeMesh();
 Mesh CreateRockMesh(int seed);
 Mesh CreateCrystalMesh(int seed);
-bool MineDecoration(DecorationSystem* ds, DecorationMiningState* mining, Camera3D cam, float deltaTime);
+// Albero o roccia più vicino lungo il raggio entro maxDistance (test sui box);
+// NULL_ENTITY se non c'è
+EntityHandle RaycastDecorations(Ray ray, float maxDistance, uint32_t* category, float* distance);
+// Avanza il mining sulla decorazione indicata dalla query del mirino
+bool MineDecoration(DecorationSystem* ds, DecorationMiningState* mining, const InteractionQuery* query, float deltaTime);
 #endif
\ No newline at end of file
@@ -28,9 +28,7 @@ DimensionConfig::DimensionConfig()
       terrainScale(0.02f),
       terrainHeight(8.0f),
       waterLevel(4.0f),
-      treeCount(0),
-      rockCount(0),
-      crystalCount(0),
+      useDensityTerrain(false),
       grassTopColor(GREEN),
       dirtSideColor(BROWN),
       dirtColor(DARKBROWN),
@@ -40,46 +38,49 @@ DimensionConfig::DimensionConfig()
       ambientLight(LIGHTGRAY),
       sunColor(WHITE),
       useFog(false),
-      fogColor(GRAY),
-      fogDensity(0.0f)
+      fogColor(GRAY)
 {
     for(int i = 0; i < BLOCK_COUNT; i++) {
         blockTexturePaths[i] = "";
     }
 }
 
-void DimensionConfig::UnloadTextures() {
-    if (grassTopLoaded && grassTopTex.id != 0) {
-        UnloadTexture(grassTopTex);
-        grassTopTex.id = 0;
-        grassTopLoaded = false;
-    }
-    if (dirtSideLoaded && dirtSideTex.id != 0) {
-        UnloadTexture(dirtSideTex);
-        dirtSideTex.id = 0;
-        dirtSideLoaded = false;
-    }
-    if (dirtLoaded && dirtTex.id != 0) {
-        UnloadTexture(dirtTex);
-        dirtTex.id = 0;
-        dirtLoaded = false;
-    }
-    if (skyboxLoaded && skyboxTex.id != 0) {
-        UnloadTexture(skyboxTex);
-        skyboxTex.id = 0;
-        skyboxLoaded = false;
-    }
-    if (waterLoaded && waterTex.id != 0) {
-        UnloadTexture(waterTex);
-        waterTex.id = 0;
-        waterLoaded = false;
+// Le texture appartengono all'AssetCache: qui si rilascia solo il riferimento
+// della dimensione, e i file condivisi con altre dimensioni restano caricati
+static void ReleaseDimensionTexture(TextureHandle& handle, Texture2D& tex, bool& loaded) {
+    if (loaded) {
+        AssetCache::Get().Release(handle);
     }
+    handle = NULL_TEXTURE;
+    tex = Texture2D{};
+    loaded = false;
+}
+
+void DimensionConfig::UnloadTextures() {
+    ReleaseDimensionTexture(grassTopHandle, grassTopTex, grassTopLoaded);
+    ReleaseDimensionTexture(dirtSideHandle, dirtSideTex, dirtSideLoaded);
+    ReleaseDimensionTexture(dirtHandle, dirtTex, dirtLoaded);
+    ReleaseDimensionTexture(skyboxHandle, skyboxTex, skyboxLoaded);
+    ReleaseDimensionTexture(waterHandle, waterTex, waterLoaded);
 }
 
 bool DimensionConfig::IsTextureLoaded(const Texture2D& tex) const {
     return tex.id != 0;
 }
 
+// ========== BIOMI ==========
+
+static BiomeConfig MakeBiome(const char* name, float heightScale, float heightOffset, float roughness,
+                             int treeCount, int rockCount, int crystalCount) {
+    BiomeConfig biome;
+    biome.name = name;
+    biome.params = {heightScale, heightOffset, roughness};
+    biome.treeCount = treeCount;
+    biome.rockCount = rockCount;
+    biome.crystalCount = crystalCount;
+    return biome;
+}
+
 // ========== DIMENSION MANAGER ==========
 
 void DimensionManager::Initialize() {
@@ -118,67 +119,33 @@ int DimensionManager::GetDimensionCount() {
     return (int)dimensions.size();
 }
 
+static void AcquireDimensionTexture(const std::string& path, const char* label,
+                                    TextureHandle& handle, Texture2D& tex, bool& loaded) {
+    if (loaded || path.empty()) return;
+
+    if (!FileExists(path.c_str())) {
+        TraceLog(LOG_WARNING, "✗ MISSING %s: %s", label, path.c_str());
+        return;
+    }
+
+    handle = AssetCache::Get().AcquireTexture(path.c_str());
+    tex = AssetCache::Get().GetTexture(handle);
+    loaded = (tex.id != 0);
+    TraceLog(LOG_INFO, "✓ Loaded %s: %s (ID: %d)", label, path.c_str(), tex.id);
+}
+
 void DimensionManager::LoadDimensionTextures(DimensionConfig* dim) {
     if (!dim) return;
     
     TraceLog(LOG_INFO, "=== LOADING TEXTURES FOR: %s ===", dim->name.c_str());
     
-    // Grass Top
-    if (!dim->grassTopLoaded && !dim->grassTopTexture.empty()) {
-        if (FileExists(dim->grassTopTexture.c_str())) {
-            dim->grassTopTex = LoadTexture(dim->grassTopTexture.c_str());
-            dim->grassTopLoaded = (dim->grassTopTex.id != 0);
-            TraceLog(LOG_INFO, "✓ Loaded grassTop: %s (ID: %d)", dim->grassTopTexture.c_str(), dim->grassTopTex.id);
-        } else {
-            TraceLog(LOG_WARNING, "✗ MISSING grassTop: %s", dim->grassTopTexture.c_str());
-        }
-    }
-    
-    // Dirt Side
-    if (!dim->dirtSideLoaded && !dim->dirtSideTexture.empty()) {
-        if (FileExists(dim->dirtSideTexture.c_str())) {
-            dim->dirtSideTex = LoadTexture(dim->dirtSideTexture.c_str());
-            dim->dirtSideLoaded = (dim->dirtSideTex.id != 0);
-            TraceLog(LOG_INFO, "✓ Loaded dirtSide: %s (ID: %d)", dim->dirtSideTexture.c_str(), dim->dirtSideTex.id);
-        } else {
-            TraceLog(LOG_WARNING, "✗ MISSING dirtSide: %s", dim->dirtSideTexture.c_str());
-        }
-    }
-    
-    // Dirt
-    if (!dim->dirtLoaded && !dim->dirtTexture.empty()) {
-        if (FileExists(dim->dirtTexture.c_str())) {
-            dim->dirtTex = LoadTexture(dim->dirtTexture.c_str());
-            dim->dirtLoaded = (dim->dirtTex.id != 0);
-            TraceLog(LOG_INFO, "✓ Loaded dirt: %s (ID: %d)", dim->dirtTexture.c_str(), dim->dirtTex.id);
-        } else {
-            TraceLog(LOG_WARNING, "✗ MISSING dirt: %s", dim->dirtTexture.c_str());
-        }
-    }
-    
-    // Skybox
-    if (!dim->skyboxLoaded && !dim->skyboxTexture.empty()) {
-        if (FileExists(dim->skyboxTexture.c_str())) {
-            dim->skyboxTex = LoadTexture(dim->skyboxTexture.c_str());
-            dim->skyboxLoaded = (dim->skyboxTex.id != 0);
-            TraceLog(LOG_INFO, "✓ Loaded skybox: %s (ID: %d)", dim->skyboxTexture.c_str(), dim->skyboxTex.id);
-        } else {
-            TraceLog(LOG_WARNING, "✗ MISSING skybox: %s", dim->skyboxTexture.c_str());
-        }
-    }
-    
-    // Water
-    if (!dim->waterLoaded && !dim->waterTexture.empty()) {
-        if (FileExists(dim->waterTexture.c_str())) {
-            dim->waterTex = LoadTexture(dim->waterTexture.c_str());
-            dim->waterLoaded = (dim->waterTex.id != 0);
-            TraceLog(LOG_INFO, "✓ Loaded water: %s (ID: %d)", dim->waterTexture.c_str(), dim->waterTex.id);
-        } else {
-            TraceLog(LOG_WARNING, "✗ MISSING water: %s", dim->waterTexture.c_str());
-        }
-    }
+    AcquireDimensionTexture(dim->grassTopTexture, "grassTop", dim->grassTopHandle, dim->grassTopTex, dim->grassTopLoaded);
+    AcquireDimensionTexture(dim->dirtSideTexture, "dirtSide", dim->dirtSideHandle, dim->dirtSideTex, dim->dirtSideLoaded);
+    AcquireDimensionTexture(dim->dirtTexture, "dirt", dim->dirtHandle, dim->dirtTex, dim->dirtLoaded);
+    AcquireDimensionTexture(dim->skyboxTexture, "skybox", dim->skyboxHandle, dim->skyboxTex, dim->skyboxLoaded);
+    AcquireDimensionTexture(dim->waterTexture, "water", dim->waterHandle, dim->waterTex, dim->waterLoaded);
     
-    TraceLog(LOG_INFO, "=== TEXTURE LOADING COMPLETE ===");
+    TraceLog(LOG_INFO, "=== TEXTURE LOADING COMPLETE (%d files in cache) ===", AssetCache::Get().GetTextureCount());
 }
 
 void DimensionManager::UnloadDimensionTextures(DimensionConfig* dim) {
@@ -221,9 +188,9 @@ DimensionConfig DimensionManager::CreateGreenDimension() {
     config.terrainHeight = 10.0f;
     config.waterLevel = 5.0f;
 
-    config.treeCount = 40;
-    config.rockCount = 10;
-    config.crystalCount = 0;
+    config.biomes.push_back(MakeBiome("Forest", 1.0f, 5.0f, 1.0f, 40, 10, 0));
+    config.biomes.push_back(MakeBiome("Clearing", 0.6f, 5.5f, 0.5f, 8, 4, 0));
+    config.biomes.push_back(MakeBiome("Hills", 1.3f, 6.0f, 1.2f, 20, 25, 0));
     config.treeColor = {30, 150, 30, 255};
     config.rockColor = {80, 80, 70, 255};
 
@@ -233,7 +200,6 @@ DimensionConfig DimensionManager::CreateGreenDimension() {
 
     config.useFog = true;
     config.fogColor = {150, 200, 150, 255};
-    config.fogDensity = 0.015f;
 
     return config;
 }
@@ -263,9 +229,8 @@ DimensionConfig DimensionManager::CreatePurpleDimension() {
     config.terrainHeight = 8.0f;
     config.waterLevel = 4.0f;
 
-    config.treeCount = 0;
-    config.rockCount = 15;
-    config.crystalCount = 0;
+    config.biomes.push_back(MakeBiome("Purple Plains", 1.0f, 5.0f, 1.0f, 0, 15, 0));
+    config.biomes.push_back(MakeBiome("Purple Peaks", 1.4f, 6.0f, 1.3f, 0, 30, 0));
     config.rockColor = {153, 51, 255, 255};
 
     config.ambientLight = {76, 51, 102, 255};
@@ -274,7 +239,6 @@ DimensionConfig DimensionManager::CreatePurpleDimension() {
 
     config.useFog = true;
     config.fogColor = {100, 50, 150, 255};
-    config.fogDensity = 0.02f;
 
     return config;
 }
@@ -304,9 +268,9 @@ DimensionConfig DimensionManager::CreateRedDimension() {
     config.terrainHeight = 12.0f;
     config.waterLevel = 2.0f;
 
-    config.treeCount = 0;
-    config.rockCount = 25;
-    config.crystalCount = 30;
+    config.biomes.push_back(MakeBiome("Alien Flats", 1.0f, 5.0f, 1.0f, 0, 25, 30));
+    config.biomes.push_back(MakeBiome("Crystal Fields", 0.7f, 5.0f, 0.6f, 0, 10, 60));
+    config.biomes.push_back(MakeBiome("Red Spires", 1.4f, 6.0f, 1.4f, 0, 40, 15));
     config.rockColor = {200, 50, 30, 255};
     config.crystalColor = {50, 200, 255, 255};
 
@@ -316,7 +280,6 @@ DimensionConfig DimensionManager::CreateRedDimension() {
 
     config.useFog = true;
     config.fogColor = {150, 50, 50, 255};
-    config.fogDensity = 0.025f;
 
     return config;
 }
@@ -345,9 +308,9 @@ DimensionConfig DimensionManager::CreateDesertDimension() {
     config.terrainHeight = 6.0f;
     config.waterLevel = 1.0f;
 
-    config.treeCount = 5;
-    config.rockCount = 20;
-    config.crystalCount = 0;
+    config.biomes.push_back(MakeBiome("Dunes", 1.0f, 5.0f, 0.5f, 0, 15, 0));
+    config.biomes.push_back(MakeBiome("Oasis", 0.5f, 3.5f, 0.5f, 20, 5, 0));
+    config.biomes.push_back(MakeBiome("Mesa", 1.3f, 7.0f, 1.2f, 0, 40, 0));
     config.treeColor = {100, 150, 50, 255};
     config.rockColor = {150, 120, 80, 255};
 
@@ -357,7 +320,6 @@ DimensionConfig DimensionManager::CreateDesertDimension() {
 
     config.useFog = true;
     config.fogColor = {220, 200, 160, 255};
-    config.fogDensity = 0.01f;
 
     return config;
 }
@@ -386,9 +348,8 @@ DimensionConfig DimensionManager::CreateIceDimension() {
     config.terrainHeight = 7.0f;
     config.waterLevel = 4.0f;
 
-    config.treeCount = 10;
-    config.rockCount = 30;
-    config.crystalCount = 20;
+    config.biomes.push_back(MakeBiome("Tundra", 1.0f, 5.0f, 1.0f, 10, 30, 20));
+    config.biomes.push_back(MakeBiome("Glacier", 1.3f, 6.0f, 0.6f, 0, 20, 40));
     config.treeColor = {150, 200, 220, 255};
     config.rockColor = {180, 200, 220, 255};
     config.crystalColor = {150, 200, 255, 255};
@@ -399,7 +360,6 @@ DimensionConfig DimensionManager::CreateIceDimension() {
 
     config.useFog = true;
     config.fogColor = {200, 220, 255, 255};
-    config.fogDensity = 0.02f;
 
     return config;
 }
@@ -427,10 +387,10 @@ DimensionConfig DimensionManager::CreateVolcanoDimension() {
     config.terrainScale = 0.035f;
     config.terrainHeight = 15.0f;
     config.waterLevel = 3.0f;
+    config.useDensityTerrain = true;
 
-    config.treeCount = 0;
-    config.rockCount = 40;
-    config.crystalCount = 15;
+    config.biomes.push_back(MakeBiome("Ash Plains", 1.0f, 5.0f, 1.0f, 0, 40, 15));
+    config.biomes.push_back(MakeBiome("Caldera", 1.4f, 4.0f, 1.3f, 0, 60, 30));
     config.rockColor = {80, 50, 40, 255};
     config.crystalColor = {255, 100, 50, 255};
 
@@ -440,7 +400,6 @@ DimensionConfig DimensionManager::CreateVolcanoDimension() {
 
     config.useFog = true;
     config.fogColor = {100, 50, 40, 255};
-    config.fogDensity = 0.03f;
 
     return config;
 }
@@ -466,12 +425,12 @@ DimensionConfig DimensionManager::CreateSpaceDimension() {
 
     config.terrainSeed = 6000;
     config.terrainScale = 0.04f;
+    config.useDensityTerrain = true;
     config.terrainHeight = 5.0f;
     config.waterLevel = 0.0f;
 
-    config.treeCount = 0;
-    config.rockCount = 50;
-    config.crystalCount = 40;
+    config.biomes.push_back(MakeBiome("Regolith", 1.0f, 5.0f, 1.0f, 0, 50, 40));
+    config.biomes.push_back(MakeBiome("Craters", 1.3f, 4.5f, 1.4f, 0, 70, 20));
     config.rockColor = {70, 70, 90, 255};
     config.crystalColor = {100, 200, 255, 255};
 
@@ -481,7 +440,6 @@ DimensionConfig DimensionManager::CreateSpaceDimension() {
 
     config.useFog = false;
     config.fogColor = {0, 0, 0, 255};
-    config.fogDensity = 0.0f;
 
     return config;
 }
\ No newline at end of file
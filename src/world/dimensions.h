@@ -1,6 +1,8 @@
 #pragma once
 #include "raylib.h"
 #include "blockTypes.h"
+#include "biomes.h"
+#include "../core/assetCache.h"
 #include <string>
 #include <array>
 #include <vector>
@@ -18,9 +20,13 @@ struct DimensionConfig {
     std::string dirtSideTexture;
     std::string dirtTexture;
 
+    // Copie delle texture dell'AssetCache, valide finché la dimensione tiene l'handle
     Texture2D grassTopTex{}; 
     Texture2D dirtSideTex{};
     Texture2D dirtTex{};
+    TextureHandle grassTopHandle{};
+    TextureHandle dirtSideHandle{};
+    TextureHandle dirtHandle{};
     
     bool grassTopLoaded{false};
     bool dirtSideLoaded{false};
@@ -29,10 +35,12 @@ struct DimensionConfig {
     std::array<std::string, BLOCK_COUNT> blockTexturePaths;
     std::string waterTexture;
     Texture2D waterTex{};
+    TextureHandle waterHandle{};
     bool waterLoaded{false};
 
     std::string skyboxTexture;
     Texture2D skyboxTex{};
+    TextureHandle skyboxHandle{};
     Color skyboxTint{};
     bool skyboxLoaded{false};
 
@@ -41,9 +49,10 @@ struct DimensionConfig {
     float terrainHeight{};
     float waterLevel{};
 
-    int treeCount{};
-    int rockCount{};
-    int crystalCount{};
+    // Biomi della dimensione (densità decorazioni per bioma)
+    std::vector<BiomeConfig> biomes;
+    // Terreno volumetrico (sporgenze e grotte) invece del solo heightfield
+    bool useDensityTerrain{};
 
     Color treeColor{};
     Color rockColor{};
@@ -55,7 +64,6 @@ struct DimensionConfig {
 
     bool useFog{};
     Color fogColor{};
-    float fogDensity{};
 
     DimensionConfig(); // dichiarazione solo
     void UnloadTextures();
@@ -2,13 +2,14 @@
 #define STB_PERLIN_IMPLEMENTATION
 #include "stb_perlin.h"
 #include "dimensions.h" 
+#include "biomes.h"
 #include <math.h>
 #include <stdlib.h>
 #include <raymath.h>
 #include <string.h>
 #include <vector>
 
-static Chunk* WorldGetChunk(World* world, int cx, int cz) {
+Chunk* WorldGetChunk(World* world, int cx, int cz) {
     for (int i = 0; i < world->chunkCount; i++) {
         if (world->chunks[i].chunkX == cx && world->chunks[i].chunkZ == cz) {
             return &world->chunks[i];
@@ -21,6 +22,9 @@ static Chunk* WorldGetChunk(World* world, int cx, int cz) {
     c->chunkZ = cz;
     c->generated = false;
     c->meshGenerated = false;
+    c->populated = false;
+    c->oreMap = nullptr;
+    c->voxels = nullptr;
     memset(&c->mesh, 0, sizeof(Mesh));
     return c;
 }
@@ -32,8 +36,220 @@ void SetWorldDimension(int dimension) {
     currentDimensionSeed = dimension * 1000;
 }
 
-static void GenerateChunk(Chunk* c) {
-    float waterLevel = WATER_LEVEL;
+// Mappa dei biomi della dimensione corrente
+static_assert(BIOME_CELL_SIZE >= CHUNK_SIZE, "un chunk deve stare in una patch 3x3 di nodi");
+static BiomeMap currentBiomeMap = {0, {}};
+
+void SetWorldBiomes(DimensionConfig* dimension) {
+    BiomeMapInit(&currentBiomeMap, currentDimensionSeed, dimension->biomes);
+}
+
+const BiomeMap* GetWorldBiomeMap() {
+    return &currentBiomeMap;
+}
+
+// Reticolo grossolano del terreno a densità (voxel per nodo)
+#define DENSITY_STEP_XZ 4
+#define DENSITY_STEP_Y 8
+#define DENSITY_NODES_XZ (CHUNK_SIZE / DENSITY_STEP_XZ + 1)
+#define DENSITY_NODES_Y (MAX_HEIGHT / DENSITY_STEP_Y + 1)
+#define DENSITY_OVERHANG 5.0f   // quanto il rumore 3D sposta la superficie (blocchi)
+#define CAVE_THRESHOLD 0.3f
+
+typedef float DensityLattice[DENSITY_NODES_XZ][DENSITY_NODES_Y][DENSITY_NODES_XZ];
+
+// Modalità densità 3D (grotte e sporgenze) per la dimensione corrente
+static bool currentDensityTerrain = false;
+
+void SetWorldTerrainMode(bool densityTerrain) {
+    currentDensityTerrain = densityTerrain;
+}
+
+static void FreeChunkStorage(Chunk* c) {
+    if (c->oreMap) {
+        for (int x = 0; x <= CHUNK_SIZE; x++) {
+            for (int y = 0; y < MAX_HEIGHT; y++) {
+                delete[] c->oreMap[x][y];
+            }
+            delete[] c->oreMap[x];
+        }
+        delete[] c->oreMap;
+        c->oreMap = nullptr;
+    }
+    if (c->voxels) {
+        delete[] c->voxels;
+        c->voxels = nullptr;
+    }
+}
+
+Chunk* WorldFindChunk(World* world, int cx, int cz) {
+    for (int i = 0; i < world->chunkCount; i++) {
+        if (world->chunks[i].chunkX == cx && world->chunks[i].chunkZ == cz) {
+            return &world->chunks[i];
+        }
+    }
+    return NULL;
+}
+
+// Riempie le colonne fino all'altezza della heightmap
+static void FillHeightfieldVoxels(Chunk* c) {
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            int top = (int)c->heightMap[x][z];
+            if (top < 0) top = 0;
+            if (top >= MAX_HEIGHT) top = MAX_HEIGHT - 1;
+            
+            for (int y = 0; y <= top; y++) {
+                unsigned char block = BLOCK_DIRT;
+                if (y == top) block = BLOCK_GRASS;
+                else if (y < top - 3) block = BLOCK_STONE;
+                c->voxels[VOXEL_INDEX(x, y, z)] = block;
+            }
+        }
+    }
+}
+
+// Offset del rumore 3D per dimensione (stb_perlin ripete ogni 256 unità)
+static float GetDensitySeedOffset() {
+    return (float)((currentDimensionSeed / 1000 * 37) % 251) + 0.5f;
+}
+
+static float Trilinear(const DensityLattice& l, int i, int j, int k, float tx, float ty, float tz) {
+    float c00 = l[i][j][k] + (l[i + 1][j][k] - l[i][j][k]) * tx;
+    float c01 = l[i][j][k + 1] + (l[i + 1][j][k + 1] - l[i][j][k + 1]) * tx;
+    float c10 = l[i][j + 1][k] + (l[i + 1][j + 1][k] - l[i][j + 1][k]) * tx;
+    float c11 = l[i][j + 1][k + 1] + (l[i + 1][j + 1][k + 1] - l[i][j + 1][k + 1]) * tx;
+    
+    float c0 = c00 + (c10 - c00) * ty;
+    float c1 = c01 + (c11 - c01) * ty;
+    return c0 + (c1 - c0) * tz;
+}
+
+// Cella del reticolo e peso per la coordinata v; l'ultimo nodo (v == CHUNK_SIZE,
+// bordo condiviso con il chunk vicino) cade a fine dell'ultima cella
+static void GetDensityCell(int v, int step, int nodes, int* cell, float* t) {
+    *cell = v / step;
+    *t = (float)(v % step) / step;
+    if (*cell >= nodes - 1) {
+        *cell = nodes - 2;
+        *t = 1.0f;
+    }
+}
+
+static bool IsDensitySolid(const DensityLattice& overhang, const DensityLattice& caves,
+                           int x, int y, int z, float surface) {
+    if (y == 0) return true;
+    
+    int i, j, k;
+    float tx, ty, tz;
+    GetDensityCell(x, DENSITY_STEP_XZ, DENSITY_NODES_XZ, &i, &tx);
+    GetDensityCell(y, DENSITY_STEP_Y, DENSITY_NODES_Y, &j, &ty);
+    GetDensityCell(z, DENSITY_STEP_XZ, DENSITY_NODES_XZ, &k, &tz);
+    
+    float o = Trilinear(overhang, i, j, k, tx, ty, tz);
+    float n = Trilinear(caves, i, j, k, tx, ty, tz);
+    
+    float density = (surface - y) + o * DENSITY_OVERHANG;
+    return density > 0.0f && n < CAVE_THRESHOLD;
+}
+
+// Terreno a densità: il rumore 3D è valutato solo sul reticolo grossolano
+// (DENSITY_STEP_XZ x DENSITY_STEP_Y) e interpolato trilinearmente per voxel
+static void FillDensityVoxels(Chunk* c) {
+    DensityLattice overhang;
+    DensityLattice caves;
+    float seedOffset = GetDensitySeedOffset();
+    
+    for (int i = 0; i < DENSITY_NODES_XZ; i++) {
+        for (int j = 0; j < DENSITY_NODES_Y; j++) {
+            for (int k = 0; k < DENSITY_NODES_XZ; k++) {
+                float wx = (float)(c->chunkX * CHUNK_SIZE + i * DENSITY_STEP_XZ);
+                float wy = (float)(j * DENSITY_STEP_Y);
+                float wz = (float)(c->chunkZ * CHUNK_SIZE + k * DENSITY_STEP_XZ);
+                
+                overhang[i][j][k] = stb_perlin_noise3(wx * 0.04f, wy * 0.05f + seedOffset, wz * 0.04f, 0, 0, 0);
+                caves[i][j][k] = stb_perlin_noise3(wx * 0.07f, wy * 0.06f + seedOffset + 60.0f, wz * 0.07f, 0, 0, 0);
+            }
+        }
+    }
+    
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            float surface = c->heightMap[x][z];
+            
+            for (int y = 0; y < MAX_HEIGHT; y++) {
+                bool solid = IsDensitySolid(overhang, caves, x, y, z, surface);
+                c->voxels[VOXEL_INDEX(x, y, z)] = solid ? BLOCK_STONE : BLOCK_AIR;
+            }
+            
+            // Strato superficiale: erba sopra l'aria, terra per 3 blocchi, poi pietra
+            int depth = -1;
+            for (int y = MAX_HEIGHT - 1; y >= 0; y--) {
+                unsigned char& v = c->voxels[VOXEL_INDEX(x, y, z)];
+                if (v == BLOCK_AIR) {
+                    depth = -1;
+                    continue;
+                }
+                depth++;
+                if (depth == 0) v = BLOCK_GRASS;
+                else if (depth <= 3) v = BLOCK_DIRT;
+            }
+        }
+    }
+    
+    // Riga e colonna di bordo (x o z == CHUNK_SIZE) sono le colonne 0 dei chunk
+    // vicini e qui non hanno voxel: stessa densità negli stessi punti del mondo,
+    // così l'altezza coincide con quella che il vicino ricava dai suoi voxel
+    for (int e = 0; e <= CHUNK_SIZE; e++) {
+        for (int side = 0; side < 2; side++) {
+            if (side == 1 && e == CHUNK_SIZE) break;  // angolo già fatto
+            int x = side == 0 ? CHUNK_SIZE : e;
+            int z = side == 0 ? e : CHUNK_SIZE;
+            float surface = c->heightMap[x][z];
+            float top = 0.0f;
+            for (int y = MAX_HEIGHT - 1; y >= 0; y--) {
+                if (IsDensitySolid(overhang, caves, x, y, z, surface)) {
+                    top = (float)y;
+                    break;
+                }
+            }
+            c->heightMap[x][z] = top;
+        }
+    }
+}
+
+void WorldUpdateChunkHeightMip(Chunk* c) {
+    c->maxTop = 0;
+    for (int tx = 0; tx < HEIGHT_MIP_SIZE; tx++) {
+        for (int tz = 0; tz < HEIGHT_MIP_SIZE; tz++) {
+            int top = 0;
+            for (int x = tx * HEIGHT_MIP_TILE; x < (tx + 1) * HEIGHT_MIP_TILE; x++) {
+                for (int z = tz * HEIGHT_MIP_TILE; z < (tz + 1) * HEIGHT_MIP_TILE; z++) {
+                    int h = (int)c->heightMap[x][z];
+                    if (h > top) top = h;
+                }
+            }
+            if (top >= MAX_HEIGHT) top = MAX_HEIGHT - 1;
+            c->tileTop[tx][tz] = (unsigned char)top;
+            if (top > c->maxTop) c->maxTop = top;
+        }
+    }
+}
+
+// Aggiorna l'altezza della colonna al voxel solido più alto
+static void RefreshColumnHeight(Chunk* c, int x, int z) {
+    for (int y = MAX_HEIGHT - 1; y >= 0; y--) {
+        if (c->voxels[VOXEL_INDEX(x, y, z)] != BLOCK_AIR) {
+            c->heightMap[x][z] = (float)y;
+            return;
+        }
+    }
+    c->heightMap[x][z] = 0.0f;
+}
+
+void WorldAllocChunkStorage(Chunk* c) {
+    // Rigenerazione: libera la memoria del passaggio precedente
+    FreeChunkStorage(c);
     
     // Alloca oreMap dinamicamente
     c->oreMap = new int**[CHUNK_SIZE + 1];
@@ -43,18 +259,51 @@ static void GenerateChunk(Chunk* c) {
             c->oreMap[x][y] = new int[CHUNK_SIZE + 1]();
         }
     }
+    c->voxels = new unsigned char[CHUNK_SIZE * MAX_HEIGHT * CHUNK_SIZE]();
+}
+
+void WorldGenerateChunkData(Chunk* c) {
+    float waterLevel = WATER_LEVEL;
     
-    // Genera heightmap e liquidMap
+    WorldAllocChunkStorage(c);
+    
+    // Nodi dei biomi che coprono il chunk: valutati una volta, poi solo interpolati
+    BiomePatch biomes;
+    BiomeMapBuildPatch(&currentBiomeMap, c->chunkX * CHUNK_SIZE, c->chunkZ * CHUNK_SIZE, &biomes);
+    
+    // Genera heightmap
     for (int x = 0; x <= CHUNK_SIZE; x++) {
         for (int z = 0; z <= CHUNK_SIZE; z++) {
             float wx = (float)(c->chunkX * CHUNK_SIZE + x);
             float wz = (float)(c->chunkZ * CHUNK_SIZE + z);
             
-            float height = stb_perlin_noise3(wx * 0.02f, currentDimensionSeed, wz * 0.02f, 0, 0, 0) * 8.0f +
-                          stb_perlin_noise3(wx * 0.05f, 10 + currentDimensionSeed, wz * 0.05f, 0, 0, 0) * 4.0f +
-                          stb_perlin_noise3(wx * 0.1f, 20 + currentDimensionSeed, wz * 0.1f, 0, 0, 0) * 2.0f + 5.0f;
+            BiomeParams bp = BiomePatchSample(&biomes, wx, wz);
+            
+            float height = (stb_perlin_noise3(wx * 0.02f, currentDimensionSeed, wz * 0.02f, 0, 0, 0) * 8.0f +
+                            stb_perlin_noise3(wx * 0.05f, 10 + currentDimensionSeed, wz * 0.05f, 0, 0, 0) * 4.0f +
+                            stb_perlin_noise3(wx * 0.1f, 20 + currentDimensionSeed, wz * 0.1f, 0, 0, 0) * 2.0f * bp.roughness) *
+                           bp.heightScale + bp.heightOffset;
             
             c->heightMap[x][z] = height;
+        }
+    }
+    
+    // Voxel solidi/aria
+    if (currentDensityTerrain) {
+        FillDensityVoxels(c);
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                RefreshColumnHeight(c, x, z);
+            }
+        }
+    } else {
+        FillHeightfieldVoxels(c);
+    }
+    
+    // liquidMap sopra la superficie
+    for (int x = 0; x <= CHUNK_SIZE; x++) {
+        for (int z = 0; z <= CHUNK_SIZE; z++) {
+            float height = c->heightMap[x][z];
             
             if (height < waterLevel) {
                 c->liquidMap[x][z] = waterLevel - height;
@@ -76,6 +325,11 @@ static void GenerateChunk(Chunk* c) {
             for (int y = 0; y <= maxHeight && y < MAX_HEIGHT; y++) {
                 float wy = (float)y;
                 
+                // Niente minerali nelle grotte
+                if (x < CHUNK_SIZE && z < CHUNK_SIZE && c->voxels[VOXEL_INDEX(x, y, z)] == BLOCK_AIR) {
+                    continue;
+                }
+                
                 // IRON ORE (comune, y < 40)
                 if (y < 40) {
                     float ironNoise = stb_perlin_noise3(wx * 0.1f, wy * 0.1f, wz * 0.1f, 0, 0, 0);
@@ -111,6 +365,7 @@ static void GenerateChunk(Chunk* c) {
         }
     }
     
+    WorldUpdateChunkHeightMip(c);
     c->generated = true;
 }
 
@@ -207,9 +462,8 @@ static void AddCubeFace(std::vector<float>& verts, std::vector<float>& norms,
 // Verifica se un blocco di terreno esiste in una posizione
 static bool IsBlockAt(Chunk* c, int x, int y, int z) {
     if (x < 0 || x >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE) return false;
-    if (y < 0) return false;
-    int height = (int)c->heightMap[x][z];
-    return (y <= height);
+    if (y < 0 || y >= MAX_HEIGHT) return false;
+    return c->voxels[VOXEL_INDEX(x, y, z)] != BLOCK_AIR;
 }
 
 // Verifica se c'è acqua in una posizione
@@ -234,11 +488,11 @@ void SetDimensionColors(Color grassTop, Color dirtSide, Color dirt) {
     currentDirt = dirt;
 }
 
-static void GenerateChunkMesh(Chunk* c) {
-    if (c->meshGenerated) {
-        UnloadMesh(c->mesh);
-    }
-    
+static Color ShadeColor(Color c, float f) {
+    return (Color){(unsigned char)(c.r * f), (unsigned char)(c.g * f), (unsigned char)(c.b * f), c.a};
+}
+
+bool WorldBuildChunkMesh(Chunk* c) {
     std::vector<float> vertices;
     std::vector<float> normals;
     std::vector<float> texcoords;
@@ -249,32 +503,30 @@ static void GenerateChunkMesh(Chunk* c) {
     Color dirt = currentDirt;
     Color waterCol = {30, 100, 255, 180};  // acqua trasparente blu
     
-    // FASE 1: Genera il terreno solido
+    // FASE 1: Genera il terreno solido (facce tra voxel solidi e aria)
     for (int x = 0; x < CHUNK_SIZE; x++) {
         for (int z = 0; z < CHUNK_SIZE; z++) {
-            int maxHeight = (int)c->heightMap[x][z];
-            
-            // Clamp maxHeight per evitare overflow
-            if (maxHeight < 0) maxHeight = 0;
-            if (maxHeight > 100) maxHeight = 100;
+            float wx = (float)(c->chunkX * CHUNK_SIZE + x);
+            float wz = (float)(c->chunkZ * CHUNK_SIZE + z);
             
-            // Genera i cubi del terreno
-            for (int y = 0; y <= maxHeight; y++) {
-                float wx = (float)(c->chunkX * CHUNK_SIZE + x);
-                float wz = (float)(c->chunkZ * CHUNK_SIZE + z);
+            for (int y = 0; y < MAX_HEIGHT; y++) {
+                unsigned char block = c->voxels[VOXEL_INDEX(x, y, z)];
+                if (block == BLOCK_AIR) continue;
                 
-                bool isTopBlock = (y == maxHeight);
-                Color topCol = isTopBlock ? grassTop : dirt;
-                Color sideCol = dirtSide;
+                // La pietra esposta (grotte) è più scura della terra
+                float shade = (block == BLOCK_STONE) ? 0.6f : 1.0f;
+                Color topCol = ShadeColor(block == BLOCK_GRASS ? grassTop : dirt, shade);
+                Color sideCol = ShadeColor(dirtSide, shade);
+                Color bottomCol = ShadeColor(dirt, shade);
                 
-                // TOP - Solo se è il blocco più alto
-                if (isTopBlock) {
+                // TOP - Solo se sopra c'è aria
+                if (!IsBlockAt(c, x, y+1, z)) {
                     AddCubeFace(vertices, normals, texcoords, colors, wx, y, wz, 0, topCol);
                 }
                 
                 // BOTTOM - Solo se è y=0 o se sotto c'è aria
                 if (y == 0 || !IsBlockAt(c, x, y-1, z)) {
-                    AddCubeFace(vertices, normals, texcoords, colors, wx, y, wz, 1, dirt);
+                    AddCubeFace(vertices, normals, texcoords, colors, wx, y, wz, 1, bottomCol);
                 }
                 
                 // NORTH (Z+)
@@ -345,13 +597,12 @@ static void GenerateChunkMesh(Chunk* c) {
         }
     }
     
+    // Crea la mesh
+    memset(&c->mesh, 0, sizeof(Mesh));
     if (vertices.empty()) {
-        c->meshGenerated = false;
-        return;
+        return false;
     }
     
-    // Crea la mesh
-    memset(&c->mesh, 0, sizeof(Mesh));
     c->mesh.vertexCount = vertices.size() / 3;
     c->mesh.triangleCount = c->mesh.vertexCount / 3;
     
@@ -367,38 +618,168 @@ static void GenerateChunkMesh(Chunk* c) {
         if (c->mesh.normals) free(c->mesh.normals);
         if (c->mesh.texcoords) free(c->mesh.texcoords);
         if (c->mesh.colors) free(c->mesh.colors);
-        c->meshGenerated = false;
-        return;
+        memset(&c->mesh, 0, sizeof(Mesh));
+        return false;
     }
     
     memcpy(c->mesh.vertices, vertices.data(), vertices.size() * sizeof(float));
     memcpy(c->mesh.normals, normals.data(), normals.size() * sizeof(float));
     memcpy(c->mesh.texcoords, texcoords.data(), texcoords.size() * sizeof(float));
     memcpy(c->mesh.colors, colors.data(), colors.size());
+    return true;
+}
+
+static void GenerateChunkMesh(Chunk* c) {
+    if (c->meshGenerated) {
+        UnloadMesh(c->mesh);
+        c->meshGenerated = false;
+    }
+    
+    if (!WorldBuildChunkMesh(c)) return;
     
     UploadMesh(&c->mesh, false);
     c->meshGenerated = true;
 }
 
+static_assert((2 * CHUNK_KEEP_DISTANCE + 1) * (2 * CHUNK_KEEP_DISTANCE + 1) <= MAX_CHUNKS,
+              "i chunk tenuti attorno al giocatore devono stare nel mondo");
+
 void WorldInit(World* world) {
     world->chunkCount = 0;
+    world->terrainVersion = 0;
+    world->listenerCount = 0;
+    world->source = (ChunkSource){NULL, NULL};
+    world->edits.clear();
     for (int i = 0; i < MAX_CHUNKS; i++) {
         world->chunks[i].generated = false;
         world->chunks[i].meshGenerated = false;
+        world->chunks[i].populated = false;
         world->chunks[i].oreMap = nullptr;  // ← Inizializza a null
+        world->chunks[i].voxels = nullptr;
         memset(&world->chunks[i].mesh, 0, sizeof(Mesh));
     }
 }
 
+void WorldAddChunkListener(World* world, ChunkListener listener) {
+    if (world->listenerCount >= MAX_CHUNK_LISTENERS) {
+        TraceLog(LOG_WARNING, "WorldAddChunkListener: too many listeners");
+        return;
+    }
+    world->listeners[world->listenerCount++] = listener;
+}
+
+void WorldSetChunkSource(World* world, ChunkSource source) {
+    world->source = source;
+}
+
+// Ricorda il blocco finale del voxel; una modifica successiva dello stesso
+// voxel sostituisce la precedente
+static void RecordVoxelEdit(World* world, Chunk* c, int lx, int y, int lz, unsigned char block) {
+    std::vector<VoxelEdit>& edits = world->edits[std::make_pair(c->chunkX, c->chunkZ)];
+    int index = VOXEL_INDEX(lx, y, lz);
+    for (VoxelEdit& e : edits) {
+        if (e.index == index) {
+            e.block = block;
+            return;
+        }
+    }
+    edits.push_back((VoxelEdit){index, block});
+}
+
+// Rimette le modifiche del giocatore su un chunk appena generato o letto
+// dalla cache; true se ce n'erano
+static bool ReplayChunkEdits(World* world, Chunk* c) {
+    auto it = world->edits.find(std::make_pair(c->chunkX, c->chunkZ));
+    if (it == world->edits.end()) return false;
+    
+    for (const VoxelEdit& e : it->second) {
+        int x = e.index / (MAX_HEIGHT * CHUNK_SIZE);
+        int y = (e.index / CHUNK_SIZE) % MAX_HEIGHT;
+        int z = e.index % CHUNK_SIZE;
+        c->voxels[e.index] = e.block;
+        // Il minerale se ne va con il blocco scavato, e un blocco piazzato non ne ha
+        c->oreMap[x][y][z] = 0;
+        RefreshColumnHeight(c, x, z);
+    }
+    WorldUpdateChunkHeightMip(c);
+    return true;
+}
+
+// Chunk nuovo o tornato nel raggio: dalla cache se c'è, altrimenti generato,
+// poi con le modifiche del giocatore
+static void LoadChunk(World* world, Chunk* c) {
+    bool cached = world->source.load && world->source.load(world->source.user, c);
+    if (!cached) WorldGenerateChunkData(c);
+    
+    // La mesh salvata in cache non ha le modifiche
+    if (ReplayChunkEdits(world, c) && c->meshGenerated) {
+        UnloadMesh(c->mesh);
+        c->meshGenerated = false;
+    }
+}
+
+static void NotifyChunkLoaded(World* world, Chunk* c) {
+    c->populated = true;
+    for (int i = 0; i < world->listenerCount; i++) {
+        if (world->listeners[i].onLoaded) world->listeners[i].onLoaded(world->listeners[i].user, c);
+    }
+}
+
+static void NotifyChunkEvicted(World* world, Chunk* c) {
+    if (!c->populated) return;
+    c->populated = false;
+    for (int i = 0; i < world->listenerCount; i++) {
+        if (world->listeners[i].onEvicted) world->listeners[i].onEvicted(world->listeners[i].user, c);
+    }
+}
+
+// Scarica il chunk e libera lo slot: l'ultimo chunk prende il suo posto.
+// Le modifiche del giocatore restano in world->edits e tornano con il chunk
+static void EvictChunk(World* world, int index) {
+    Chunk* c = &world->chunks[index];
+    NotifyChunkEvicted(world, c);
+    if (c->meshGenerated) {
+        UnloadMesh(c->mesh);
+        c->meshGenerated = false;
+    }
+    FreeChunkStorage(c);
+    c->generated = false;
+
+    Chunk* last = &world->chunks[--world->chunkCount];
+    if (last != c) {
+        *c = *last;
+        last->generated = false;
+        last->meshGenerated = false;
+        last->populated = false;
+        last->oreMap = nullptr;
+        last->voxels = nullptr;
+        memset(&last->mesh, 0, sizeof(Mesh));
+    }
+}
+
 void WorldUpdate(World* world, Vector3 playerPos) {
     int playerChunkX = (int)floor(playerPos.x / CHUNK_SIZE);
     int playerChunkZ = (int)floor(playerPos.z / CHUNK_SIZE);
     
+    // Chunk rimasti indietro: scaricati prima di generarne di nuovi
+    for (int i = world->chunkCount - 1; i >= 0; i--) {
+        Chunk* c = &world->chunks[i];
+        if (abs(c->chunkX - playerChunkX) > CHUNK_KEEP_DISTANCE ||
+            abs(c->chunkZ - playerChunkZ) > CHUNK_KEEP_DISTANCE) {
+            EvictChunk(world, i);
+            world->terrainVersion++;
+        }
+    }
+    
     for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; x++) {
         for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++) {
             Chunk* c = WorldGetChunk(world, playerChunkX + x, playerChunkZ + z);
-            if (c && !c->generated) GenerateChunk(c);
+            if (c && !c->generated) {
+                LoadChunk(world, c);
+                world->terrainVersion++;
+            }
             if (c && c->generated && !c->meshGenerated) GenerateChunkMesh(c);
+            if (c && c->generated && !c->populated) NotifyChunkLoaded(world, c);
         }
     }
 }
@@ -423,62 +804,21 @@ void WorldDraw(World* world) {
 
 void WorldCleanup(World* world) {
     for (int i = 0; i < world->chunkCount; i++) {
+        NotifyChunkEvicted(world, &world->chunks[i]);
         if (world->chunks[i].meshGenerated) {
             UnloadMesh(world->chunks[i].mesh);
             world->chunks[i].meshGenerated = false;
         }
         
-        // ← AGGIUNGI: Dealloca oreMap
-        if (world->chunks[i].oreMap) {
-            for (int x = 0; x <= CHUNK_SIZE; x++) {
-                for (int y = 0; y < MAX_HEIGHT; y++) {
-                    delete[] world->chunks[i].oreMap[x][y];
-                }
-                delete[] world->chunks[i].oreMap[x];
-            }
-            delete[] world->chunks[i].oreMap;
-            world->chunks[i].oreMap = nullptr;
-        }
+        // Dealloca oreMap e voxel
+        FreeChunkStorage(&world->chunks[i]);
     }
 }
 
 void WorldLoadTextures(World* world, DimensionConfig* dim) {
-    TraceLog(LOG_INFO, "Loading textures for %s", dim->name.c_str());
-    
-    // Carica solo se non già caricate E path non vuoto
-    if (dim->grassTopTex.id == 0 && !dim->grassTopTexture.empty()) {
-        if (FileExists(dim->grassTopTexture.c_str())) {
-            dim->grassTopTex = LoadTexture(dim->grassTopTexture.c_str());
-            dim->grassTopLoaded = true;
-            TraceLog(LOG_INFO, "Loaded grassTop: %s", dim->grassTopTexture.c_str());
-        } else {
-            TraceLog(LOG_WARNING, "MISSING: %s", dim->grassTopTexture.c_str());
-        }
-    }
-    
-    if (dim->dirtSideTex.id == 0 && !dim->dirtSideTexture.empty()) {
-        if (FileExists(dim->dirtSideTexture.c_str())) {
-            dim->dirtSideTex = LoadTexture(dim->dirtSideTexture.c_str());
-            dim->dirtSideLoaded = true;
-            TraceLog(LOG_INFO, "Loaded dirtSide: %s", dim->dirtSideTexture.c_str());
-        } else {
-            TraceLog(LOG_WARNING, "MISSING: %s", dim->dirtSideTexture.c_str());
-        }
-    }
-    
-    if (dim->dirtTex.id == 0 && !dim->dirtTexture.empty()) {
-        if (FileExists(dim->dirtTexture.c_str())) {
-            dim->dirtTex = LoadTexture(dim->dirtTexture.c_str());
-            dim->dirtLoaded = true;
-            TraceLog(LOG_INFO, "Loaded dirt: %s", dim->dirtTexture.c_str());
-        } else {
-            TraceLog(LOG_WARNING, "MISSING: %s", dim->dirtTexture.c_str());
-        }
-    }
-    
-    if (dim->skyboxTex.id == 0 && !dim->skyboxTexture.empty()) {
-        dim->skyboxTex = LoadTexture(dim->skyboxTexture.c_str());
-    }
+    // Le texture le carica DimensionManager::LoadDimensionTextures attraverso
+    // l'AssetCache: caricarle anche qui creava copie che nessuno scaricava
+    TraceLog(LOG_INFO, "Using textures of %s", dim->name.c_str());
     
     world->useTextures = true;  // Forza uso texture
 }
@@ -518,13 +858,23 @@ float GetTerrainHeightAt(World* world, float x, float z) {
 }
 
 BlockType GetBlockAt(World* world, int x, int y, int z) {
-    float height = GetTerrainHeightAt(world, (float)x, (float)z);
-    return (y < height) ? BLOCK_DIRT : BLOCK_AIR;
+    if (y < 0 || y >= MAX_HEIGHT) return BLOCK_AIR;
+    
+    int chunkX = (int)floor((float)x / CHUNK_SIZE);
+    int chunkZ = (int)floor((float)z / CHUNK_SIZE);
+    Chunk* chunk = WorldFindChunk(world, chunkX, chunkZ);
+    if (!chunk || !chunk->generated) return BLOCK_AIR;
+    
+    int lx = x - chunkX * CHUNK_SIZE;
+    int lz = z - chunkZ * CHUNK_SIZE;
+    return (BlockType)chunk->voxels[VOXEL_INDEX(lx, y, lz)];
 }
 
 void RegenerateAllChunks(World* world) {
     // Marca tutti i chunk come non generati per forzare la rigenerazione
     for (int i = 0; i < world->chunkCount; i++) {
+        // Decorazioni e monumenti tornano con il chunk rigenerato
+        NotifyChunkEvicted(world, &world->chunks[i]);
         if (world->chunks[i].meshGenerated) {
             UnloadMesh(world->chunks[i].mesh);
         }
@@ -533,18 +883,40 @@ void RegenerateAllChunks(World* world) {
     }
 }
 
+// Oggetto droppato da un voxel: minerale se presente, altrimenti il blocco
+static ItemType GetVoxelDrop(Chunk* chunk, int lx, int y, int lz, unsigned char block) {
+    ItemType ore = (ItemType)chunk->oreMap[lx][y][lz];
+    if (block != BLOCK_GRASS &&
+        (ore == ItemType::IRON_ORE || ore == ItemType::GOLD_ORE || ore == ItemType::DIAMOND)) {
+        return ore;
+    }
+    
+    switch (block) {
+        case BLOCK_GRASS: return ItemType::GRASS;
+        case BLOCK_STONE: return ItemType::STONE;
+        case BLOCK_SAND: return ItemType::SAND;
+        default: return ItemType::DIRT;
+    }
+}
+
+static unsigned char GetItemBlock(ItemType type) {
+    switch (type) {
+        case ItemType::GRASS: return BLOCK_GRASS;
+        case ItemType::STONE:
+        case ItemType::IRON_ORE:
+        case ItemType::GOLD_ORE:
+        case ItemType::DIAMOND: return BLOCK_STONE;
+        case ItemType::SAND: return BLOCK_SAND;
+        default: return BLOCK_DIRT;
+    }
+}
+
 ItemType RemoveBlock(World* world, int x, int y, int z) {
     // Determina il chunk
     int chunkX = (int)floor((float)x / CHUNK_SIZE);
     int chunkZ = (int)floor((float)z / CHUNK_SIZE);
     
-    Chunk* chunk = NULL;
-    for (int i = 0; i < world->chunkCount; i++) {
-        if (world->chunks[i].chunkX == chunkX && world->chunks[i].chunkZ == chunkZ) {
-            chunk = &world->chunks[i];
-            break;
-        }
-    }
+    Chunk* chunk = WorldFindChunk(world, chunkX, chunkZ);
     
     if (!chunk || !chunk->generated) return ItemType::NONE;
     
@@ -552,37 +924,26 @@ ItemType RemoveBlock(World* world, int x, int y, int z) {
     int lx = x - chunkX * CHUNK_SIZE;
     int lz = z - chunkZ * CHUNK_SIZE;
     
-    // Clamp coordinate locali
-    if (lx < 0) lx = 0;
-    if (lx >= CHUNK_SIZE) lx = CHUNK_SIZE - 1;
-    if (lz < 0) lz = 0;
-    if (lz >= CHUNK_SIZE) lz = CHUNK_SIZE - 1;
-    
-    // Verifica se c'è un blocco qui
-    float currentHeight = chunk->heightMap[lx][lz];
-    
-    // Se il blocco target è sopra il terreno, non c'è nulla da scavare
-    if (y > (int)currentHeight || y < 0) {
+    // y = 0 è il fondo del mondo e non si scava
+    if (y <= 0 || y >= MAX_HEIGHT) {
         return ItemType::NONE;
     }
     
-    // Determina il tipo di item droppato
-    ItemType dropType = ItemType::DIRT;
-    
-    // Se è il blocco superiore, droppa grass
-    if (y == (int)currentHeight) {
-        dropType = ItemType::GRASS;
-    } else {
-        dropType = ItemType::DIRT;
+    unsigned char& block = chunk->voxels[VOXEL_INDEX(lx, y, lz)];
+    if (block == BLOCK_AIR) {
+        return ItemType::NONE;
     }
     
-    // Rimuovi il blocco abbassando l'altezza di 1
-    chunk->heightMap[lx][lz] = (float)(y - 1);
+    // Determina il tipo di item droppato
+    ItemType dropType = GetVoxelDrop(chunk, lx, y, lz, block);
     
-    // Se abbassando l'altezza andiamo sotto zero, clamp a 0
-    if (chunk->heightMap[lx][lz] < 0.0f) {
-        chunk->heightMap[lx][lz] = 0.0f;
-    }
+    // Rimuovi il voxel e aggiorna l'altezza della colonna
+    block = BLOCK_AIR;
+    chunk->oreMap[lx][y][lz] = 0;
+    RecordVoxelEdit(world, chunk, lx, y, lz, BLOCK_AIR);
+    RefreshColumnHeight(chunk, lx, lz);
+    WorldUpdateChunkHeightMip(chunk);
+    world->terrainVersion++;
     
     // Rigenera la mesh del chunk
     if (chunk->meshGenerated) {
@@ -598,14 +959,7 @@ bool PlaceBlock(World* world, int x, int y, int z, ItemType blockType) {
     int chunkX = (int)floor((float)x / CHUNK_SIZE);
     int chunkZ = (int)floor((float)z / CHUNK_SIZE);
     
-    Chunk* chunk = NULL;
-    for (int i = 0; i < world->chunkCount; i++) {
-        if (world->chunks[i].chunkX == chunkX && 
-            world->chunks[i].chunkZ == chunkZ) {
-            chunk = &world->chunks[i];
-            break;
-        }
-    }
+    Chunk* chunk = WorldFindChunk(world, chunkX, chunkZ);
     
     if (!chunk || !chunk->generated) {
         TraceLog(LOG_WARNING, "PlaceBlock: Chunk not found or not generated");
@@ -615,29 +969,27 @@ bool PlaceBlock(World* world, int x, int y, int z, ItemType blockType) {
     int lx = x - chunkX * CHUNK_SIZE;
     int lz = z - chunkZ * CHUNK_SIZE;
     
-    // Clamp coordinate
-    if (lx < 0) lx = 0;
-    if (lx >= CHUNK_SIZE) lx = CHUNK_SIZE - 1;
-    if (lz < 0) lz = 0;
-    if (lz >= CHUNK_SIZE) lz = CHUNK_SIZE - 1;
-    
-    float currentHeight = chunk->heightMap[lx][lz];
-    
-    // Permetti di piazzare SOLO se y è esattamente currentHeight + 1
-    if (y != (int)currentHeight + 1) {
-        TraceLog(LOG_WARNING, "PlaceBlock: Invalid Y position (y=%d, terrain=%.0f, type=%d)", 
-                 y, currentHeight, (int)blockType);
+    // Limite massimo altezza
+    if (y <= 0 || y >= MAX_HEIGHT) {
+        TraceLog(LOG_WARNING, "PlaceBlock: Y out of range (%d)", y);
         return false;
     }
     
-    // Limite massimo altezza
-    if (y > 100) {
-        TraceLog(LOG_WARNING, "PlaceBlock: Y too high (%d)", y);
+    // Permetti di piazzare SOLO in un voxel vuoto
+    unsigned char& block = chunk->voxels[VOXEL_INDEX(lx, y, lz)];
+    if (block != BLOCK_AIR) {
+        TraceLog(LOG_WARNING, "PlaceBlock: Position occupied (%d, %d, %d, type=%d)", 
+                 x, y, z, (int)blockType);
         return false;
     }
     
-    // Aggiorna l'altezza del terreno
-    chunk->heightMap[lx][lz] = (float)y;
+    block = GetItemBlock(blockType);
+    // Piazzato in un voxel vuoto: niente minerale sotto, come dopo il replay
+    chunk->oreMap[lx][y][lz] = 0;
+    RecordVoxelEdit(world, chunk, lx, y, lz, block);
+    RefreshColumnHeight(chunk, lx, lz);
+    WorldUpdateChunkHeightMip(chunk);
+    world->terrainVersion++;
     
     TraceLog(LOG_INFO, "PlaceBlock: %s placed at (%d, %d, %d) | New height: %.0f", 
              GetItemName(blockType), x, y, z, chunk->heightMap[lx][lz]);
@@ -4,28 +4,81 @@
 #include <raylib.h>
 #include "../gameplay/item.h"
 #include "blockTypes.h"  // Include la definizione UNICA di BlockType
+#include <map>
+#include <utility>
+#include <vector>
 
 #define CHUNK_SIZE 16
 #define MAX_CHUNKS 256
 #define MAX_HEIGHT 32
 #define RENDER_DISTANCE 3
+// Oltre RENDER_DISTANCE + CHUNK_EVICT_MARGIN (in chunk) i chunk vengono scaricati
+#define CHUNK_EVICT_MARGIN 3
+#define CHUNK_KEEP_DISTANCE (RENDER_DISTANCE + CHUNK_EVICT_MARGIN)
+#define MAX_CHUNK_LISTENERS 4
 #define WATER_LEVEL 4.0f
 
+// Lato (in colonne) dei tile della mip delle altezze massime
+#define HEIGHT_MIP_TILE 4
+#define HEIGHT_MIP_SIZE (CHUNK_SIZE / HEIGHT_MIP_TILE)
+
+// Indice nel blocco voxel di un chunk (CHUNK_SIZE x MAX_HEIGHT x CHUNK_SIZE)
+#define VOXEL_INDEX(x, y, z) (((x) * MAX_HEIGHT + (y)) * CHUNK_SIZE + (z))
+
 // RIMOSSA la ridefinizione di BlockType - ora usa quella da blockTypes.h
 
 typedef struct Chunk {
     int chunkX, chunkZ;
     bool generated;
     bool meshGenerated;
-    float heightMap[CHUNK_SIZE + 1][CHUNK_SIZE + 1]; 
+    bool populated;  // onLoaded già inviato ai listener
+    float heightMap[CHUNK_SIZE + 1][CHUNK_SIZE + 1];  // voxel solido più alto per colonna
     float liquidMap[CHUNK_SIZE + 1][CHUNK_SIZE + 1];
     int*** oreMap;  // ← Puntatore a 3D array
+    unsigned char* voxels;  // BlockType per voxel, indicizzato con VOXEL_INDEX
+    // Mip delle altezze: voxel solido più alto per tile 4x4 e per l'intero chunk.
+    // Permette ai raycast di saltare lo spazio vuoto sopra il terreno.
+    int maxTop;
+    unsigned char tileTop[HEIGHT_MIP_SIZE][HEIGHT_MIP_SIZE];
     Mesh mesh;
 } Chunk;
 
+// Ciclo di vita dei chunk: onLoaded quando un chunk generato entra nel raggio
+// di vista, onEvicted prima che venga scaricato (o il mondo ripulito).
+// Decorazioni e monumenti vivono e muoiono con il loro chunk.
+typedef void (*ChunkEventFn)(void* user, Chunk* chunk);
+typedef struct ChunkListener {
+    ChunkEventFn onLoaded;
+    ChunkEventFn onEvicted;
+    void* user;
+} ChunkListener;
+
+// Sorgente dei chunk consultata prima del generatore (la cache su disco):
+// true se ha riempito il chunk
+typedef bool (*ChunkSourceFn)(void* user, Chunk* chunk);
+typedef struct ChunkSource {
+    ChunkSourceFn load;
+    void* user;
+} ChunkSource;
+
+// Voxel cambiato dal giocatore: indice VOXEL_INDEX e blocco finale
+typedef struct VoxelEdit {
+    int index;
+    unsigned char block;
+} VoxelEdit;
+
 typedef struct World {
     Chunk chunks[MAX_CHUNKS];
     int chunkCount;
+    // Incrementato a ogni modifica del terreno (chunk generati, blocchi rimossi/piazzati)
+    unsigned int terrainVersion;
+    // Azzerati da WorldInit: vanno registrati dopo ogni inizializzazione
+    ChunkListener listeners[MAX_CHUNK_LISTENERS];
+    int listenerCount;
+    ChunkSource source;
+    // Modifiche del giocatore per chunk (x, z), rigiocate quando un chunk
+    // scaricato torna: scavi e costruzioni durano quanto il mondo
+    std::map<std::pair<int, int>, std::vector<VoxelEdit>> edits;
     
     Texture2D grassTopTexture;
     Texture2D dirtSideTexture;
@@ -36,22 +89,41 @@ typedef struct World {
 
 // Forward declaration
 struct DimensionConfig;
+struct BiomeMap;
 
 void WorldInit(World *world);
 void WorldUpdate(World *world, Vector3 playerPos);
 void WorldDraw(World *world);
 void WorldCleanup(World* world);
+void WorldAddChunkListener(World* world, ChunkListener listener);
+// Azzerata da WorldInit come i listener
+void WorldSetChunkSource(World* world, ChunkSource source);
 
 float GetTerrainHeightAt(World *world, float x, float z);
 BlockType GetBlockAt(World *world, int x, int y, int z);
 
 void SetWorldDimension(int dimension);
+// true = terreno a densità 3D con grotte, false = heightfield classico
+void SetWorldTerrainMode(bool densityTerrain);
+// Da chiamare dopo SetWorldDimension (usa lo stesso seed)
+void SetWorldBiomes(struct DimensionConfig* dimension);
+const struct BiomeMap* GetWorldBiomeMap();
 void SetDimensionColors(Color grassTop, Color dirtSide, Color dirt);
 void RegenerateAllChunks(World* world);
 
 void WorldLoadTextures(World* world, struct DimensionConfig* dimension);
 void WorldUnloadTextures(World* world);
 
+// Generazione senza GPU (pre-generazione offline e cache su disco).
+// WorldGenerateChunkData e WorldBuildChunkMesh non toccano stato condiviso:
+// chunk diversi possono essere generati in parallelo.
+Chunk* WorldGetChunk(World* world, int cx, int cz);  // crea il chunk se manca
+Chunk* WorldFindChunk(World* world, int cx, int cz);  // NULL se manca
+void WorldAllocChunkStorage(Chunk* c);
+void WorldGenerateChunkData(Chunk* c);               // voxel, altezze, liquidi, minerali
+bool WorldBuildChunkMesh(Chunk* c);                  // solo array CPU, niente upload
+void WorldUpdateChunkHeightMip(Chunk* c);            // da heightMap a tileTop/maxTop
+
 // Ritorna tipo blocco rimosso
 ItemType RemoveBlock(World* world, int x, int y, int z);
 bool PlaceBlock(World* world, int x, int y, int z, ItemType blockType);
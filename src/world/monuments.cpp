@@ -1,10 +1,26 @@
 #include "monuments.h"
+#include "firstWorld.h"
 #include "../core/cosmicState.h"
+#include "../core/spatialIndex.h"
+#include "../core/updateScheduler.h"
+#include "../rendering/effects.h"
+#include "../rendering/shaders.h"
 #include <raymath.h>
 #include <cmath>
 #include <stdlib.h>
 #include <cfloat>
-MonumentSystem::MonumentSystem() : m_initialized(false)
+
+// Fascia (m, in XZ) in cui l'obelisco passa dal modello all'impostor
+#define MONUMENT_IMPOSTOR_START 96.0f
+#define MONUMENT_IMPOSTOR_END 112.0f
+
+// Un chunk su MONUMENT_CHUNK_ODDS ospita un monumento (circa 2 nel raggio di vista)
+#define MONUMENT_CHUNK_ODDS 24
+// Chunk attorno all'origine senza monumenti: lo spawn resta libero
+#define MONUMENT_SPAWN_CLEARANCE 1
+
+MonumentSystem::MonumentSystem() : m_world(nullptr), m_seed(0), m_nextId(0),
+                                   m_fadeLoc(-1), m_hasImpostors(false), m_initialized(false)
 {
 }
 
@@ -18,7 +34,7 @@ MonumentSystem::~MonumentSystem()
 
 void MonumentSystem::Init()
 {
-    m_monuments.clear();
+    ClearMonuments();
     m_activeWatchers = 0;
     m_spawnTimer = 0;
     
@@ -31,8 +47,9 @@ void MonumentSystem::Init()
     bool modelLoaded = false;
     for (const char* path : monumentModelPaths) {
         if (FileExists(path)) {
-            m_obeliskModel = LoadModel(path);
-            if (m_obeliskModel.meshCount > 0) {
+            m_obeliskHandle = AssetCache::Get().AcquireModel(path);
+            if (m_obeliskHandle.IsValid()) {
+                m_obeliskModel = *AssetCache::Get().GetModel(m_obeliskHandle);
                 modelLoaded = true;
                 TraceLog(LOG_INFO, "✓ Monument model loaded: %s", path);
                 break;
@@ -62,10 +79,12 @@ void MonumentSystem::Init()
         }
     }
     
+    LoadImpostors();
+
     m_initialized = true;
     TraceLog(LOG_INFO, "✓ Monument System initialized");
 }
-void MonumentSystem::GenerateMonuments(Vector3 centerPos, int count)
+void MonumentSystem::Stream(World* world, int seed)
 {
     if (!m_initialized)
     {
@@ -73,39 +92,91 @@ void MonumentSystem::GenerateMonuments(Vector3 centerPos, int count)
         return;
     }
 
-    for (int i = 0; i < count; i++)
-    {
-        float angle = (rand() % 360) * DEG2RAD;
-        float distance = 50.0f + (rand() % 100);
+    m_world = world;
+    m_seed = seed;
+    WorldAddChunkListener(world, (ChunkListener){OnChunkLoaded, OnChunkEvicted, this});
+}
+
+void MonumentSystem::OnChunkLoaded(void* user, Chunk* chunk)
+{
+    MonumentSystem* self = (MonumentSystem*)user;
+    if (abs(chunk->chunkX) <= MONUMENT_SPAWN_CLEARANCE && abs(chunk->chunkZ) <= MONUMENT_SPAWN_CLEARANCE)
+        return;
+
+    RandomStream rng = RandomStream::For(self->m_seed, RandomSystem::MONUMENTS, chunk->chunkX, chunk->chunkZ);
+    if (rng.NextInt(MONUMENT_CHUNK_ODDS) != 0)
+        return;
 
-        Vector3 pos = (Vector3){
-            centerPos.x + cosf(angle) * distance,
-            centerPos.y,
-            centerPos.z + sinf(angle) * distance};
+    // Lontano dai bordi, appoggiato al terreno del chunk
+    float x = (float)(chunk->chunkX * CHUNK_SIZE + 2 + rng.NextInt(CHUNK_SIZE - 4)) + 0.5f;
+    float z = (float)(chunk->chunkZ * CHUNK_SIZE + 2 + rng.NextInt(CHUNK_SIZE - 4)) + 0.5f;
+    Vector3 pos = {x, GetTerrainHeightAt(self->m_world, x, z), z};
+    EntityHandle h = self->CreateMonument(pos, rng);
 
-        CreateMonument(pos);
+    auto remembered = self->m_memory.find(std::make_tuple(self->m_seed, chunk->chunkX, chunk->chunkZ));
+    Monument* mon = EntityStore::Get().Find<Monument>(h);
+    if (remembered != self->m_memory.end() && mon)
+    {
+        mon->discovered = remembered->second.discovered;
+        mon->activated = remembered->second.activated;
     }
+}
 
-    TraceLog(LOG_INFO, "Generated %d monuments around (%.0f, %.0f, %.0f)",
-             count, centerPos.x, centerPos.y, centerPos.z);
+void MonumentSystem::OnChunkEvicted(void* user, Chunk* chunk)
+{
+    MonumentSystem* self = (MonumentSystem*)user;
+    EntityStore& store = EntityStore::Get();
+
+    for (size_t i = 0; i < self->m_monuments.size();)
+    {
+        EntityHandle h = self->m_monuments[i];
+        const EntityTransform* transform = store.Find<EntityTransform>(h);
+        const Monument* mon = store.Find<Monument>(h);
+        if (transform && mon &&
+            ((int)floorf(transform->position.x / CHUNK_SIZE) != chunk->chunkX ||
+             (int)floorf(transform->position.z / CHUNK_SIZE) != chunk->chunkZ))
+        {
+            i++;
+            continue;
+        }
+
+        if (mon && (mon->discovered || mon->activated))
+        {
+            self->m_memory[std::make_tuple(self->m_seed, chunk->chunkX, chunk->chunkZ)] =
+                {mon->discovered, mon->activated};
+        }
+        store.Destroy(h);
+        self->m_monuments[i] = self->m_monuments.back();
+        self->m_monuments.pop_back();
+    }
 }
 
-void MonumentSystem::CreateMonument(Vector3 pos)
+EntityHandle MonumentSystem::CreateMonument(Vector3 pos, RandomStream& rng)
 {
+    EntityTransform transform;
+    transform.position = pos;
+    transform.scale = 1.0f;
+
     Monument mon;
-    mon.position = pos;
-    mon.height = 6.0f + (rand() % 4);
-    mon.buriedDepth = 0.3f + ((rand() % 20) / 100.0f);
+    mon.height = 6.0f + rng.NextInt(4);
+    mon.buriedDepth = 0.3f + (rng.NextInt(20) / 100.0f);
     mon.pulseIntensity = 0.0f;
     mon.activationRadius = 5.0f;
     mon.discovered = false;
     mon.activated = false;
-    mon.id = m_monuments.size();
+    mon.id = m_nextId++;
     mon.glowColor = (Color){150, 50, 255, 255};
     mon.rotationAngle = 0.0f;
     mon.particleTimer = 0.0f;
 
-    m_monuments.push_back(mon);
+    EntityHandle h = EntityStore::Get().Create(transform, mon, UpdateScheduler::Get().NewSchedule());
+    m_monuments.push_back(h);
+
+    // Sfera che contiene l'obelisco e la luce in cima
+    Vector3 center = pos;
+    center.y += mon.height * 0.5f;
+    SpatialIndex::Get().Insert(h, SPATIAL_MONUMENT, center, mon.height * 0.5f + 1.0f);
+    return h;
 }
 
 void MonumentSystem::Update(Vector3 playerPos, float deltaTime)
@@ -113,120 +184,167 @@ void MonumentSystem::Update(Vector3 playerPos, float deltaTime)
     if (!m_initialized)
         return;
 
-    for (auto &mon : m_monuments)
-    {
-        float dist = Vector3Distance(playerPos, mon.position);
-
-        if (dist < 30.0f && !mon.discovered)
+    // I monumenti lontani (solo animazione) girano ogni 4 o 16 tick;
+    // entro il raggio di scoperta sono sempre nella fascia vicina
+    UpdateScheduler &scheduler = UpdateScheduler::Get();
+    EntityStore::Get().ForEach<EntityTransform, Monument, UpdateSchedule>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, Monument* monuments, UpdateSchedule* schedules) {
+        for (int i = 0; i < count; i++)
         {
-            mon.discovered = true;
-            TraceLog(LOG_INFO, "🗿 Monument #%d discovered at distance %.1f", mon.id, dist);
-        }
+            Vector3 position = transforms[i].position;
+            float dt = scheduler.Step(schedules[i], position, deltaTime);
+            if (dt <= 0.0f)
+                continue;
+
+            Monument &mon = monuments[i];
+            float dist = Vector3Distance(playerPos, position);
+
+            // Scoperto solo se visibile: la cima non deve essere nascosta dal terreno
+            bool inSight = false;
+            if (dist < 30.0f && !mon.discovered)
+            {
+                Vector3 top = position;
+                top.y += mon.height * 0.8f;
+                LineOfSight::Get().Submit(LosOwner::MONUMENT, mon.id, playerPos, top);
+                inSight = LineOfSight::Get().IsVisible(LosOwner::MONUMENT, mon.id, false);
+            }
 
-        if (dist < mon.activationRadius && !mon.activated && mon.discovered)
-        {
-            mon.activated = true;
-            mon.pulseIntensity = 1.0f;
-            CosmicState::Get().OnMonumentActivated();
-            TraceLog(LOG_WARNING, "⚡ Monument #%d ACTIVATED! Reality trembles...", mon.id);
-        }
+            if (dist < 30.0f && !mon.discovered && (inSight || dist < mon.activationRadius))
+            {
+                mon.discovered = true;
+                TraceLog(LOG_INFO, "🗿 Monument #%d discovered at distance %.1f", mon.id, dist);
+            }
 
-        if (mon.discovered)
-        {
-            mon.pulseIntensity = 0.5f + sinf(GetTime() * 2.0f + mon.id) * 0.5f;
-            mon.rotationAngle += deltaTime * 20.0f;
-            if (mon.rotationAngle > 360.0f)
-                mon.rotationAngle -= 360.0f;
-        }
+            if (dist < mon.activationRadius && !mon.activated && mon.discovered)
+            {
+                mon.activated = true;
+                mon.pulseIntensity = 1.0f;
+                CosmicState::Get().OnMonumentActivated();
+                TraceLog(LOG_WARNING, "⚡ Monument #%d ACTIVATED! Reality trembles...", mon.id);
+            }
 
-        if (mon.activated)
-        {
-            mon.particleTimer += deltaTime;
+            if (mon.discovered)
+            {
+                mon.pulseIntensity = 0.5f + sinf(GetTime() * 2.0f + mon.id) * 0.5f;
+                mon.rotationAngle += dt * 20.0f;
+                if (mon.rotationAngle > 360.0f)
+                    mon.rotationAngle -= 360.0f;
+            }
+
+            if (mon.activated)
+            {
+                mon.particleTimer += dt;
+            }
         }
-    }
+    });
 }
 
-void MonumentSystem::Draw()
+void MonumentSystem::DrawImpostorVariant(void* user, int /*variant*/)
 {
-    if (!m_initialized)
-        return;
-
-    for (const auto &mon : m_monuments)
-    {
-        if (!mon.discovered)
-            continue;
-
-        Vector3 drawPos = mon.position;
-        
-        // Calcola lo scale corretto basato sull'altezza del modello
-        float targetHeight = 8.0f; // Altezza desiderata in metri
-        float scaleFactor = targetHeight / m_modelBaseHeight;
-
-        // ✅ NOME CORRETTO: m_obeliskModel
-        DrawModelEx(
-            m_obeliskModel,  // <-- Era m_watcherModel, ora corretto
-            drawPos,
-            (Vector3){0, 1, 0},
-            mon.rotationAngle,
-            (Vector3){scaleFactor, scaleFactor, scaleFactor},
-            WHITE);
-            
-        DrawMonumentEffects(mon);
-    }
+    MonumentSystem* self = (MonumentSystem*)user;
+    DrawModel(self->m_obeliskModel, (Vector3){0, 0, 0}, 1.0f, WHITE);
 }
 
-void MonumentSystem::DrawMonumentEffects(const Monument &mon)
+// Shader a retino sui materiali del modello e atlante cotto una volta
+void MonumentSystem::LoadImpostors()
 {
-    Color glowColor = Fade(mon.glowColor, mon.pulseIntensity * 0.6f);
+    m_hasImpostors = false;
+    m_impostors.loaded = false;
 
-    int particleCount = mon.activated ? 20 : 10;
-    for (int i = 0; i < particleCount; i++)
+    m_fadeShader = LoadCachedShader("assets/shaders/glsl330/dither_fade.vs",
+                                    "assets/shaders/glsl330/dither_fade.fs");
+    if (m_fadeShader.id == 0)
+        return;
+    if (!LoadImpostorAtlas(&m_impostors, 1))
     {
-        float angle = (GetTime() * 50.0f + i * 360.0f / particleCount) * DEG2RAD;
-        float radius = 2.0f + sinf(GetTime() * 2.0f + i) * 0.5f;
+        m_fadeShader.id = 0;
+        return;
+    }
 
-        Vector3 pPos = (Vector3){
-            mon.position.x + cosf(angle) * radius,
-            mon.position.y + mon.height * 0.5f + sinf(GetTime() * 3.0f + i) * 2.0f,
-            mon.position.z + sinf(angle) * radius};
+    m_fadeLoc = GetCachedShaderLocation(m_fadeShader, "fade");
+    for (int i = 0; i < m_obeliskModel.materialCount; i++)
+        m_obeliskModel.materials[i].shader = m_fadeShader;
 
-        DrawSphere(pPos, 0.1f, glowColor);
-    }
+    float fade = 0.0f;
+    SetShaderValue(m_fadeShader, m_fadeLoc, &fade, SHADER_UNIFORM_FLOAT);
+    BakeImpostor(&m_impostors, 0, GetModelBoundingBox(m_obeliskModel), DrawImpostorVariant, this);
 
-    if (mon.activated)
-    {
-        for (int i = 0; i < 6; i++)
-        {
-            float y = mon.position.y + (i / 6.0f) * mon.height;
-            DrawCircle3D(
-                (Vector3){mon.position.x, y, mon.position.z},
-                0.6f,
-                (Vector3){1, 0, 0},
-                90.0f,
-                Fade(mon.glowColor, mon.pulseIntensity * 0.8f));
-        }
+    m_hasImpostors = true;
+    TraceLog(LOG_INFO, "✓ Monument impostor baked");
+}
 
-        int beamCount = 8;
-        for (int i = 0; i < beamCount; i++)
-        {
-            float angle = (GetTime() * 30.0f + i * 360.0f / beamCount) * DEG2RAD;
-            float beamLength = 3.0f + sinf(GetTime() * 2.0f + i) * 1.0f;
+void MonumentSystem::Draw(Camera3D camera)
+{
+    if (!m_initialized)
+        return;
 
-            Vector3 start = mon.position;
-            start.y += mon.height;
+    static std::vector<Matrix> farMonuments;
+    farMonuments.clear();
 
-            Vector3 end = (Vector3){
-                start.x + cosf(angle) * beamLength,
-                start.y + 2.0f,
-                start.z + sinf(angle) * beamLength};
+    EntityStore::Get().ForEach<EntityTransform, Monument>(
+        [&](int count, const EntityHandle*, EntityTransform* transforms, Monument* monuments) {
+        for (int i = 0; i < count; i++)
+        {
+            const Monument &mon = monuments[i];
+            if (!mon.discovered)
+                continue;
+
+            Vector3 drawPos = transforms[i].position;
+        
+            // Calcola lo scale corretto basato sull'altezza del modello
+            float targetHeight = 8.0f; // Altezza desiderata in metri
+            float scaleFactor = targetHeight / m_modelBaseHeight;
+
+            float dx = drawPos.x - camera.position.x;
+            float dz = drawPos.z - camera.position.z;
+            float distance = sqrtf(dx * dx + dz * dz);
+
+            if (!m_hasImpostors || distance < MONUMENT_IMPOSTOR_END)
+            {
+                // Stessa dissolvenza (smoothstep) che lo shader dell'impostor calcola per istanza
+                if (m_hasImpostors)
+                {
+                    float t = Clamp((distance - MONUMENT_IMPOSTOR_START) /
+                                    (MONUMENT_IMPOSTOR_END - MONUMENT_IMPOSTOR_START), 0.0f, 1.0f);
+                    float fade = t * t * (3.0f - 2.0f * t);
+                    SetShaderValue(m_fadeShader, m_fadeLoc, &fade, SHADER_UNIFORM_FLOAT);
+                }
+
+                // ✅ NOME CORRETTO: m_obeliskModel
+                DrawModelEx(
+                    m_obeliskModel,  // <-- Era m_watcherModel, ora corretto
+                    drawPos,
+                    (Vector3){0, 1, 0},
+                    mon.rotationAngle,
+                    (Vector3){scaleFactor, scaleFactor, scaleFactor},
+                    WHITE);
+            }
+            if (m_hasImpostors && distance > MONUMENT_IMPOSTOR_START)
+            {
+                // Stessa trasformazione di DrawModelEx: scala, rotazione, traslazione
+                Matrix transform = MatrixMultiply(MatrixScale(scaleFactor, scaleFactor, scaleFactor),
+                                                  MatrixRotateY(mon.rotationAngle * DEG2RAD));
+                farMonuments.push_back(MatrixMultiply(transform, MatrixTranslate(drawPos.x, drawPos.y, drawPos.z)));
+            }
 
-            DrawLine3D(start, end, Fade(mon.glowColor, mon.pulseIntensity * 0.4f));
+            DrawMonumentEffects(drawPos, mon);
         }
-    }
+    });
+
+    DrawImpostors(&m_impostors, 0, farMonuments.data(), (int)farMonuments.size(), camera,
+                  MONUMENT_IMPOSTOR_START, MONUMENT_IMPOSTOR_END);
+}
 
-    Vector3 topPos = mon.position;
-    topPos.y += mon.height + 0.5f;
-    DrawSphere(topPos, 0.3f, Fade(mon.glowColor, mon.pulseIntensity));
+// Particelle, anelli e raggi li anima lo shader degli effetti
+void MonumentSystem::DrawMonumentEffects(Vector3 position, const Monument &mon)
+{
+    EffectEmitter emitter = {};
+    emitter.position = position;
+    emitter.size = mon.height;
+    emitter.color = mon.glowColor;
+    emitter.params[0] = mon.pulseIntensity;
+    emitter.params[1] = mon.activated ? 1.0f : 0.0f;
+    PushEffect(EFFECT_MONUMENT, &emitter);
 }
 
 bool MonumentSystem::IsNearMonument(Vector3 pos, float *distance)
@@ -234,25 +352,37 @@ bool MonumentSystem::IsNearMonument(Vector3 pos, float *distance)
     if (!m_initialized)
         return false;
 
-    for (const auto &mon : m_monuments)
+    static std::vector<SpatialHit> candidates;
+    candidates.clear();
+    SpatialIndex::Get().QueryRadius(pos, 10.0f, SPATIAL_MONUMENT, candidates);
+
+    // La distanza conta dalla base, non dal centro della sfera registrata
+    float nearest = FLT_MAX;
+    for (const SpatialHit &candidate : candidates)
     {
-        float dist = Vector3Distance(pos, mon.position);
-        if (dist < 10.0f)
-        {
-            if (distance)
-                *distance = dist;
-            return true;
-        }
+        const EntityTransform *transform = EntityStore::Get().Find<EntityTransform>(candidate.handle);
+        if (!transform)
+            continue;
+
+        float dist = Vector3Distance(pos, transform->position);
+        if (dist < 10.0f && dist < nearest)
+            nearest = dist;
     }
-    return false;
+
+    if (nearest == FLT_MAX)
+        return false;
+    if (distance)
+        *distance = nearest;
+    return true;
 }
 
 int MonumentSystem::GetDiscoveredCount() const
 {
     int count = 0;
-    for (const auto &mon : m_monuments)
+    for (EntityHandle h : m_monuments)
     {
-        if (mon.discovered)
+        const Monument *mon = EntityStore::Get().Find<Monument>(h);
+        if (mon && mon->discovered)
             count++;
     }
     return count;
@@ -261,21 +391,43 @@ int MonumentSystem::GetDiscoveredCount() const
 int MonumentSystem::GetActivatedCount() const
 {
     int count = 0;
-    for (const auto &mon : m_monuments)
+    for (EntityHandle h : m_monuments)
     {
-        if (mon.activated)
+        const Monument *mon = EntityStore::Get().Find<Monument>(h);
+        if (mon && mon->activated)
             count++;
     }
     return count;
 }
 
+void MonumentSystem::ClearMonuments()
+{
+    for (EntityHandle h : m_monuments)
+        EntityStore::Get().Destroy(h);
+    m_monuments.clear();
+}
+
 void MonumentSystem::Cleanup()
 {
     if (!m_initialized)
         return;
 
-    UnloadModel(m_obeliskModel);
-    m_monuments.clear();
+    // UnloadModel non scarica gli shader dei materiali
+    if (m_obeliskHandle.IsValid())
+    {
+        AssetCache::Get().Release(m_obeliskHandle);
+        m_obeliskHandle = NULL_MODEL;
+    }
+    else
+    {
+        UnloadModel(m_obeliskModel);
+    }
+    if (m_hasImpostors)
+    {
+        UnloadImpostorAtlas(&m_impostors);
+        m_hasImpostors = false;
+    }
+    ClearMonuments();
     m_initialized = false;
 
     TraceLog(LOG_INFO, "✓ Monument System cleaned up");
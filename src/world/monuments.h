@@ -1,10 +1,20 @@
 #pragma once
 
 #include "raylib.h"
+#include <map>
+#include <tuple>
 #include <vector>
+#include "../core/random.h"
+#include "../core/lineOfSight.h"
+#include "../core/entityStore.h"
+#include "../core/assetCache.h"
+#include "../rendering/impostor.h"
 
+struct World;
+struct Chunk;
+
+// Componente dei monumenti (posizione in EntityTransform)
 struct Monument {
-    Vector3 position;
     float height;
     float pulseIntensity;
     float activationRadius;
@@ -23,9 +33,11 @@ public:
     ~MonumentSystem();
     
     void Init();
-    void GenerateMonuments(Vector3 centerPos, int count);
+    // Monumenti generati per chunk (stesso seed, stessi monumenti) e
+    // distrutti quando il chunk viene scaricato; da chiamare dopo ogni WorldInit
+    void Stream(World* world, int seed);
     void Update(Vector3 playerPos, float deltaTime);
-    void Draw();
+    void Draw(Camera3D camera);
     void Cleanup();
     
     bool IsNearMonument(Vector3 pos, float* distance);
@@ -33,12 +45,34 @@ public:
     int GetActivatedCount() const;
 
 private:
-    std::vector<Monument> m_monuments;
+    // Stato di gioco che sopravvive allo scaricamento del chunk
+    struct MonumentMemory {
+        bool discovered;
+        bool activated;
+    };
+
+    std::vector<EntityHandle> m_monuments;
+    World* m_world;
+    int m_seed;
+    int m_nextId;
+    // Chiave (seed, chunk x, chunk z)
+    std::map<std::tuple<int, int, int>, MonumentMemory> m_memory;
     Model m_obeliskModel;
+    ModelHandle m_obeliskHandle{};   // nullo con il cilindro procedurale
+    // Da lontano l'obelisco è un impostor; vicino il modello si dissolve a retino
+    ImpostorAtlas m_impostors;
+    Shader m_fadeShader;
+    int m_fadeLoc;
+    bool m_hasImpostors;
     bool m_initialized;
     float m_spawnTimer;
     float m_activeWatchers;
     float m_modelBaseHeight;
-    void CreateMonument(Vector3 pos);
-    void DrawMonumentEffects(const Monument& mon);
+    EntityHandle CreateMonument(Vector3 pos, RandomStream& rng);
+    void ClearMonuments();
+    void DrawMonumentEffects(Vector3 position, const Monument& mon);
+    void LoadImpostors();
+    static void DrawImpostorVariant(void* user, int variant);
+    static void OnChunkLoaded(void* user, Chunk* chunk);
+    static void OnChunkEvicted(void* user, Chunk* chunk);
 };
\ No newline at end of file
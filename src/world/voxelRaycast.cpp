@@ -0,0 +1,155 @@
+#include "voxelRaycast.h"
+#include "raymath.h"
+#include <float.h>
+#include <math.h>
+
+// Spostamento oltre un bordo quando la traversata riparte dopo un salto
+#define RAY_RESTART_EPSILON 1e-4f
+
+static int FloorDiv(int a, int b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+// Tempo di uscita dal rettangolo XZ [minX, maxX] x [minZ, maxZ] e asse di uscita
+static float ExitTimeXZ(Vector3 origin, Vector3 dir, float minX, float maxX, float minZ, float maxZ,
+                        int* exitAxis) {
+    float tx = FLT_MAX;
+    float tz = FLT_MAX;
+    if (dir.x > 0.0f) tx = (maxX - origin.x) / dir.x;
+    else if (dir.x < 0.0f) tx = (minX - origin.x) / dir.x;
+    if (dir.z > 0.0f) tz = (maxZ - origin.z) / dir.z;
+    else if (dir.z < 0.0f) tz = (minZ - origin.z) / dir.z;
+
+    *exitAxis = (tx < tz) ? 0 : 2;
+    return (tx < tz) ? tx : tz;
+}
+
+VoxelHit RaycastVoxels(World* world, Vector3 origin, Vector3 direction, float maxDistance) {
+    VoxelHit result = {};
+    result.hit = false;
+
+    float len = Vector3Length(direction);
+    if (len < 1e-6f) return result;
+    Vector3 dir = Vector3Scale(direction, 1.0f / len);
+
+    int stepX = (dir.x > 0.0f) ? 1 : ((dir.x < 0.0f) ? -1 : 0);
+    int stepY = (dir.y > 0.0f) ? 1 : ((dir.y < 0.0f) ? -1 : 0);
+    int stepZ = (dir.z > 0.0f) ? 1 : ((dir.z < 0.0f) ? -1 : 0);
+    float tDeltaX = stepX ? fabsf(1.0f / dir.x) : FLT_MAX;
+    float tDeltaY = stepY ? fabsf(1.0f / dir.y) : FLT_MAX;
+    float tDeltaZ = stepZ ? fabsf(1.0f / dir.z) : FLT_MAX;
+
+    // Ultimo chunk visitato: la ricerca lineare avviene solo cambiando chunk
+    Chunk* chunk = NULL;
+    int chunkX = 0, chunkZ = 0;
+    bool chunkValid = false;
+
+    float t = 0.0f;
+    int normalX = 0, normalY = 0, normalZ = 0;
+
+    while (t <= maxDistance) {
+        // (Ri)partenza della traversata dal punto a distanza t
+        Vector3 p = Vector3Add(origin, Vector3Scale(dir, t + (t > 0.0f ? RAY_RESTART_EPSILON : 0.0f)));
+        int x = (int)floorf(p.x);
+        int y = (int)floorf(p.y);
+        int z = (int)floorf(p.z);
+
+        float tMaxX = stepX ? (((stepX > 0) ? (x + 1 - origin.x) : (x - origin.x)) / dir.x) : FLT_MAX;
+        float tMaxY = stepY ? (((stepY > 0) ? (y + 1 - origin.y) : (y - origin.y)) / dir.y) : FLT_MAX;
+        float tMaxZ = stepZ ? (((stepZ > 0) ? (z + 1 - origin.z) : (z - origin.z)) / dir.z) : FLT_MAX;
+
+        bool restart = false;
+        while (!restart && t <= maxDistance) {
+            // Fuori dal mondo e in allontanamento: niente da colpire
+            if ((y < 0 && stepY <= 0) || (y >= MAX_HEIGHT && stepY >= 0)) return result;
+
+            int cx = FloorDiv(x, CHUNK_SIZE);
+            int cz = FloorDiv(z, CHUNK_SIZE);
+            if (!chunkValid || cx != chunkX || cz != chunkZ) {
+                chunk = WorldFindChunk(world, cx, cz);
+                chunkX = cx;
+                chunkZ = cz;
+                chunkValid = true;
+            }
+
+            float minX = (float)(cx * CHUNK_SIZE);
+            float minZ = (float)(cz * CHUNK_SIZE);
+            int lx = x - cx * CHUNK_SIZE;
+            int lz = z - cz * CHUNK_SIZE;
+
+            // Livello della mip: chunk intero, poi tile 4x4
+            bool empty = (!chunk || !chunk->generated);
+            int top = MAX_HEIGHT;
+            float boxMinX = minX, boxMaxX = minX + CHUNK_SIZE;
+            float boxMinZ = minZ, boxMaxZ = minZ + CHUNK_SIZE;
+            if (!empty) {
+                top = chunk->maxTop;
+                if (y <= top) {
+                    int tx = lx / HEIGHT_MIP_TILE;
+                    int tz = lz / HEIGHT_MIP_TILE;
+                    top = chunk->tileTop[tx][tz];
+                    boxMinX = minX + tx * HEIGHT_MIP_TILE;
+                    boxMaxX = boxMinX + HEIGHT_MIP_TILE;
+                    boxMinZ = minZ + tz * HEIGHT_MIP_TILE;
+                    boxMaxZ = boxMinZ + HEIGHT_MIP_TILE;
+                }
+            }
+
+            if (empty || y > top) {
+                // Salta fino all'uscita dal box o finché il raggio scende al livello del terreno
+                int exitAxis = 0;
+                float tSkip = ExitTimeXZ(origin, dir, boxMinX, boxMaxX, boxMinZ, boxMaxZ, &exitAxis);
+                bool down = false;
+                if (!empty && dir.y < 0.0f) {
+                    float tDown = ((float)(top + 1) - origin.y) / dir.y;
+                    if (tDown < tSkip) {
+                        tSkip = tDown;
+                        down = true;
+                    }
+                }
+
+                float tNext = fminf(tMaxX, fminf(tMaxY, tMaxZ));
+                if (tSkip > tNext) {
+                    if (tSkip > maxDistance) return result;
+                    t = tSkip;
+                    normalX = (!down && exitAxis == 0) ? -stepX : 0;
+                    normalY = down ? 1 : 0;
+                    normalZ = (!down && exitAxis == 2) ? -stepZ : 0;
+                    restart = true;
+                    continue;
+                }
+            } else if (y >= 0 && chunk->voxels[VOXEL_INDEX(lx, y, lz)] != BLOCK_AIR) {
+                result.hit = true;
+                result.x = x;
+                result.y = y;
+                result.z = z;
+                result.normalX = normalX;
+                result.normalY = normalY;
+                result.normalZ = normalZ;
+                result.distance = t;
+                result.point = Vector3Add(origin, Vector3Scale(dir, t));
+                return result;
+            }
+
+            // Passo DDA verso il voxel adiacente più vicino
+            if (tMaxX < tMaxY && tMaxX < tMaxZ) {
+                x += stepX;
+                t = tMaxX;
+                tMaxX += tDeltaX;
+                normalX = -stepX; normalY = 0; normalZ = 0;
+            } else if (tMaxY < tMaxZ) {
+                y += stepY;
+                t = tMaxY;
+                tMaxY += tDeltaY;
+                normalX = 0; normalY = -stepY; normalZ = 0;
+            } else {
+                z += stepZ;
+                t = tMaxZ;
+                tMaxZ += tDeltaZ;
+                normalX = 0; normalY = 0; normalZ = -stepZ;
+            }
+        }
+    }
+
+    return result;
+}
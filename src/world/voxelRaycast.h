@@ -0,0 +1,21 @@
+#ifndef VOXELRAYCAST_H
+#define VOXELRAYCAST_H
+
+#include "raylib.h"
+#include "firstWorld.h"
+
+typedef struct VoxelHit {
+    bool hit;
+    int x, y, z;                      // voxel colpito (coordinate mondo)
+    int normalX, normalY, normalZ;    // normale della faccia d'ingresso
+    float distance;                   // distanza dall'origine al punto d'ingresso
+    Vector3 point;                    // punto d'ingresso sulla faccia
+} VoxelHit;
+
+// Attraversamento esatto della griglia (Amanatides–Woo): visita ogni voxel
+// toccato dal raggio, senza passi fissi e senza attraversare blocchi sottili.
+// Le regioni sopra la mip delle altezze (chunk e tile 4x4) e i chunk non
+// generati vengono saltate in un solo passo.
+VoxelHit RaycastVoxels(World* world, Vector3 origin, Vector3 direction, float maxDistance);
+
+#endif
@@ -0,0 +1,258 @@
+#include "worldCache.h"
+#include "dimensions.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <utility>
+
+// I minerali sono ItemType: stanno in un byte
+static_assert((int)ItemType::DIAMOND < 256, "ore ids must fit in a byte");
+
+#define ORE_CELLS ((CHUNK_SIZE + 1) * MAX_HEIGHT * (CHUNK_SIZE + 1))
+#define VOXEL_CELLS (CHUNK_SIZE * MAX_HEIGHT * CHUNK_SIZE)
+
+typedef struct WorldCacheHeader {
+    char magic[4];
+    int version;
+    int dimensionId;
+    int terrainSeed;
+    int densityTerrain;
+    int chunkSize;
+    int maxHeight;
+    int chunkCount;
+    int hasMeshes;
+} WorldCacheHeader;
+
+static const char WORLD_CACHE_MAGIC[4] = {'D', 'W', 'C', 'H'};
+
+std::string GetWorldCachePath(const DimensionConfig* dim) {
+    return std::string(WORLD_CACHE_DIR) + "/dim_" + std::to_string(dim->id) + ".bin";
+}
+
+static bool WriteBytes(FILE* f, const void* data, size_t size) {
+    return size == 0 || fwrite(data, 1, size, f) == size;
+}
+
+static bool ReadBytes(FILE* f, void* data, size_t size) {
+    return size == 0 || fread(data, 1, size, f) == size;
+}
+
+static bool WriteChunk(FILE* f, const Chunk* c, bool includeMeshes) {
+    unsigned char ores[ORE_CELLS];
+    int n = 0;
+    for (int x = 0; x <= CHUNK_SIZE; x++) {
+        for (int y = 0; y < MAX_HEIGHT; y++) {
+            for (int z = 0; z <= CHUNK_SIZE; z++) {
+                ores[n++] = (unsigned char)c->oreMap[x][y][z];
+            }
+        }
+    }
+
+    bool ok = WriteBytes(f, &c->chunkX, sizeof(int)) &&
+              WriteBytes(f, &c->chunkZ, sizeof(int)) &&
+              WriteBytes(f, c->heightMap, sizeof(c->heightMap)) &&
+              WriteBytes(f, c->liquidMap, sizeof(c->liquidMap)) &&
+              WriteBytes(f, c->voxels, VOXEL_CELLS) &&
+              WriteBytes(f, ores, sizeof(ores));
+    if (!ok || !includeMeshes) return ok;
+
+    // Mesh: 3 float posizione, 3 normale, 2 uv, 4 byte colore per vertice
+    int vertexCount = c->mesh.vertices ? c->mesh.vertexCount : 0;
+    return WriteBytes(f, &vertexCount, sizeof(int)) &&
+           WriteBytes(f, c->mesh.vertices, vertexCount * 3 * sizeof(float)) &&
+           WriteBytes(f, c->mesh.normals, vertexCount * 3 * sizeof(float)) &&
+           WriteBytes(f, c->mesh.texcoords, vertexCount * 2 * sizeof(float)) &&
+           WriteBytes(f, c->mesh.colors, vertexCount * 4);
+}
+
+// Dati di un chunk dopo le coordinate; generated solo se letto per intero
+static bool ReadChunkData(FILE* f, Chunk* c, bool hasMeshes) {
+    WorldAllocChunkStorage(c);
+
+    unsigned char ores[ORE_CELLS];
+    if (!ReadBytes(f, c->heightMap, sizeof(c->heightMap)) ||
+        !ReadBytes(f, c->liquidMap, sizeof(c->liquidMap)) ||
+        !ReadBytes(f, c->voxels, VOXEL_CELLS) ||
+        !ReadBytes(f, ores, sizeof(ores))) {
+        return false;
+    }
+
+    int n = 0;
+    for (int x = 0; x <= CHUNK_SIZE; x++) {
+        for (int y = 0; y < MAX_HEIGHT; y++) {
+            for (int z = 0; z <= CHUNK_SIZE; z++) {
+                c->oreMap[x][y][z] = ores[n++];
+            }
+        }
+    }
+    WorldUpdateChunkHeightMip(c);
+
+    if (!hasMeshes) {
+        c->generated = true;
+        return true;
+    }
+
+    int vertexCount = 0;
+    if (!ReadBytes(f, &vertexCount, sizeof(int)) || vertexCount < 0) return false;
+    c->generated = true;
+    if (vertexCount == 0) return true;
+
+    Mesh mesh;
+    memset(&mesh, 0, sizeof(Mesh));
+    mesh.vertexCount = vertexCount;
+    mesh.triangleCount = vertexCount / 3;
+    mesh.vertices = (float*)malloc(vertexCount * 3 * sizeof(float));
+    mesh.normals = (float*)malloc(vertexCount * 3 * sizeof(float));
+    mesh.texcoords = (float*)malloc(vertexCount * 2 * sizeof(float));
+    mesh.colors = (unsigned char*)malloc(vertexCount * 4);
+
+    bool ok = mesh.vertices && mesh.normals && mesh.texcoords && mesh.colors &&
+              ReadBytes(f, mesh.vertices, vertexCount * 3 * sizeof(float)) &&
+              ReadBytes(f, mesh.normals, vertexCount * 3 * sizeof(float)) &&
+              ReadBytes(f, mesh.texcoords, vertexCount * 2 * sizeof(float)) &&
+              ReadBytes(f, mesh.colors, vertexCount * 4);
+    if (!ok) {
+        free(mesh.vertices);
+        free(mesh.normals);
+        free(mesh.texcoords);
+        free(mesh.colors);
+        c->generated = false;
+        return false;
+    }
+
+    // Mesh già pronta: WorldUpdate non dovrà ricostruirla
+    c->mesh = mesh;
+    UploadMesh(&c->mesh, false);
+    c->meshGenerated = true;
+    return true;
+}
+
+// Posizione nel file di ogni chunk dell'ultima cache caricata: un chunk
+// scaricato e tornato nel raggio viene riletto da qui invece che rigenerato
+typedef struct WorldCacheIndex {
+    std::string path;
+    bool hasMeshes;
+    std::map<std::pair<int, int>, long> offsets;
+} WorldCacheIndex;
+
+static WorldCacheIndex cacheIndex;
+
+static bool ReadChunk(FILE* f, World* world, bool hasMeshes) {
+    long offset = ftell(f);
+    int cx, cz;
+    if (!ReadBytes(f, &cx, sizeof(int)) || !ReadBytes(f, &cz, sizeof(int))) return false;
+
+    Chunk* c = WorldGetChunk(world, cx, cz);
+    if (!c) return false;
+    cacheIndex.offsets[std::make_pair(cx, cz)] = offset;
+    return ReadChunkData(f, c, hasMeshes);
+}
+
+static bool RestoreCachedChunk(void* user, Chunk* c) {
+    WorldCacheIndex* index = (WorldCacheIndex*)user;
+    auto it = index->offsets.find(std::make_pair(c->chunkX, c->chunkZ));
+    if (it == index->offsets.end()) return false;
+
+    FILE* f = fopen(index->path.c_str(), "rb");
+    if (!f) return false;
+
+    int cx, cz;
+    bool ok = fseek(f, it->second, SEEK_SET) == 0 &&
+              ReadBytes(f, &cx, sizeof(int)) && ReadBytes(f, &cz, sizeof(int)) &&
+              cx == c->chunkX && cz == c->chunkZ &&
+              ReadChunkData(f, c, index->hasMeshes);
+    fclose(f);
+
+    if (!ok) {
+        // File cambiato sotto i piedi: da qui in poi si genera
+        TraceLog(LOG_WARNING, "WorldCache: cannot restore chunk (%d, %d) from %s", c->chunkX, c->chunkZ,
+                 index->path.c_str());
+        index->offsets.clear();
+    }
+    return ok;
+}
+
+bool WorldCacheSave(const char* path, const DimensionConfig* dim, World* world, bool includeMeshes) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        TraceLog(LOG_WARNING, "WorldCache: cannot write %s", path);
+        return false;
+    }
+
+    int chunkCount = 0;
+    for (int i = 0; i < world->chunkCount; i++) {
+        if (world->chunks[i].generated) chunkCount++;
+    }
+
+    WorldCacheHeader header;
+    memcpy(header.magic, WORLD_CACHE_MAGIC, sizeof(header.magic));
+    header.version = WORLD_CACHE_VERSION;
+    header.dimensionId = dim->id;
+    header.terrainSeed = dim->terrainSeed;
+    header.densityTerrain = dim->useDensityTerrain ? 1 : 0;
+    header.chunkSize = CHUNK_SIZE;
+    header.maxHeight = MAX_HEIGHT;
+    header.chunkCount = chunkCount;
+    header.hasMeshes = includeMeshes ? 1 : 0;
+
+    bool ok = WriteBytes(f, &header, sizeof(header));
+    for (int i = 0; ok && i < world->chunkCount; i++) {
+        if (world->chunks[i].generated) {
+            ok = WriteChunk(f, &world->chunks[i], includeMeshes);
+        }
+    }
+
+    fclose(f);
+    if (!ok) {
+        TraceLog(LOG_WARNING, "WorldCache: write failed for %s", path);
+        remove(path);
+    }
+    return ok;
+}
+
+bool WorldCacheLoad(const char* path, const DimensionConfig* dim, World* world) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    WorldCacheHeader header;
+    bool compatible = ReadBytes(f, &header, sizeof(header)) &&
+                      memcmp(header.magic, WORLD_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                      header.version == WORLD_CACHE_VERSION &&
+                      header.dimensionId == dim->id &&
+                      header.terrainSeed == dim->terrainSeed &&
+                      header.densityTerrain == (dim->useDensityTerrain ? 1 : 0) &&
+                      header.chunkSize == CHUNK_SIZE &&
+                      header.maxHeight == MAX_HEIGHT &&
+                      header.chunkCount >= 0 && header.chunkCount <= MAX_CHUNKS;
+    if (!compatible) {
+        TraceLog(LOG_WARNING, "WorldCache: %s is stale or invalid, regenerating", path);
+        fclose(f);
+        return false;
+    }
+
+    cacheIndex.path = path;
+    cacheIndex.hasMeshes = header.hasMeshes != 0;
+    cacheIndex.offsets.clear();
+
+    bool ok = true;
+    for (int i = 0; ok && i < header.chunkCount; i++) {
+        ok = ReadChunk(f, world, header.hasMeshes != 0);
+    }
+    fclose(f);
+
+    if (!ok) {
+        // Cache troncata: riparti da un mondo vuoto
+        TraceLog(LOG_WARNING, "WorldCache: %s is truncated, regenerating", path);
+        WorldCleanup(world);
+        WorldInit(world);
+        cacheIndex.offsets.clear();
+        return false;
+    }
+
+    WorldSetChunkSource(world, (ChunkSource){RestoreCachedChunk, &cacheIndex});
+
+    TraceLog(LOG_INFO, "✓ WorldCache: loaded %d chunks from %s%s", header.chunkCount, path,
+             header.hasMeshes ? " (with meshes)" : "");
+    return true;
+}
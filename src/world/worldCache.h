@@ -0,0 +1,31 @@
+#ifndef WORLDCACHE_H
+#define WORLDCACHE_H
+
+#include "firstWorld.h"
+#include <string>
+
+// Cache su disco dei chunk attorno allo spawn, scritta dal tool di
+// pre-generazione (make pregen) e letta all'avvio / cambio dimensione.
+#define WORLD_CACHE_DIR "cache/world"
+// Da incrementare a ogni modifica del generatore: invalida le cache vecchie
+#define WORLD_CACHE_VERSION 4
+
+struct DimensionConfig;
+
+std::string GetWorldCachePath(const struct DimensionConfig* dim);
+
+// Salva i chunk generati del mondo: altezze, liquidi, voxel e minerali. Le
+// decorazioni non servono: dipendono solo dal seed e dalle altezze, e
+// vengono ricostruite dal chunk in cache quando entra nel raggio di vista
+// (listener dei chunk). Con includeMeshes vengono salvati anche gli array
+// CPU delle mesh (WorldBuildChunkMesh).
+bool WorldCacheSave(const char* path, const struct DimensionConfig* dim, World* world,
+                    bool includeMeshes);
+
+// Carica la cache se esiste ed è compatibile con la dimensione corrente.
+// Le mesh salvate vengono caricate subito sulla GPU (serve un contesto GL).
+// La cache diventa la sorgente dei chunk del mondo: un chunk scaricato che
+// torna nel raggio viene riletto dal file invece che rigenerato.
+bool WorldCacheLoad(const char* path, const struct DimensionConfig* dim, World* world);
+
+#endif
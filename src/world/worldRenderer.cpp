@@ -1,27 +1,41 @@
 #include "worldRenderer.h"
+#include "../rendering/shaders.h"
 #include <string.h>
 #include <raymath.h>
 
-static Material CreateTexturedMaterial(Texture2D tex, Color fallback, Shader fogShader) {
+static Material CreateTexturedMaterial(Texture2D tex, Color fallback, Shader terrainShader) {
     Material mat = LoadMaterialDefault();
     
-    // Applica fog shader al materiale
-    if (fogShader.id > 0) {
-        mat.shader = fogShader;
+    // Applica lo shader del terreno al materiale
+    if (terrainShader.id > 0) {
+        mat.shader = terrainShader;
     }
     
     if (tex.id != 0) {
         mat.maps[MATERIAL_MAP_DIFFUSE].texture = tex;
         mat.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
-        TraceLog(LOG_INFO, "Material created with texture ID: %d and fog shader", tex.id);
+        TraceLog(LOG_INFO, "Material created with texture ID: %d and terrain shader", tex.id);
     } else {
         mat.maps[MATERIAL_MAP_DIFFUSE].color = fallback;
-        TraceLog(LOG_WARNING, "Material created with fallback color and fog shader");
+        TraceLog(LOG_WARNING, "Material created with fallback color and terrain shader");
     }
     
     return mat;
 }
 
+unsigned int GetTerrainVariant(const DimensionConfig* dim) {
+    unsigned int variant = 0;
+    if (dim->useFog) variant |= TERRAIN_VARIANT_FOG;
+    if (!dim->grassTopTexture.empty()) variant |= TERRAIN_VARIANT_TEXTURED;
+    if (dim->waterLevel > 0.0f) variant |= TERRAIN_VARIANT_WATER;
+    return variant;
+}
+
+static void SetColorUniform(Shader shader, const char* name, Color color, float scale) {
+    float value[3] = {color.r * scale / 255.0f, color.g * scale / 255.0f, color.b * scale / 255.0f};
+    SetShaderValue(shader, GetCachedShaderLocation(shader, name), value, SHADER_UNIFORM_VEC3);
+}
+
 void InitWorldRenderer(WorldRenderer* wr, DimensionConfig* dim) {
     memset(wr, 0, sizeof(WorldRenderer));
     
@@ -33,38 +47,58 @@ void InitWorldRenderer(WorldRenderer* wr, DimensionConfig* dim) {
 
     TraceLog(LOG_INFO, "=== INIT WORLD RENDERER FOR: %s ===", dim->name.c_str());
     
-    // Carica fog shader
-    wr->fogShader = LoadShader("assets/shaders/glsl330/fog_vertex.vs", 
-                               "assets/shaders/glsl330/fog.fs");
+    // Variante dal registro: compilata solo la prima volta, non a ogni cambio di dimensione
+    wr->variant = GetTerrainVariant(dim);
+    wr->terrainShader = LoadTerrainShader(wr->variant);
+    wr->fogColorLoc = wr->viewPosLoc = -1;
     
-    if (wr->fogShader.id > 0) {
-        wr->fogDensityLoc = GetShaderLocation(wr->fogShader, "fogDensity");
-        wr->fogColorLoc = GetShaderLocation(wr->fogShader, "fogColor");
-        wr->viewPosLoc = GetShaderLocation(wr->fogShader, "viewPos");
-        
-        wr->fogShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(wr->fogShader, "mvp");
-        wr->fogShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocation(wr->fogShader, "matModel");
-        wr->fogShader.locs[SHADER_LOC_MATRIX_NORMAL] = GetShaderLocation(wr->fogShader, "matNormal");
-        wr->fogShader.locs[SHADER_LOC_VECTOR_VIEW] = wr->viewPosLoc;
+    if (wr->terrainShader.id > 0) {
+        if (wr->variant & TERRAIN_VARIANT_FOG) {
+            wr->fogColorLoc = GetCachedShaderLocation(wr->terrainShader, "fogColor");
+        }
+        if (wr->variant & (TERRAIN_VARIANT_FOG | TERRAIN_VARIANT_WATER)) {
+            wr->viewPosLoc = GetCachedShaderLocation(wr->terrainShader, "viewPos");
+        }
+        wr->terrainShader.locs[SHADER_LOC_VECTOR_VIEW] = wr->viewPosLoc;
+
+        // Luce della dimensione: il programma è condiviso, si reimposta a ogni init
+        Vector3 lightDir = dim->sunDirection;
+        if (Vector3Length(lightDir) < 0.001f) lightDir = (Vector3){-0.5f, -1.0f, -0.5f};
+        lightDir = Vector3Normalize(lightDir);
+        SetShaderValue(wr->terrainShader, GetCachedShaderLocation(wr->terrainShader, "lightDir"), &lightDir, SHADER_UNIFORM_VEC3);
+        // Sole al 70% come la vecchia luce fissa: ambiente + sole resta vicino a 1
+        SetColorUniform(wr->terrainShader, "lightColor", dim->sunColor, 0.7f);
+        SetColorUniform(wr->terrainShader, "ambientColor", dim->ambientLight, 1.0f);
         
-        TraceLog(LOG_INFO, "✓ Fog shader loaded into WorldRenderer (ID: %d)", wr->fogShader.id);
+        TraceLog(LOG_INFO, "✓ Terrain shader variant %s%s%s loaded into WorldRenderer (ID: %d)",
+                 (wr->variant & TERRAIN_VARIANT_FOG) ? "+fog" : "-fog",
+                 (wr->variant & TERRAIN_VARIANT_TEXTURED) ? "+textured" : "-textured",
+                 (wr->variant & TERRAIN_VARIANT_WATER) ? "+water" : "-water",
+                 wr->terrainShader.id);
     } else {
-        TraceLog(LOG_ERROR, "✗ Failed to load fog shader in WorldRenderer!");
+        TraceLog(LOG_ERROR, "✗ Failed to load terrain shader in WorldRenderer!");
     }
     
-    // Crea materiali CON fog shader
-    wr->grassMat = CreateTexturedMaterial(dim->grassTopTex, dim->grassTopColor, wr->fogShader);
-    wr->dirtSideMat = CreateTexturedMaterial(dim->dirtSideTex, dim->dirtSideColor, wr->fogShader);
-    wr->dirtMat = CreateTexturedMaterial(dim->dirtTex, dim->dirtColor, wr->fogShader);
+    // Riferimenti propri alle texture: i materiali non dipendono da quando la
+    // dimensione rilascia le sue
+    wr->textureRefs[0] = AssetCache::Get().Retain(dim->grassTopHandle);
+    wr->textureRefs[1] = AssetCache::Get().Retain(dim->dirtSideHandle);
+    wr->textureRefs[2] = AssetCache::Get().Retain(dim->dirtHandle);
+    wr->textureRefs[3] = AssetCache::Get().Retain(dim->waterHandle);
+
+    // Crea materiali CON lo shader del terreno
+    wr->grassMat = CreateTexturedMaterial(dim->grassTopTex, dim->grassTopColor, wr->terrainShader);
+    wr->dirtSideMat = CreateTexturedMaterial(dim->dirtSideTex, dim->dirtSideColor, wr->terrainShader);
+    wr->dirtMat = CreateTexturedMaterial(dim->dirtTex, dim->dirtColor, wr->terrainShader);
     
     if (dim->waterTex.id != 0) {
-        wr->waterMat = CreateTexturedMaterial(dim->waterTex, (Color){30, 100, 255, 180}, wr->fogShader);
+        wr->waterMat = CreateTexturedMaterial(dim->waterTex, (Color){30, 100, 255, 180}, wr->terrainShader);
     } else {
         Image img = GenImageColor(64, 64, (Color){30, 100, 255, 180});
         ImageDrawRectangleLines(&img, (Rectangle){0, 0, 64, 64}, 4, Fade(BLUE, 0.5f));
-        Texture2D tex = LoadTextureFromImage(img);
+        wr->generatedWaterTex = LoadTextureFromImage(img);
         UnloadImage(img);
-        wr->waterMat = CreateTexturedMaterial(tex, (Color){30, 100, 255, 180}, wr->fogShader);
+        wr->waterMat = CreateTexturedMaterial(wr->generatedWaterTex, (Color){30, 100, 255, 180}, wr->terrainShader);
     }
 
     wr->initialized = true;
@@ -73,26 +107,25 @@ void InitWorldRenderer(WorldRenderer* wr, DimensionConfig* dim) {
     TraceLog(LOG_INFO, "=== WORLD RENDERER INITIALIZED ===");
 }
 
-void DrawWorld(WorldRenderer* wr, World* world, Camera3D camera, float fogDensity, Color fogColor) {
+void DrawWorld(WorldRenderer* wr, World* world, Camera3D camera, Color fogColor) {
     if (!wr || !wr->initialized || !world) {
         TraceLog(LOG_WARNING, "DrawWorld: Invalid parameters!");
         return;
     }
 
-    // Update fog uniforms
-    if (wr->fogShader.id > 0) {
-        SetShaderValue(wr->fogShader, wr->fogDensityLoc, &fogDensity, SHADER_UNIFORM_FLOAT);
-        
+    // Colore della nebbia e posizione della camera solo se la variante li legge
+    if (wr->fogColorLoc >= 0) {
         float fogColorNorm[4] = {
             fogColor.r / 255.0f,
             fogColor.g / 255.0f,
             fogColor.b / 255.0f,
             1.0f
         };
-        SetShaderValue(wr->fogShader, wr->fogColorLoc, fogColorNorm, SHADER_UNIFORM_VEC4);
-        
+        SetShaderValue(wr->terrainShader, wr->fogColorLoc, fogColorNorm, SHADER_UNIFORM_VEC4);
+    }
+    if (wr->viewPosLoc >= 0) {
         float camPos[3] = {camera.position.x, camera.position.y, camera.position.z};
-        SetShaderValue(wr->fogShader, wr->viewPosLoc, camPos, SHADER_UNIFORM_VEC3);
+        SetShaderValue(wr->terrainShader, wr->viewPosLoc, camPos, SHADER_UNIFORM_VEC3);
     }
 
     for (int i = 0; i < world->chunkCount; i++) {
@@ -111,11 +144,16 @@ void UnloadWorldRenderer(WorldRenderer* wr) {
     TraceLog(LOG_INFO, "Unloading World Renderer...");
 
     // NON unloadare i materiali - sono automatici con lo shader
-    // Unload solo lo shader
-    if (wr->fogShader.id > 0) {
-        UnloadShader(wr->fogShader);
-        wr->fogShader.id = 0;
-        TraceLog(LOG_INFO, "✓ Fog shader unloaded");
+    // Lo shader resta al registro per la prossima dimensione
+    wr->terrainShader.id = 0;
+
+    for (int i = 0; i < 4; i++) {
+        AssetCache::Get().Release(wr->textureRefs[i]);
+        wr->textureRefs[i] = NULL_TEXTURE;
+    }
+    if (wr->generatedWaterTex.id != 0) {
+        UnloadTexture(wr->generatedWaterTex);
+        wr->generatedWaterTex.id = 0;
     }
 
     wr->initialized = false;
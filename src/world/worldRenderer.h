@@ -12,17 +12,25 @@ typedef struct WorldRenderer {
     Material dirtMat;
     Material waterMat;
     
-    Shader fogShader;
-    int fogDensityLoc;
+    // Variante dello shader del terreno scelta dalla dimensione
+    Shader terrainShader;
+    unsigned int variant;
     int fogColorLoc;
     int viewPosLoc;
+
+    // Riferimenti alle texture della dimensione usate dai materiali: restano
+    // caricate nell'AssetCache finché il renderer non viene scaricato
+    TextureHandle textureRefs[4];
+    Texture2D generatedWaterTex;   // generata se la dimensione non ha la texture dell'acqua
     
     bool initialized;
     bool materialsLoaded;
 } WorldRenderer;
 
+// Flag TERRAIN_VARIANT_* delle istruzioni che servono alla dimensione
+unsigned int GetTerrainVariant(const DimensionConfig* dim);
 void InitWorldRenderer(WorldRenderer* wr, DimensionConfig* dim);
-void DrawWorld(WorldRenderer* wr, World* world, Camera3D camera, float fogDensity, Color fogColor);
+void DrawWorld(WorldRenderer* wr, World* world, Camera3D camera, Color fogColor);
 void UnloadWorldRenderer(WorldRenderer* wr);
 
 #endif
\ No newline at end of file